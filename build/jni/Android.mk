@@ -29,10 +29,12 @@ LOCAL_SRC_FILES := ../../engine/assets/BmfLoader.cpp \
     ../../engine/assets/ObjLoader.cpp \
     ../../engine/assets/ParticleSystemLoader.cpp \
     ../../engine/assets/SpriteLoader.cpp \
+    ../../engine/assets/TextureLoader.cpp \
     ../../engine/assets/TtfLoader.cpp \
     ../../engine/assets/VorbisLoader.cpp \
     ../../engine/assets/WaveLoader.cpp \
     ../../engine/audio/empty/EmptyAudioDevice.cpp \
+    ../../engine/audio/offline/OfflineAudioDevice.cpp \
     ../../engine/audio/mixer/Bus.cpp \
 	../../engine/audio/mixer/Mixer.cpp \
     ../../engine/audio/opensl/OSLAudioDevice.cpp \
@@ -58,6 +60,8 @@ LOCAL_SRC_FILES := ../../engine/assets/BmfLoader.cpp \
     ../../engine/core/Engine.cpp \
 	../../engine/core/NativeWindow.cpp \
 	../../engine/core/System.cpp \
+	../../engine/core/JobSystem.cpp \
+	../../engine/core/Profiler.cpp \
     ../../engine/core/Window.cpp \
     ../../engine/events/EventDispatcher.cpp \
     ../../engine/graphics/opengl/android/OGLRenderDeviceAndroid.cpp \
@@ -97,6 +101,7 @@ LOCAL_SRC_FILES := ../../engine/assets/BmfLoader.cpp \
     ../../engine/localization/Localization.cpp \
     ../../engine/math/MathUtils.cpp \
     ../../engine/math/Matrix.cpp \
+    ../../engine/math/Batch.cpp \
     ../../engine/network/Client.cpp \
     ../../engine/network/Network.cpp \
 	../../engine/network/Server.cpp \
@@ -114,6 +119,7 @@ LOCAL_SRC_FILES := ../../engine/assets/BmfLoader.cpp \
     ../../engine/scene/SkinnedMeshRenderer.cpp \
     ../../engine/scene/SpriteRenderer.cpp \
     ../../engine/scene/StaticMeshRenderer.cpp \
+    ../../engine/scene/StaticMeshBatch.cpp \
     ../../engine/scene/TextRenderer.cpp \
     ../../engine/storage/FileSystem.cpp \
     ../../engine/utils/Log.cpp \
@@ -0,0 +1,245 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_ATLASPACKER_HPP
+#define OUZEL_ASSETS_ATLASPACKER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "math/Size.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // Packs rectangles into atlas pages with the MaxRects algorithm (best short side fit),
+        // a new page is started when a rectangle doesn't fit into any of the existing ones
+        class AtlasPacker final
+        {
+        public:
+            struct Region final
+            {
+                std::uint32_t page = 0;
+                std::uint32_t x = 0;
+                std::uint32_t y = 0;
+                std::uint32_t width = 0; // size of the rectangle in the page, the size is swapped if it is rotated
+                std::uint32_t height = 0;
+                bool rotated = false; // rotated by 90 degrees clockwise
+            };
+
+            struct PageStatistics final
+            {
+                std::uint32_t regionCount = 0;
+                std::uint64_t usedArea = 0; // without the padding
+
+                float getOccupancy(const Size2U& pageSize) const noexcept
+                {
+                    return static_cast<float>(usedArea) / (static_cast<float>(pageSize.v[0]) * static_cast<float>(pageSize.v[1]));
+                }
+            };
+
+            explicit AtlasPacker(const Size2U& initPageSize,
+                                 std::uint32_t initPadding = 2,
+                                 bool initAllowRotation = false):
+                pageSize(initPageSize),
+                padding(initPadding),
+                allowRotation(initAllowRotation)
+            {
+            }
+
+            inline auto& getPageSize() const noexcept { return pageSize; }
+            inline auto getPadding() const noexcept { return padding; }
+            inline auto getPageCount() const noexcept { return static_cast<std::uint32_t>(pages.size()); }
+            inline auto& getPageStatistics(std::uint32_t page) const { return pages[page].statistics; }
+
+            Region insert(const Size2U& size)
+            {
+                if (size.v[0] == 0 || size.v[1] == 0)
+                    throw std::runtime_error("Invalid rectangle size");
+
+                Region result;
+                Score bestScore;
+
+                for (std::uint32_t i = 0; i < pages.size(); ++i)
+                    findPosition(pages[i], i, size, result, bestScore);
+
+                if (!bestScore.found())
+                {
+                    pages.emplace_back(Size2U(pageSize.v[0] + padding, pageSize.v[1] + padding));
+                    findPosition(pages.back(), getPageCount() - 1, size, result, bestScore);
+
+                    if (!bestScore.found())
+                        throw std::runtime_error("Rectangle does not fit into an atlas page");
+                }
+
+                place(pages[result.page], result);
+
+                return result;
+            }
+
+            // packs the largest rectangles first, the regions are returned in the order of the sizes
+            std::vector<Region> insert(const std::vector<Size2U>& sizes)
+            {
+                std::vector<std::size_t> order(sizes.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&sizes](std::size_t a, std::size_t b) noexcept {
+                    const auto maxA = std::max(sizes[a].v[0], sizes[a].v[1]);
+                    const auto maxB = std::max(sizes[b].v[0], sizes[b].v[1]);
+                    return maxA != maxB ? maxA > maxB : sizes[a].v[0] * sizes[a].v[1] > sizes[b].v[0] * sizes[b].v[1];
+                });
+
+                std::vector<Region> result(sizes.size());
+                for (std::size_t i : order)
+                    result[i] = insert(sizes[i]);
+
+                return result;
+            }
+
+        private:
+            struct Rectangle final
+            {
+                std::uint32_t x;
+                std::uint32_t y;
+                std::uint32_t width;
+                std::uint32_t height;
+
+                bool contains(const Rectangle& other) const noexcept
+                {
+                    return other.x >= x && other.y >= y &&
+                        other.x + other.width <= x + width &&
+                        other.y + other.height <= y + height;
+                }
+            };
+
+            struct Page final
+            {
+                explicit Page(const Size2U& size):
+                    freeRectangles{{0, 0, size.v[0], size.v[1]}}
+                {
+                }
+
+                std::vector<Rectangle> freeRectangles;
+                PageStatistics statistics;
+            };
+
+            struct Score final
+            {
+                std::uint32_t shortSide = std::numeric_limits<std::uint32_t>::max();
+                std::uint32_t longSide = std::numeric_limits<std::uint32_t>::max();
+
+                bool found() const noexcept { return shortSide != std::numeric_limits<std::uint32_t>::max(); }
+
+                bool operator<(const Score& other) const noexcept
+                {
+                    return shortSide != other.shortSide ? shortSide < other.shortSide : longSide < other.longSide;
+                }
+            };
+
+            // the padding is added to the right and the bottom of every rectangle, the pages are
+            // larger by the padding, so that the rectangles at the edges can touch the border
+            void findPosition(const Page& page, std::uint32_t pageIndex, const Size2U& size,
+                              Region& result, Score& bestScore) const
+            {
+                const auto check = [&](const Rectangle& freeRectangle, std::uint32_t width, std::uint32_t height, bool rotated) {
+                    if (freeRectangle.width < width || freeRectangle.height < height) return;
+
+                    const auto leftoverX = freeRectangle.width - width;
+                    const auto leftoverY = freeRectangle.height - height;
+
+                    Score score;
+                    score.shortSide = std::min(leftoverX, leftoverY);
+                    score.longSide = std::max(leftoverX, leftoverY);
+
+                    if (score < bestScore)
+                    {
+                        bestScore = score;
+                        result.page = pageIndex;
+                        result.x = freeRectangle.x;
+                        result.y = freeRectangle.y;
+                        result.width = width - padding;
+                        result.height = height - padding;
+                        result.rotated = rotated;
+                    }
+                };
+
+                const auto width = size.v[0] + padding;
+                const auto height = size.v[1] + padding;
+
+                for (const Rectangle& freeRectangle : page.freeRectangles)
+                {
+                    check(freeRectangle, width, height, false);
+                    if (allowRotation && width != height)
+                        check(freeRectangle, height, width, true);
+                }
+            }
+
+            void place(Page& page, const Region& region) const
+            {
+                const Rectangle used{region.x, region.y, region.width + padding, region.height + padding};
+
+                std::vector<Rectangle> newRectangles;
+
+                for (auto i = page.freeRectangles.begin(); i != page.freeRectangles.end();)
+                {
+                    const Rectangle freeRectangle = *i;
+
+                    if (used.x >= freeRectangle.x + freeRectangle.width || used.x + used.width <= freeRectangle.x ||
+                        used.y >= freeRectangle.y + freeRectangle.height || used.y + used.height <= freeRectangle.y)
+                    {
+                        ++i;
+                        continue;
+                    }
+
+                    // split the intersected free rectangle into up to four maximal rectangles around the used one
+                    if (used.x > freeRectangle.x)
+                        newRectangles.push_back({freeRectangle.x, freeRectangle.y,
+                                                 used.x - freeRectangle.x, freeRectangle.height});
+
+                    if (used.x + used.width < freeRectangle.x + freeRectangle.width)
+                        newRectangles.push_back({used.x + used.width, freeRectangle.y,
+                                                 freeRectangle.x + freeRectangle.width - used.x - used.width, freeRectangle.height});
+
+                    if (used.y > freeRectangle.y)
+                        newRectangles.push_back({freeRectangle.x, freeRectangle.y,
+                                                 freeRectangle.width, used.y - freeRectangle.y});
+
+                    if (used.y + used.height < freeRectangle.y + freeRectangle.height)
+                        newRectangles.push_back({freeRectangle.x, used.y + used.height,
+                                                 freeRectangle.width, freeRectangle.y + freeRectangle.height - used.y - used.height});
+
+                    i = page.freeRectangles.erase(i);
+                }
+
+                page.freeRectangles.insert(page.freeRectangles.end(), newRectangles.begin(), newRectangles.end());
+
+                // remove the free rectangles that are contained in other ones
+                for (std::size_t i = 0; i < page.freeRectangles.size(); ++i)
+                    for (std::size_t j = i + 1; j < page.freeRectangles.size();)
+                    {
+                        if (page.freeRectangles[i].contains(page.freeRectangles[j]))
+                            page.freeRectangles.erase(page.freeRectangles.begin() + static_cast<std::ptrdiff_t>(j));
+                        else if (page.freeRectangles[j].contains(page.freeRectangles[i]))
+                        {
+                            page.freeRectangles.erase(page.freeRectangles.begin() + static_cast<std::ptrdiff_t>(i));
+                            j = i + 1;
+                        }
+                        else
+                            ++j;
+                    }
+
+                ++page.statistics.regionCount;
+                page.statistics.usedArea += static_cast<std::uint64_t>(region.width) * region.height;
+            }
+
+            Size2U pageSize;
+            std::uint32_t padding = 0;
+            bool allowRotation = false;
+            std::vector<Page> pages;
+        };
+    } // namespace assets
+} // namespace ouzel
+
+#endif // OUZEL_ASSETS_ATLASPACKER_HPP
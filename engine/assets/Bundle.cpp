@@ -4,7 +4,9 @@
 #include <stdexcept>
 #include "Bundle.hpp"
 #include "Cache.hpp"
+#include "ImageLoader.hpp"
 #include "Loader.hpp"
+#include "core/Engine.hpp"
 #include "utils/Json.hpp"
 
 namespace ouzel
@@ -25,10 +27,18 @@ namespace ouzel
         void Bundle::loadAsset(std::uint32_t loaderType, const std::string& name,
                                const std::string& filename, bool mipmaps)
         {
-            const std::vector<std::uint8_t> data = fileSystem.readFile(filename);
-
             const auto& loaders = cache.getLoaders();
 
+            for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+            {
+                Loader* loader = i->get();
+                if (loader->getType() == loaderType &&
+                    loader->loadFile(*this, name, filename, mipmaps))
+                    return;
+            }
+
+            const std::vector<std::uint8_t> data = fileSystem.readFile(filename);
+
             for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
             {
                 Loader* loader = i->get();
@@ -190,6 +200,90 @@ namespace ouzel
                 loadAsset(Loader::Sprite, filename, filename, mipmaps);
         }
 
+        std::vector<AtlasPacker::PageStatistics> Bundle::preloadSpriteAtlas(const std::string& name,
+                                                                            const std::vector<std::string>& filenames,
+                                                                            bool mipmaps,
+                                                                            const Vector2F& pivot,
+                                                                            const Size2U& pageSize,
+                                                                            std::uint32_t padding)
+        {
+            std::vector<graphics::Image> images;
+            std::vector<Size2U> sizes;
+            images.reserve(filenames.size());
+            sizes.reserve(filenames.size());
+
+            for (const std::string& filename : filenames)
+            {
+                images.push_back(ImageLoader::loadImage(fileSystem.readFile(filename)));
+                sizes.push_back(images.back().getSize());
+            }
+
+            AtlasPacker packer(pageSize, padding, true);
+            const std::vector<AtlasPacker::Region> regions = packer.insert(sizes);
+
+            constexpr std::size_t pixelSize = 4;
+            std::vector<std::vector<std::uint8_t>> pages(packer.getPageCount(),
+                                                         std::vector<std::uint8_t>(pageSize.v[0] * pageSize.v[1] * pixelSize));
+
+            for (std::size_t i = 0; i < images.size(); ++i)
+            {
+                const AtlasPacker::Region& region = regions[i];
+                const Size2U& size = images[i].getSize();
+                const std::uint8_t* source = images[i].getData().data();
+                std::uint8_t* page = pages[region.page].data();
+
+                for (std::uint32_t y = 0; y < size.v[1]; ++y)
+                    if (!region.rotated)
+                        std::copy(source + y * size.v[0] * pixelSize,
+                                  source + (y + 1) * size.v[0] * pixelSize,
+                                  page + ((region.y + y) * pageSize.v[0] + region.x) * pixelSize);
+                    else // the rows become columns from right to left
+                        for (std::uint32_t x = 0; x < size.v[0]; ++x)
+                            std::copy(source + (y * size.v[0] + x) * pixelSize,
+                                      source + (y * size.v[0] + x + 1) * pixelSize,
+                                      page + ((region.y + x) * pageSize.v[0] + region.x + size.v[1] - 1 - y) * pixelSize);
+            }
+
+            std::vector<std::shared_ptr<graphics::Texture>> pageTextures;
+            std::vector<AtlasPacker::PageStatistics> statistics;
+
+            for (std::uint32_t page = 0; page < packer.getPageCount(); ++page)
+            {
+                pageTextures.push_back(std::make_shared<graphics::Texture>(*engine->getRenderer(),
+                                                                       pages[page],
+                                                                       pageSize, 0,
+                                                                       mipmaps ? 0 : 1,
+                                                                       graphics::PixelFormat::RGBA8UNorm));
+                setTexture(name + '/' + std::to_string(page), pageTextures.back());
+                statistics.push_back(packer.getPageStatistics(page));
+            }
+
+            const Size2F textureSize(static_cast<float>(pageSize.v[0]),
+                                     static_cast<float>(pageSize.v[1]));
+
+            for (std::size_t i = 0; i < filenames.size(); ++i)
+            {
+                const AtlasPacker::Region& region = regions[i];
+                const Size2U& size = images[i].getSize();
+                const Size2F spriteSize(static_cast<float>(size.v[0]), static_cast<float>(size.v[1]));
+
+                scene::SpriteData newSpriteData;
+                newSpriteData.texture = pageTextures[region.page];
+
+                scene::SpriteData::Animation animation;
+                animation.frames.emplace_back(filenames[i], textureSize,
+                                              RectF(static_cast<float>(region.x), static_cast<float>(region.y),
+                                                    spriteSize.v[0], spriteSize.v[1]),
+                                              region.rotated, spriteSize, Vector2F(), pivot);
+
+                newSpriteData.animations[""] = std::move(animation);
+
+                spriteData[filenames[i]] = std::move(newSpriteData);
+            }
+
+            return statistics;
+        }
+
         const scene::SpriteData* Bundle::getSpriteData(const std::string& name) const
         {
             auto i = spriteData.find(name);
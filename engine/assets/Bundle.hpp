@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include "assets/AtlasPacker.hpp"
 #include "audio/Cue.hpp"
 #include "audio/Sound.hpp"
 #include "graphics/BlendState.hpp"
@@ -64,6 +65,8 @@ namespace ouzel
             void loadAssets(const std::string& filename);
             void loadAssets(const std::vector<Asset>& assets);
 
+            inline auto& getFileSystem() const noexcept { return fileSystem; }
+
             std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
             void setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture);
             void releaseTextures();
@@ -83,6 +86,14 @@ namespace ouzel
             void preloadSpriteData(const std::string& filename, bool mipmaps = true,
                                    std::uint32_t spritesX = 1, std::uint32_t spritesY = 1,
                                    const Vector2F& pivot = Vector2F{0.5F, 0.5F});
+            // packs the images into shared atlas pages (textures named "<name>/<page>"), so that the sprites
+            // can be drawn without switching textures, every image gets sprite data named after its file
+            std::vector<AtlasPacker::PageStatistics> preloadSpriteAtlas(const std::string& name,
+                                                                        const std::vector<std::string>& filenames,
+                                                                        bool mipmaps = true,
+                                                                        const Vector2F& pivot = Vector2F{0.5F, 0.5F},
+                                                                        const Size2U& pageSize = Size2U{2048, 2048},
+                                                                        std::uint32_t padding = 2);
             const scene::SpriteData* getSpriteData(const std::string& name) const;
             void setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData);
             void releaseSpriteData();
@@ -11,6 +11,7 @@
 #include "ObjLoader.hpp"
 #include "ParticleSystemLoader.hpp"
 #include "SpriteLoader.hpp"
+#include "TextureLoader.hpp"
 #include "TtfLoader.hpp"
 #include "VorbisLoader.hpp"
 #include "WaveLoader.hpp"
@@ -33,6 +34,7 @@ namespace ouzel
             addLoader(std::make_unique<ObjLoader>(*this));
             addLoader(std::make_unique<ParticleSystemLoader>(*this));
             addLoader(std::make_unique<SpriteLoader>(*this));
+            addLoader(std::make_unique<TextureLoader>(*this));
             addLoader(std::make_unique<TtfLoader>(*this));
             addLoader(std::make_unique<VorbisLoader>(*this));
             addLoader(std::make_unique<WaveLoader>(*this));
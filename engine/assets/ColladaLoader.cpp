@@ -20,14 +20,14 @@ namespace ouzel
                                       const std::vector<std::uint8_t>& data,
                                       bool)
         {
-            xml::Data colladaData(data);
+            xml::Reader reader(data);
 
-            if (colladaData.getChildren().empty())
-                throw std::runtime_error("Invalid Collada file");
-
-            xml::Node rootNode = colladaData.getChildren().front();
+            xml::Reader::Event event;
+            while ((event = reader.next()) != xml::Reader::Event::StartTag)
+                if (event == xml::Reader::Event::End)
+                    throw std::runtime_error("Invalid Collada file");
 
-            if (rootNode.getValue() != "COLLADA")
+            if (reader.getName() != "COLLADA")
                 throw std::runtime_error("Invalid Collada file");
 
             scene::SkinnedMeshData meshData;
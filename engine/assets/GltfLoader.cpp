@@ -1,14 +1,270 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include "GltfLoader.hpp"
 #include "Bundle.hpp"
+#include "Cache.hpp"
+#include "core/Engine.hpp"
+#include "graphics/Material.hpp"
 #include "scene/SkinnedMeshRenderer.hpp"
+#include "storage/MappedFile.hpp"
+#include "storage/Path.hpp"
 #include "utils/Json.hpp"
+#include "utils/Utils.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
+        namespace
+        {
+            constexpr std::uint8_t GLB_MAGIC[4] = {'g', 'l', 'T', 'F'};
+            constexpr std::uint32_t GLB_VERSION = 2;
+            constexpr std::size_t GLB_HEADER_SIZE = 12;
+            constexpr std::size_t CHUNK_HEADER_SIZE = 8;
+            constexpr std::uint32_t CHUNK_JSON = 0x4E4F534A;
+            constexpr std::uint32_t CHUNK_BIN = 0x004E4942;
+
+            constexpr std::uint32_t COMPONENT_BYTE = 5120;
+            constexpr std::uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+            constexpr std::uint32_t COMPONENT_SHORT = 5122;
+            constexpr std::uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+            constexpr std::uint32_t COMPONENT_UNSIGNED_INT = 5125;
+            constexpr std::uint32_t COMPONENT_FLOAT = 5126;
+
+            constexpr std::uint32_t MODE_TRIANGLES = 4;
+
+            constexpr std::size_t NO_NODE = std::numeric_limits<std::size_t>::max();
+
+            // lets the JSON parser read the data in place
+            class ByteRange final
+            {
+            public:
+                ByteRange(const std::uint8_t* initBegin, const std::uint8_t* initEnd) noexcept:
+                    first(initBegin), last(initEnd)
+                {
+                }
+
+                inline auto begin() const noexcept { return first; }
+                inline auto end() const noexcept { return last; }
+
+            private:
+                const std::uint8_t* first;
+                const std::uint8_t* last;
+            };
+
+            struct BufferData final
+            {
+                const std::uint8_t* data = nullptr;
+                std::size_t size = 0;
+            };
+
+            struct Node final
+            {
+                std::size_t parent = NO_NODE;
+                std::vector<std::size_t> children;
+                scene::SkinnedMeshData::Bone transform; // local transform of the node
+                Matrix4F worldTransform = Matrix4F::identity();
+                std::size_t order = NO_NODE; // position in the depth-first traversal of the scene
+            };
+
+            std::size_t getComponentSize(std::uint32_t componentType)
+            {
+                switch (componentType)
+                {
+                    case COMPONENT_BYTE:
+                    case COMPONENT_UNSIGNED_BYTE: return 1;
+                    case COMPONENT_SHORT:
+                    case COMPONENT_UNSIGNED_SHORT: return 2;
+                    case COMPONENT_UNSIGNED_INT:
+                    case COMPONENT_FLOAT: return 4;
+                    default: throw std::runtime_error("Invalid component type");
+                }
+            }
+
+            std::size_t getTypeComponentCount(const std::string& type)
+            {
+                if (type == "SCALAR") return 1;
+                else if (type == "VEC2") return 2;
+                else if (type == "VEC3") return 3;
+                else if (type == "VEC4") return 4;
+                else if (type == "MAT2") return 4;
+                else if (type == "MAT3") return 9;
+                else if (type == "MAT4") return 16;
+                else throw std::runtime_error("Invalid accessor type");
+            }
+
+            // reads the elements of an accessor from the buffer they are stored in
+            class Accessor final
+            {
+            public:
+                Accessor() = default;
+
+                Accessor(const json::Value& document,
+                         const std::vector<BufferData>& buffers,
+                         std::size_t index)
+                {
+                    const json::Value& accessor = document["accessors"][index];
+
+                    if (accessor.hasMember("sparse"))
+                        throw std::runtime_error("Sparse accessors are not supported");
+
+                    componentType = accessor["componentType"].as<std::uint32_t>();
+                    componentSize = getComponentSize(componentType);
+                    componentCount = getTypeComponentCount(accessor["type"].as<std::string>());
+                    count = accessor["count"].as<std::size_t>();
+                    normalized = accessor.hasMember("normalized") && accessor["normalized"].as<bool>();
+
+                    // an accessor without a buffer view is initialized with zeros
+                    if (!accessor.hasMember("bufferView")) return;
+
+                    const json::Value& bufferView = document["bufferViews"][accessor["bufferView"].as<std::size_t>()];
+                    const auto bufferIndex = bufferView["buffer"].as<std::size_t>();
+                    if (bufferIndex >= buffers.size())
+                        throw std::runtime_error("Invalid buffer index");
+
+                    const BufferData& buffer = buffers[bufferIndex];
+                    const auto viewOffset = bufferView.hasMember("byteOffset") ? bufferView["byteOffset"].as<std::size_t>() : 0;
+                    const auto viewLength = bufferView["byteLength"].as<std::size_t>();
+                    const auto offset = accessor.hasMember("byteOffset") ? accessor["byteOffset"].as<std::size_t>() : 0;
+                    const auto elementSize = componentSize * componentCount;
+
+                    stride = bufferView.hasMember("byteStride") ? bufferView["byteStride"].as<std::size_t>() : elementSize;
+
+                    if (stride < elementSize)
+                        throw std::runtime_error("Invalid buffer view stride");
+
+                    if (viewOffset > buffer.size || viewLength > buffer.size - viewOffset)
+                        throw std::runtime_error("Buffer view out of range");
+
+                    // divided instead of multiplying the count by the stride, which could overflow
+                    if (count > 0 && (offset > viewLength ||
+                                      elementSize > viewLength - offset ||
+                                      count - 1 > (viewLength - offset - elementSize) / stride))
+                        throw std::runtime_error("Accessor out of range");
+
+                    data = buffer.data + viewOffset + offset;
+                }
+
+                inline auto getCount() const noexcept { return count; }
+                inline auto getComponentCount() const noexcept { return componentCount; }
+
+                float getFloat(std::size_t element, std::size_t component) const
+                {
+                    if (!data) return 0.0F;
+
+                    const std::uint8_t* value = data + element * stride + component * componentSize;
+
+                    switch (componentType)
+                    {
+                        case COMPONENT_BYTE:
+                        {
+                            const auto result = static_cast<std::int8_t>(*value);
+                            return normalized ? std::max(result / 127.0F, -1.0F) : static_cast<float>(result);
+                        }
+                        case COMPONENT_UNSIGNED_BYTE:
+                            return normalized ? *value / 255.0F : static_cast<float>(*value);
+                        case COMPONENT_SHORT:
+                        {
+                            const auto result = static_cast<std::int16_t>(decodeLittleEndian<std::uint16_t>(value));
+                            return normalized ? std::max(result / 32767.0F, -1.0F) : static_cast<float>(result);
+                        }
+                        case COMPONENT_UNSIGNED_SHORT:
+                        {
+                            const auto result = decodeLittleEndian<std::uint16_t>(value);
+                            return normalized ? result / 65535.0F : static_cast<float>(result);
+                        }
+                        case COMPONENT_UNSIGNED_INT:
+                            return static_cast<float>(decodeLittleEndian<std::uint32_t>(value));
+                        case COMPONENT_FLOAT:
+                        {
+                            float result;
+                            std::memcpy(&result, value, sizeof(result));
+                            return result;
+                        }
+                        default:
+                            return 0.0F;
+                    }
+                }
+
+                std::uint32_t getUInt(std::size_t element, std::size_t component) const
+                {
+                    if (!data) return 0;
+
+                    const std::uint8_t* value = data + element * stride + component * componentSize;
+
+                    switch (componentType)
+                    {
+                        case COMPONENT_UNSIGNED_BYTE: return *value;
+                        case COMPONENT_UNSIGNED_SHORT: return decodeLittleEndian<std::uint16_t>(value);
+                        case COMPONENT_UNSIGNED_INT: return decodeLittleEndian<std::uint32_t>(value);
+                        default: throw std::runtime_error("Invalid component type");
+                    }
+                }
+
+            private:
+                const std::uint8_t* data = nullptr;
+                std::size_t count = 0;
+                std::size_t stride = 0;
+                std::size_t componentCount = 0;
+                std::size_t componentSize = 0;
+                std::uint32_t componentType = 0;
+                bool normalized = false;
+            };
+
+            std::vector<std::uint8_t> decodeBase64(const std::string& str, std::size_t position)
+            {
+                std::vector<std::uint8_t> result;
+                result.reserve((str.size() - position) / 4 * 3);
+
+                std::uint32_t value = 0;
+                std::uint32_t bits = 0;
+
+                for (auto i = str.begin() + static_cast<std::ptrdiff_t>(position); i != str.end(); ++i)
+                {
+                    const char c = *i;
+                    std::uint32_t sextet;
+
+                    if (c >= 'A' && c <= 'Z') sextet = static_cast<std::uint32_t>(c - 'A');
+                    else if (c >= 'a' && c <= 'z') sextet = static_cast<std::uint32_t>(c - 'a') + 26;
+                    else if (c >= '0' && c <= '9') sextet = static_cast<std::uint32_t>(c - '0') + 52;
+                    else if (c == '+') sextet = 62;
+                    else if (c == '/') sextet = 63;
+                    else if (c == '=') break;
+                    else throw std::runtime_error("Invalid base64 data");
+
+                    value = (value << 6) | sextet;
+                    bits += 6;
+
+                    if (bits >= 8)
+                    {
+                        bits -= 8;
+                        result.push_back(static_cast<std::uint8_t>(value >> bits));
+                    }
+                }
+
+                return result;
+            }
+
+            // returns the position of the data in an URI like "data:application/octet-stream;base64,..."
+            std::size_t getDataUriPosition(const std::string& uri)
+            {
+                if (uri.compare(0, 5, "data:") != 0) return 0;
+
+                const auto separator = uri.find(',');
+                if (separator == std::string::npos || uri.rfind(";base64", separator) == std::string::npos)
+                    throw std::runtime_error("Only base64 data URIs are supported");
+
+                return separator + 1;
+            }
+        }
+
         GltfLoader::GltfLoader(Cache& initCache):
             Loader(initCache, Loader::SkinnedMesh)
         {
@@ -19,17 +275,726 @@ namespace ouzel
                                    const std::vector<std::uint8_t>& data,
                                    bool mipmaps)
         {
-            const json::Data d(data);
+            // the data has no file, the external buffers and images are looked up next to the asset name,
+            // loadFile handles the glTF files and resolves them against the directory of the file
+            return loadModel(bundle, name, storage::Path(name).getDirectory(),
+                             data.data(), data.size(), mipmaps);
+        }
+
+        bool GltfLoader::loadFile(Bundle& bundle,
+                                  const std::string& name,
+                                  const std::string& filename,
+                                  bool mipmaps)
+        {
+            const auto extension = storage::Path(filename).getExtension();
+            if (extension != "glb" && extension != "gltf")
+                return false;
+
+            const std::string directory = storage::Path(filename).getDirectory();
+            const storage::MappedFile file = bundle.getFileSystem().mapFile(filename);
+
+            bool loaded;
+            if (file.getData())
+                loaded = loadModel(bundle, name, directory, file.getData(), file.getSize(), mipmaps);
+            else
+            {
+                // the files in archives can't be mapped
+                const std::vector<std::uint8_t> data = bundle.getFileSystem().readFile(filename);
+                loaded = loadModel(bundle, name, directory, data.data(), data.size(), mipmaps);
+            }
+
+            if (!loaded)
+                throw std::runtime_error("Invalid glTF file " + filename);
+
+            return true;
+        }
+
+        bool GltfLoader::loadModel(Bundle& bundle,
+                                   const std::string& name,
+                                   const std::string& directory,
+                                   const std::uint8_t* data,
+                                   std::size_t size,
+                                   bool mipmaps)
+        {
+            json::Data document;
+            BufferData binaryChunk;
+
+            if (size >= GLB_HEADER_SIZE && std::memcmp(data, GLB_MAGIC, sizeof(GLB_MAGIC)) == 0)
+            {
+                if (decodeLittleEndian<std::uint32_t>(data + 4) != GLB_VERSION)
+                    throw std::runtime_error("Unsupported glTF binary version");
+
+                const auto length = decodeLittleEndian<std::uint32_t>(data + 8);
+                if (length < GLB_HEADER_SIZE || length > size)
+                    throw std::runtime_error("Invalid glTF binary length");
+
+                std::size_t offset = GLB_HEADER_SIZE;
+                bool hasJson = false;
+
+                while (length - offset >= CHUNK_HEADER_SIZE)
+                {
+                    const auto chunkLength = decodeLittleEndian<std::uint32_t>(data + offset);
+                    const auto chunkType = decodeLittleEndian<std::uint32_t>(data + offset + 4);
+                    offset += CHUNK_HEADER_SIZE;
+
+                    if (chunkLength > length - offset)
+                        throw std::runtime_error("Invalid glTF binary chunk");
+
+                    // the first chunk must be JSON, the second one is the binary buffer, unknown chunks are ignored
+                    if (!hasJson)
+                    {
+                        if (chunkType != CHUNK_JSON)
+                            throw std::runtime_error("glTF binary does not start with a JSON chunk");
+
+                        document = json::Data(ByteRange(data + offset, data + offset + chunkLength));
+                        hasJson = true;
+                    }
+                    else if (chunkType == CHUNK_BIN && !binaryChunk.data)
+                    {
+                        binaryChunk.data = data + offset;
+                        binaryChunk.size = chunkLength;
+                    }
+
+                    offset += chunkLength;
+                }
+
+                if (!hasJson)
+                    throw std::runtime_error("glTF binary has no JSON chunk");
+            }
+            else
+            {
+                // other JSON files and Collada models are loaded by other loaders
+                const std::uint8_t* first = data;
+                while (first != data + size && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n'))
+                    ++first;
+
+                if (first == data + size || *first != '{')
+                    return false;
+
+                document = json::Data(ByteRange(data, data + size));
+            }
+
+            if (document.getType() != json::Value::Type::Object || !document.hasMember("asset"))
+                return false;
+
+            // the const accessors throw on missing members and indices instead of growing the document
+            const json::Value& root = document;
+
+            const auto version = root["asset"]["version"].as<std::string>();
+            if (version.empty() || version[0] != '2')
+                throw std::runtime_error("Unsupported glTF version " + version);
+
+            // buffers are used in place, only the external buffers in archives and data URIs are copied
+            std::vector<storage::MappedFile> mappedFiles;
+            std::vector<std::vector<std::uint8_t>> bufferStorage;
+            std::vector<BufferData> buffers;
+
+            if (root.hasMember("buffers"))
+                for (const json::Value& buffer : root["buffers"])
+                {
+                    const auto byteLength = buffer["byteLength"].as<std::size_t>();
+                    BufferData bufferData;
+
+                    if (!buffer.hasMember("uri"))
+                    {
+                        if (!buffers.empty() || !binaryChunk.data)
+                            throw std::runtime_error("Buffer has no data");
+
+                        bufferData = binaryChunk;
+                    }
+                    else
+                    {
+                        const auto& uri = buffer["uri"].as<std::string>();
+
+                        if (const auto position = getDataUriPosition(uri))
+                        {
+                            bufferStorage.push_back(decodeBase64(uri, position));
+                            bufferData.data = bufferStorage.back().data();
+                            bufferData.size = bufferStorage.back().size();
+                        }
+                        else
+                        {
+                            const auto path = storage::Path(directory) / uri;
+                            storage::MappedFile file = bundle.getFileSystem().mapFile(path);
+
+                            if (file.getData())
+                            {
+                                bufferData.data = file.getData();
+                                bufferData.size = file.getSize();
+                                mappedFiles.push_back(std::move(file));
+                            }
+                            else
+                            {
+                                bufferStorage.push_back(bundle.getFileSystem().readFile(path));
+                                bufferData.data = bufferStorage.back().data();
+                                bufferData.size = bufferStorage.back().size();
+                            }
+                        }
+                    }
+
+                    if (bufferData.size < byteLength)
+                        throw std::runtime_error("Buffer is too small");
+
+                    buffers.push_back(bufferData);
+                }
+
+            // node hierarchy
+            std::vector<Node> nodes;
+
+            if (root.hasMember("nodes"))
+            {
+                const json::Value& nodesValue = root["nodes"];
+                nodes.resize(nodesValue.getSize());
+
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                {
+                    const json::Value& nodeValue = nodesValue[i];
+                    Node& node = nodes[i];
+
+                    if (nodeValue.hasMember("matrix"))
+                    {
+                        Matrix4F matrix;
+                        for (std::size_t c = 0; c < 16; ++c)
+                            matrix.m[c] = nodeValue["matrix"][c].as<float>();
+
+                        node.transform.position = matrix.getTranslation();
+                        node.transform.scale = matrix.getScale();
+                        node.transform.rotation = matrix.getRotation();
+                    }
+                    else
+                    {
+                        if (nodeValue.hasMember("translation"))
+                            for (std::size_t c = 0; c < 3; ++c)
+                                node.transform.position.v[c] = nodeValue["translation"][c].as<float>();
+
+                        if (nodeValue.hasMember("rotation"))
+                            for (std::size_t c = 0; c < 4; ++c)
+                                node.transform.rotation.v[c] = nodeValue["rotation"][c].as<float>();
+
+                        if (nodeValue.hasMember("scale"))
+                            for (std::size_t c = 0; c < 3; ++c)
+                                node.transform.scale.v[c] = nodeValue["scale"][c].as<float>();
+                    }
+
+                    if (nodeValue.hasMember("children"))
+                        for (const json::Value& child : nodeValue["children"])
+                        {
+                            const auto childIndex = child.as<std::size_t>();
+                            if (childIndex >= nodes.size() || childIndex == i || nodes[childIndex].parent != NO_NODE)
+                                throw std::runtime_error("Invalid node hierarchy");
+
+                            nodes[childIndex].parent = i;
+                            node.children.push_back(childIndex);
+                        }
+                }
+            }
+
+            std::vector<std::size_t> rootNodes;
+
+            if (root.hasMember("scenes"))
+            {
+                const auto sceneIndex = root.hasMember("scene") ? root["scene"].as<std::size_t>() : 0;
+                const json::Value& sceneValue = root["scenes"][sceneIndex];
+
+                if (sceneValue.hasMember("nodes"))
+                    for (const json::Value& nodeIndex : sceneValue["nodes"])
+                    {
+                        const auto rootIndex = nodeIndex.as<std::size_t>();
+                        if (rootIndex >= nodes.size() || nodes[rootIndex].parent != NO_NODE)
+                            throw std::runtime_error("Invalid scene node");
+
+                        rootNodes.push_back(rootIndex);
+                    }
+            }
+            else
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                    if (nodes[i].parent == NO_NODE) rootNodes.push_back(i);
+
+            // parents are always visited before their children
+            std::vector<std::size_t> sceneNodes;
+            std::vector<std::size_t> stack(rootNodes.rbegin(), rootNodes.rend());
+
+            while (!stack.empty())
+            {
+                const auto nodeIndex = stack.back();
+                stack.pop_back();
+
+                Node& node = nodes[nodeIndex];
+                if (node.order != NO_NODE)
+                    throw std::runtime_error("Invalid node hierarchy");
+
+                node.order = sceneNodes.size();
+                node.worldTransform = (node.parent == NO_NODE) ?
+                    node.transform.getLocalTransform() :
+                    nodes[node.parent].worldTransform * node.transform.getLocalTransform();
+
+                sceneNodes.push_back(nodeIndex);
+                stack.insert(stack.end(), node.children.rbegin(), node.children.rend());
+            }
+
+            // skin, all the skinned meshes of the model must share it
+            std::size_t skinIndex = NO_NODE;
+
+            for (const auto nodeIndex : sceneNodes)
+            {
+                const json::Value& nodeValue = root["nodes"][nodeIndex];
+                if (!nodeValue.hasMember("mesh") || !nodeValue.hasMember("skin")) continue;
+
+                const auto nodeSkin = nodeValue["skin"].as<std::size_t>();
+                if (skinIndex == NO_NODE)
+                    skinIndex = nodeSkin;
+                else if (skinIndex != nodeSkin)
+                    throw std::runtime_error("Only one skin per model is supported");
+            }
+
+            std::vector<scene::SkinnedMeshData::Bone> bones;
+            std::vector<std::uint32_t> nodeBones(nodes.size(), scene::SkinnedMeshData::NO_PARENT);
+            std::vector<std::uint32_t> jointBones;
+
+            if (skinIndex != NO_NODE)
+            {
+                const json::Value& skin = root["skins"][skinIndex];
+
+                std::vector<std::size_t> jointNodes;
+                for (const json::Value& joint : skin["joints"])
+                {
+                    const auto jointNode = joint.as<std::size_t>();
+                    if (jointNode >= nodes.size() || nodes[jointNode].order == NO_NODE)
+                        throw std::runtime_error("Invalid joint");
+
+                    jointNodes.push_back(jointNode);
+                }
+
+                if (jointNodes.size() > std::numeric_limits<std::uint16_t>::max())
+                    throw std::runtime_error("Too many joints");
+
+                Accessor inverseBindMatrices;
+                if (skin.hasMember("inverseBindMatrices"))
+                {
+                    inverseBindMatrices = Accessor(root, buffers, skin["inverseBindMatrices"].as<std::size_t>());
+                    if (inverseBindMatrices.getComponentCount() != 16 ||
+                        inverseBindMatrices.getCount() < jointNodes.size())
+                        throw std::runtime_error("Invalid inverse bind matrices");
+                }
+
+                // bones are sorted so that the parents come before their children
+                std::vector<std::size_t> jointOrder(jointNodes.size());
+                for (std::size_t i = 0; i < jointOrder.size(); ++i) jointOrder[i] = i;
+                std::sort(jointOrder.begin(), jointOrder.end(), [&nodes, &jointNodes](std::size_t a, std::size_t b) noexcept {
+                    return nodes[jointNodes[a]].order < nodes[jointNodes[b]].order;
+                });
+
+                jointBones.resize(jointNodes.size());
+                bones.reserve(jointNodes.size());
+
+                for (const auto joint : jointOrder)
+                {
+                    const auto jointNode = jointNodes[joint];
+                    const Node& node = nodes[jointNode];
+
+                    if (nodeBones[jointNode] != scene::SkinnedMeshData::NO_PARENT)
+                        throw std::runtime_error("Duplicate joint");
+
+                    scene::SkinnedMeshData::Bone bone = node.transform;
+
+                    // the closest ancestor that is a bone, the nodes in between are baked into the base transform
+                    std::size_t ancestor = node.parent;
+                    while (ancestor != NO_NODE && nodeBones[ancestor] == scene::SkinnedMeshData::NO_PARENT)
+                        ancestor = nodes[ancestor].parent;
+
+                    if (ancestor != NO_NODE)
+                    {
+                        bone.parent = nodeBones[ancestor];
+
+                        if (ancestor != node.parent)
+                        {
+                            Matrix4F inverseAncestorTransform = nodes[ancestor].worldTransform;
+                            inverseAncestorTransform.invert();
+                            bone.baseTransform = inverseAncestorTransform * nodes[node.parent].worldTransform;
+                        }
+                    }
+                    else if (node.parent != NO_NODE)
+                        bone.baseTransform = nodes[node.parent].worldTransform;
+
+                    if (skin.hasMember("inverseBindMatrices"))
+                        for (std::size_t c = 0; c < 16; ++c)
+                            bone.inverseBindMatrix.m[c] = inverseBindMatrices.getFloat(joint, c);
+
+                    const auto boneIndex = static_cast<std::uint32_t>(bones.size());
+                    nodeBones[jointNode] = boneIndex;
+                    jointBones[joint] = boneIndex;
+                    bones.push_back(bone);
+                }
+            }
+
+            // materials are created when they are first used
+            std::vector<const graphics::Material*> materials;
+            if (root.hasMember("materials"))
+                materials.resize(root["materials"].getSize(), nullptr);
+            const graphics::Material* defaultMaterial = nullptr;
+
+            auto getTexture = [&](std::size_t textureIndex) {
+                const json::Value& texture = root["textures"][textureIndex];
+                if (!texture.hasMember("source")) return cache.getTexture(TEXTURE_WHITE_PIXEL);
+
+                const auto imageIndex = texture["source"].as<std::size_t>();
+                const json::Value& image = root["images"][imageIndex];
+
+                std::string imageName;
+                std::vector<std::uint8_t> imageData;
+
+                if (image.hasMember("uri"))
+                {
+                    const auto& uri = image["uri"].as<std::string>();
+
+                    if (const auto position = getDataUriPosition(uri))
+                    {
+                        imageName = name + "#image" + std::to_string(imageIndex);
+                        if (auto result = cache.getTexture(imageName)) return result;
+
+                        imageData = decodeBase64(uri, position);
+                    }
+                    else
+                    {
+                        imageName = storage::Path(directory) / uri;
+                        if (auto result = cache.getTexture(imageName)) return result;
+
+                        bundle.loadAsset(Loader::Image, imageName, imageName, mipmaps);
+                        return cache.getTexture(imageName);
+                    }
+                }
+                else
+                {
+                    imageName = name + "#image" + std::to_string(imageIndex);
+                    if (auto result = cache.getTexture(imageName)) return result;
+
+                    // images embedded in a buffer view, the image decoders need them in a separate vector
+                    const json::Value& bufferView = root["bufferViews"][image["bufferView"].as<std::size_t>()];
+                    const auto bufferIndex = bufferView["buffer"].as<std::size_t>();
+                    const auto viewOffset = bufferView.hasMember("byteOffset") ? bufferView["byteOffset"].as<std::size_t>() : 0;
+                    const auto viewLength = bufferView["byteLength"].as<std::size_t>();
+
+                    if (bufferIndex >= buffers.size() ||
+                        viewOffset > buffers[bufferIndex].size ||
+                        viewLength > buffers[bufferIndex].size - viewOffset)
+                        throw std::runtime_error("Invalid image buffer view");
+
+                    const std::uint8_t* imageBegin = buffers[bufferIndex].data + viewOffset;
+                    imageData.assign(imageBegin, imageBegin + viewLength);
+                }
+
+                const auto& loaders = cache.getLoaders();
+                for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+                {
+                    Loader* loader = i->get();
+                    if (loader->getType() == Loader::Image &&
+                        loader->loadAsset(bundle, imageName, imageData, mipmaps))
+                        return cache.getTexture(imageName);
+                }
+
+                throw std::runtime_error("Failed to load image " + imageName);
+            };
+
+            auto getMaterial = [&](const json::Value& primitive) -> const graphics::Material* {
+                if (!primitive.hasMember("material"))
+                {
+                    if (!defaultMaterial)
+                    {
+                        auto material = std::make_unique<graphics::Material>();
+                        material->blendState = cache.getBlendState(BLEND_ALPHA);
+                        material->shader = cache.getShader(SHADER_TEXTURE);
+                        material->textures[0] = cache.getTexture(TEXTURE_WHITE_PIXEL);
+                        defaultMaterial = material.get();
+                        bundle.setMaterial(name + "#material", std::move(material));
+                    }
+
+                    return defaultMaterial;
+                }
+
+                const auto materialIndex = primitive["material"].as<std::size_t>();
+                if (materialIndex >= materials.size())
+                    throw std::runtime_error("Invalid material index");
+
+                if (!materials[materialIndex])
+                {
+                    const json::Value& materialValue = root["materials"][materialIndex];
+
+                    auto material = std::make_unique<graphics::Material>();
+                    material->shader = cache.getShader(SHADER_TEXTURE);
+                    material->textures[0] = cache.getTexture(TEXTURE_WHITE_PIXEL);
+
+                    const auto alphaMode = materialValue.hasMember("alphaMode") ?
+                        materialValue["alphaMode"].as<std::string>() : std::string("OPAQUE");
+                    material->blendState = cache.getBlendState(alphaMode == "BLEND" ? BLEND_ALPHA : BLEND_NO_BLEND);
+
+                    if (materialValue.hasMember("doubleSided") && materialValue["doubleSided"].as<bool>())
+                        material->cullMode = graphics::CullMode::NoCull;
+
+                    if (materialValue.hasMember("pbrMetallicRoughness"))
+                    {
+                        const json::Value& pbr = materialValue["pbrMetallicRoughness"];
+
+                        if (pbr.hasMember("baseColorFactor"))
+                        {
+                            const float baseColor[] = {
+                                pbr["baseColorFactor"][0].as<float>(),
+                                pbr["baseColorFactor"][1].as<float>(),
+                                pbr["baseColorFactor"][2].as<float>(),
+                                pbr["baseColorFactor"][3].as<float>()
+                            };
+                            material->diffuseColor = Color(baseColor);
+                        }
+
+                        if (pbr.hasMember("baseColorTexture"))
+                            material->textures[0] = getTexture(pbr["baseColorTexture"]["index"].as<std::size_t>());
+                    }
+
+                    materials[materialIndex] = material.get();
+                    bundle.setMaterial(name + "#material" + std::to_string(materialIndex), std::move(material));
+                }
+
+                return materials[materialIndex];
+            };
+
+            // meshes, the non-skinned ones are transformed to the model space
+            Box3F boundingBox;
+            std::vector<std::uint32_t> indices;
+            std::vector<graphics::Vertex> vertices;
+            std::vector<scene::SkinnedMeshData::BoneWeights> boneWeights;
+            std::vector<scene::SkinnedMeshData::Part> parts;
+
+            for (const auto nodeIndex : sceneNodes)
+            {
+                const json::Value& nodeValue = root["nodes"][nodeIndex];
+                if (!nodeValue.hasMember("mesh")) continue;
+
+                const bool skinned = nodeValue.hasMember("skin");
+                const Matrix4F& worldTransform = nodes[nodeIndex].worldTransform;
+                const json::Value& mesh = root["meshes"][nodeValue["mesh"].as<std::size_t>()];
+
+                for (const json::Value& primitive : mesh["primitives"])
+                {
+                    if (primitive.hasMember("mode") && primitive["mode"].as<std::uint32_t>() != MODE_TRIANGLES)
+                        throw std::runtime_error("Only triangle primitives are supported");
+
+                    const json::Value& attributes = primitive["attributes"];
+
+                    // the attributes are read with a fixed number of components, so their types have to match
+                    auto getAttribute = [&](const char* attribute, std::size_t vertexCount,
+                                            std::size_t minComponentCount, std::size_t maxComponentCount) {
+                        if (!attributes.hasMember(attribute)) return Accessor();
+
+                        Accessor accessor(root, buffers, attributes[attribute].as<std::size_t>());
+                        if (accessor.getCount() != vertexCount)
+                            throw std::runtime_error("Invalid attribute count");
+
+                        if (accessor.getComponentCount() < minComponentCount ||
+                            accessor.getComponentCount() > maxComponentCount)
+                            throw std::runtime_error("Invalid type of attribute " + std::string(attribute));
+
+                        return accessor;
+                    };
+
+                    const Accessor positions(root, buffers, attributes["POSITION"].as<std::size_t>());
+                    if (positions.getComponentCount() != 3)
+                        throw std::runtime_error("Invalid type of attribute POSITION");
+
+                    const auto vertexCount = positions.getCount();
+                    const auto hasNormals = attributes.hasMember("NORMAL");
+                    const auto hasTexCoords0 = attributes.hasMember("TEXCOORD_0");
+                    const auto hasTexCoords1 = attributes.hasMember("TEXCOORD_1");
+                    const auto hasColors = attributes.hasMember("COLOR_0");
+                    const auto hasWeights = skinned && attributes.hasMember("JOINTS_0") && attributes.hasMember("WEIGHTS_0");
+                    const auto normals = getAttribute("NORMAL", vertexCount, 3, 3);
+                    const auto texCoords0 = getAttribute("TEXCOORD_0", vertexCount, 2, 2);
+                    const auto texCoords1 = getAttribute("TEXCOORD_1", vertexCount, 2, 2);
+                    const auto colors = getAttribute("COLOR_0", vertexCount, 3, 4);
+                    const auto joints = hasWeights ? getAttribute("JOINTS_0", vertexCount, 4, 4) : Accessor();
+                    const auto weights = hasWeights ? getAttribute("WEIGHTS_0", vertexCount, 4, 4) : Accessor();
+
+                    if (vertices.size() + vertexCount > std::numeric_limits<std::uint32_t>::max())
+                        throw std::runtime_error("Too many vertices");
+
+                    const auto baseVertex = static_cast<std::uint32_t>(vertices.size());
+                    vertices.reserve(vertices.size() + vertexCount);
+                    boneWeights.reserve(boneWeights.size() + vertexCount);
+
+                    // all the attributes of a vertex are interleaved in a single pass
+                    for (std::size_t i = 0; i < vertexCount; ++i)
+                    {
+                        graphics::Vertex vertex;
+                        vertex.position = Vector3F(positions.getFloat(i, 0), positions.getFloat(i, 1), positions.getFloat(i, 2));
+
+                        if (hasNormals)
+                            vertex.normal = Vector3F(normals.getFloat(i, 0), normals.getFloat(i, 1), normals.getFloat(i, 2));
+
+                        if (hasTexCoords0)
+                            vertex.texCoords[0] = Vector2F(texCoords0.getFloat(i, 0), texCoords0.getFloat(i, 1));
+
+                        if (hasTexCoords1)
+                            vertex.texCoords[1] = Vector2F(texCoords1.getFloat(i, 0), texCoords1.getFloat(i, 1));
+
+                        if (hasColors)
+                        {
+                            const float color[] = {
+                                colors.getFloat(i, 0),
+                                colors.getFloat(i, 1),
+                                colors.getFloat(i, 2),
+                                colors.getComponentCount() == 4 ? colors.getFloat(i, 3) : 1.0F
+                            };
+                            vertex.color = Color(color);
+                        }
+                        else
+                            vertex.color = Color::white();
+
+                        scene::SkinnedMeshData::BoneWeights vertexWeights;
+
+                        if (hasWeights)
+                        {
+                            float weightSum = 0.0F;
+
+                            for (std::size_t c = 0; c < scene::SkinnedMeshData::MAX_BONE_INFLUENCES; ++c)
+                            {
+                                const auto joint = joints.getUInt(i, c);
+                                if (joint >= jointBones.size())
+                                    throw std::runtime_error("Invalid joint index");
+
+                                vertexWeights.bones[c] = static_cast<std::uint16_t>(jointBones[joint]);
+                                vertexWeights.weights[c] = weights.getFloat(i, c);
+                                weightSum += vertexWeights.weights[c];
+                            }
+
+                            if (weightSum > std::numeric_limits<float>::min())
+                                for (float& weight : vertexWeights.weights)
+                                    weight /= weightSum;
+                        }
+                        else if (!skinned)
+                        {
+                            worldTransform.transformPoint(vertex.position);
+                            worldTransform.transformVector(vertex.normal);
+                            vertex.normal.normalize();
+                        }
+
+                        boundingBox.insertPoint(vertex.position);
+                        vertices.push_back(vertex);
+                        boneWeights.push_back(vertexWeights);
+                    }
+
+                    scene::SkinnedMeshData::Part part;
+                    part.startIndex = static_cast<std::uint32_t>(indices.size());
+                    part.material = getMaterial(primitive);
+
+                    if (primitive.hasMember("indices"))
+                    {
+                        const Accessor primitiveIndices(root, buffers, primitive["indices"].as<std::size_t>());
+                        if (primitiveIndices.getComponentCount() != 1)
+                            throw std::runtime_error("Invalid type of indices");
+
+                        indices.reserve(indices.size() + primitiveIndices.getCount());
+
+                        for (std::size_t i = 0; i < primitiveIndices.getCount(); ++i)
+                        {
+                            const auto index = primitiveIndices.getUInt(i, 0);
+                            if (index >= vertexCount)
+                                throw std::runtime_error("Invalid index");
+
+                            indices.push_back(baseVertex + index);
+                        }
+                    }
+                    else
+                        for (std::size_t i = 0; i < vertexCount; ++i)
+                            indices.push_back(baseVertex + static_cast<std::uint32_t>(i));
+
+                    part.indexCount = static_cast<std::uint32_t>(indices.size()) - part.startIndex;
+                    parts.push_back(part);
+                }
+            }
+
+            // animations of the bones, the animations of other nodes are ignored
+            std::map<std::string, scene::SkinnedMeshData::Animation> animations;
+
+            if (root.hasMember("animations"))
+            {
+                const json::Value& animationsValue = root["animations"];
+
+                for (std::size_t animationIndex = 0; animationIndex < animationsValue.getSize(); ++animationIndex)
+                {
+                    const json::Value& animationValue = animationsValue[animationIndex];
+                    const json::Value& samplers = animationValue["samplers"];
+                    scene::SkinnedMeshData::Animation animation;
+
+                    for (const json::Value& channelValue : animationValue["channels"])
+                    {
+                        const json::Value& target = channelValue["target"];
+                        if (!target.hasMember("node")) continue;
+
+                        const auto targetNode = target["node"].as<std::size_t>();
+                        if (targetNode >= nodes.size() || nodeBones[targetNode] == scene::SkinnedMeshData::NO_PARENT)
+                            continue;
+
+                        scene::SkinnedMeshData::Channel channel;
+                        channel.bone = nodeBones[targetNode];
+
+                        const auto& path = target["path"].as<std::string>();
+                        if (path == "translation") channel.path = scene::SkinnedMeshData::Channel::Path::Translation;
+                        else if (path == "rotation") channel.path = scene::SkinnedMeshData::Channel::Path::Rotation;
+                        else if (path == "scale") channel.path = scene::SkinnedMeshData::Channel::Path::Scale;
+                        else continue; // morph target weights
+
+                        const json::Value& sampler = samplers[channelValue["sampler"].as<std::size_t>()];
+                        const auto interpolation = sampler.hasMember("interpolation") ?
+                            sampler["interpolation"].as<std::string>() : std::string("LINEAR");
+
+                        // cubic spline keys are stored as in-tangent, value and out-tangent, only the values are used
+                        const bool cubicSpline = interpolation == "CUBICSPLINE";
+                        channel.interpolation = (interpolation == "STEP") ?
+                            scene::SkinnedMeshData::Channel::Interpolation::Step :
+                            scene::SkinnedMeshData::Channel::Interpolation::Linear;
+
+                        const Accessor input(root, buffers, sampler["input"].as<std::size_t>());
+                        const Accessor output(root, buffers, sampler["output"].as<std::size_t>());
+
+                        const std::size_t componentCount = (channel.path == scene::SkinnedMeshData::Channel::Path::Rotation) ? 4 : 3;
+                        const std::size_t keysPerTime = cubicSpline ? 3 : 1;
+
+                        if (input.getComponentCount() != 1 ||
+                            output.getComponentCount() != componentCount ||
+                            output.getCount() < input.getCount() * keysPerTime)
+                            throw std::runtime_error("Invalid animation sampler");
+
+                        channel.times.reserve(input.getCount());
+                        channel.values.reserve(input.getCount() * componentCount);
+
+                        for (std::size_t i = 0; i < input.getCount(); ++i)
+                        {
+                            const float time = input.getFloat(i, 0);
+                            if (!channel.times.empty() && time < channel.times.back())
+                                throw std::runtime_error("Animation times are not increasing");
+
+                            channel.times.push_back(time);
+                            animation.duration = std::max(animation.duration, time);
+
+                            const auto key = cubicSpline ? i * 3 + 1 : i;
+                            for (std::size_t c = 0; c < componentCount; ++c)
+                                channel.values.push_back(output.getFloat(key, c));
+                        }
 
-            const json::Value& nodesValue = d["nodes"];
-            const json::Value& meshesValue = d["meshes"];
+                        animation.channels.push_back(std::move(channel));
+                    }
 
-            (void)mipmaps;
-            (void)nodesValue;
-            (void)meshesValue;
+                    const auto animationName = animationValue.hasMember("name") ?
+                        animationValue["name"].as<std::string>() : std::to_string(animationIndex);
+                    animations[animationName] = std::move(animation);
+                }
+            }
 
-            scene::SkinnedMeshData skinnedMeshData;
-            bundle.setSkinnedMeshData(name, std::move(skinnedMeshData));
+            scene::SkinnedMeshData meshData(boundingBox, indices,
+                                            std::move(vertices),
+                                            std::move(boneWeights),
+                                            std::move(bones),
+                                            std::move(parts),
+                                            std::move(animations));
+            bundle.setSkinnedMeshData(name, std::move(meshData));
 
             return true;
         }
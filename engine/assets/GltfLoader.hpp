@@ -3,12 +3,16 @@
 #ifndef OUZEL_ASSETS_GLTFLOADER_HPP
 #define OUZEL_ASSETS_GLTFLOADER_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include "assets/Loader.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
+        // Loads the meshes, materials, skin and animations of a glTF 2.0 model (.gltf or binary .glb) into
+        // one skinned mesh, the accessors are read straight from the mapped file or buffer without copying them first
         class GltfLoader final: public Loader
         {
         public:
@@ -17,6 +21,18 @@ namespace ouzel
                            const std::string& name,
                            const std::vector<std::uint8_t>& data,
                            bool mipmaps = true) final;
+            bool loadFile(Bundle& bundle,
+                          const std::string& name,
+                          const std::string& filename,
+                          bool mipmaps) final;
+
+        private:
+            bool loadModel(Bundle& bundle,
+                           const std::string& name,
+                           const std::string& directory,
+                           const std::uint8_t* data,
+                           std::size_t size,
+                           bool mipmaps);
         };
     } // namespace assets
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #define OUZEL_ASSETS_IMAGELOADER_HPP
 
 #include "assets/Loader.hpp"
+#include "graphics/Image.hpp"
 
 namespace ouzel
 {
@@ -17,6 +18,9 @@ namespace ouzel
                            const std::string& name,
                            const std::vector<std::uint8_t>& data,
                            bool mipmaps = true) final;
+
+            // decodes the image to RGBA8
+            static graphics::Image loadImage(const std::vector<std::uint8_t>& data);
         };
     } // namespace assets
 } // namespace ouzel
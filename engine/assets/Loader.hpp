@@ -50,6 +50,16 @@ namespace ouzel
                                    const std::vector<std::uint8_t>& data,
                                    bool mipmaps = true) = 0;
 
+            // called before the file is read into memory, loaders that can use the file in place
+            // (e.g. by mapping it) override this and return true if they loaded it
+            virtual bool loadFile(Bundle&,
+                                  const std::string&,
+                                  const std::string&,
+                                  bool)
+            {
+                return false;
+            }
+
         protected:
             Cache& cache;
             std::uint32_t type;
@@ -1,10 +1,11 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
-#include <map>
 #include <stdexcept>
 #include <string>
-#include <tuple>
+#include <utility>
 #include "ObjLoader.hpp"
 #include "Bundle.hpp"
 #include "Cache.hpp"
@@ -74,91 +75,211 @@ namespace ouzel
                 return result;
             }
 
+            constexpr auto isDigit(std::uint8_t c)
+            {
+                return c >= '0' && c <= '9';
+            }
+
+            // parses the digits in place, returns 0 if there are none
             std::int32_t parseInt32(std::vector<std::uint8_t>::const_iterator& iterator,
                                     std::vector<std::uint8_t>::const_iterator end)
             {
-                std::string value;
-                std::uint32_t length = 1;
-
+                bool negative = false;
                 if (iterator != end && *iterator == '-')
                 {
-                    value.push_back(static_cast<char>(*iterator));
-                    ++length;
+                    negative = true;
                     ++iterator;
                 }
 
-                while (iterator != end && *iterator >= '0' && *iterator <= '9')
+                std::int32_t result = 0;
+                while (iterator != end && isDigit(*iterator))
                 {
-                    value.push_back(static_cast<char>(*iterator));
-
+                    result = result * 10 + (*iterator - '0');
                     ++iterator;
                 }
 
-                if (value.length() < length) return false;
-
-                return std::stoi(value);
+                return negative ? -result : result;
             }
 
+            // parses the mantissa into an integer and scales it by a power of ten, which is exact for
+            // the powers up to 22 and much faster than going through std::stof
             float parseFloat(std::vector<std::uint8_t>::const_iterator& iterator,
                              std::vector<std::uint8_t>::const_iterator end)
             {
-                std::string value;
-                std::uint32_t length = 1;
-
-                if (iterator != end && *iterator == '-')
+                constexpr double powersOf10[] = {
+                    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                };
+                constexpr std::int32_t maxPowerOf10 = 22;
+                constexpr std::uint64_t maxMantissa = 100000000000000000ULL; // further digits don't fit in a double
+
+                bool negative = false;
+                if (iterator != end && (*iterator == '-' || *iterator == '+'))
                 {
-                    value.push_back(static_cast<char>(*iterator));
-                    ++length;
+                    negative = (*iterator == '-');
                     ++iterator;
                 }
 
-                while (iterator != end && *iterator >= '0' && *iterator <= '9')
+                std::uint64_t mantissa = 0;
+                std::int32_t exponent = 0;
+                bool hasDigits = false;
+
+                while (iterator != end && isDigit(*iterator))
                 {
-                    value.push_back(static_cast<char>(*iterator));
+                    if (mantissa < maxMantissa)
+                        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*iterator - '0');
+                    else
+                        ++exponent;
 
+                    hasDigits = true;
                     ++iterator;
                 }
 
                 if (iterator != end && *iterator == '.')
                 {
-                    value.push_back(static_cast<char>(*iterator));
-                    ++length;
                     ++iterator;
 
-                    while (iterator != end && *iterator >= '0' && *iterator <= '9')
+                    while (iterator != end && isDigit(*iterator))
                     {
-                        value.push_back(static_cast<char>(*iterator));
+                        if (mantissa < maxMantissa)
+                        {
+                            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*iterator - '0');
+                            --exponent;
+                        }
 
+                        hasDigits = true;
                         ++iterator;
                     }
                 }
 
+                if (!hasDigits) return 0.0F;
+
                 // parse exponent
                 if (iterator != end &&
                     (*iterator == 'e' || *iterator == 'E'))
                 {
-                    value.push_back(static_cast<char>(*iterator));
                     if (++iterator == end)
                         throw std::runtime_error("Invalid exponent");
 
+                    bool negativeExponent = false;
                     if (*iterator == '+' || *iterator == '-')
-                        value.push_back(static_cast<char>(*iterator++));
+                        negativeExponent = (*iterator++ == '-');
 
-                    if (iterator == end || *iterator < '0' || *iterator > '9')
+                    if (iterator == end || !isDigit(*iterator))
                         throw std::runtime_error("Invalid exponent");
 
-                    while (iterator != end && *iterator >= '0' && *iterator <= '9')
+                    std::int32_t value = 0;
+                    while (iterator != end && isDigit(*iterator))
                     {
-                        value.push_back(static_cast<char>(*iterator));
+                        if (value < 1000) value = value * 10 + (*iterator - '0');
                         ++iterator;
                     }
+
+                    exponent += negativeExponent ? -value : value;
                 }
 
-                if (value.length() < length) return false;
+                double result = static_cast<double>(mantissa);
+
+                if (exponent < -maxPowerOf10 || exponent > maxPowerOf10)
+                    result *= std::pow(10.0, exponent);
+                else if (exponent < 0)
+                    result /= powersOf10[-exponent];
+                else
+                    result *= powersOf10[exponent];
 
-                return std::stof(value);
+                return static_cast<float>(negative ? -result : result);
             }
 
+            // compares the keyword in place, without copying it to a string
+            template <std::size_t N>
+            bool isKeyword(std::vector<std::uint8_t>::const_iterator begin,
+                           std::vector<std::uint8_t>::const_iterator end,
+                           const char (&keyword)[N])
+            {
+                return static_cast<std::size_t>(end - begin) == N - 1 &&
+                    std::equal(begin, end, keyword);
+            }
+
+            // open addressing hash map from the position, texture coordinate and normal indices of a face vertex
+            // to the index of the vertex, the position index of an empty slot is 0
+            class VertexMap final
+            {
+            public:
+                // returns the index of the existing vertex or inserts the new index
+                std::pair<std::uint32_t, bool> insert(std::uint32_t position,
+                                                      std::uint32_t texCoord,
+                                                      std::uint32_t normal,
+                                                      std::uint32_t index)
+                {
+                    if ((count + 1) * 2 > entries.size())
+                        grow();
+
+                    const std::size_t mask = entries.size() - 1;
+                    for (std::size_t slot = hash(position, texCoord, normal) & mask;; slot = (slot + 1) & mask)
+                    {
+                        Entry& entry = entries[slot];
+
+                        if (entry.position == 0)
+                        {
+                            entry = Entry{position, texCoord, normal, index};
+                            ++count;
+                            return std::make_pair(index, true);
+                        }
+
+                        if (entry.position == position &&
+                            entry.texCoord == texCoord &&
+                            entry.normal == normal)
+                            return std::make_pair(entry.index, false);
+                    }
+                }
+
+                void clear() noexcept
+                {
+                    std::fill(entries.begin(), entries.end(), Entry{});
+                    count = 0;
+                }
+
+            private:
+                struct Entry final
+                {
+                    std::uint32_t position = 0;
+                    std::uint32_t texCoord = 0;
+                    std::uint32_t normal = 0;
+                    std::uint32_t index = 0;
+                };
+
+                static std::size_t hash(std::uint32_t position,
+                                        std::uint32_t texCoord,
+                                        std::uint32_t normal) noexcept
+                {
+                    std::uint64_t result = position * 0x9E3779B97F4A7C15ULL;
+                    result ^= texCoord * 0xC2B2AE3D27D4EB4FULL;
+                    result ^= normal * 0x165667B19E3779F9ULL;
+                    return static_cast<std::size_t>(result ^ (result >> 32));
+                }
+
+                void grow()
+                {
+                    std::vector<Entry> oldEntries(entries.empty() ? 1024 : entries.size() * 2);
+                    oldEntries.swap(entries);
+                    count = 0;
+
+                    const std::size_t mask = entries.size() - 1;
+                    for (const Entry& oldEntry : oldEntries)
+                        if (oldEntry.position != 0)
+                        {
+                            std::size_t slot = hash(oldEntry.position, oldEntry.texCoord, oldEntry.normal) & mask;
+                            while (entries[slot].position != 0) slot = (slot + 1) & mask;
+
+                            entries[slot] = oldEntry;
+                            ++count;
+                        }
+                }
+
+                std::vector<Entry> entries;
+                std::size_t count = 0;
+            };
+
             bool parseToken(const std::vector<std::uint8_t>& str,
                             std::vector<std::uint8_t>::const_iterator& iterator,
                             char token)
@@ -187,15 +308,15 @@ namespace ouzel
             std::vector<Vector2F> texCoords;
             std::vector<Vector3F> normals;
             std::vector<graphics::Vertex> vertices;
-            std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> vertexMap;
+            VertexMap vertexMap;
             std::vector<std::uint32_t> indices;
+            std::vector<std::uint32_t> vertexIndices;
             Box3F boundingBox;
 
             std::uint32_t objectCount = 0;
 
             auto iterator = data.cbegin();
 
-            std::string keyword;
             std::string value;
 
             while (iterator != data.end())
@@ -213,9 +334,16 @@ namespace ouzel
                 else
                 {
                     skipWhitespaces(iterator, data.end());
-                    keyword = parseString(iterator, data.end());
 
-                    if (keyword == "mtllib")
+                    const auto keywordBegin = iterator;
+                    while (iterator != data.end() && !isControlChar(*iterator) && !isWhitespace(*iterator))
+                        ++iterator;
+                    const auto keywordEnd = iterator;
+
+                    if (keywordBegin == keywordEnd)
+                        throw std::runtime_error("Invalid string");
+
+                    if (isKeyword(keywordBegin, keywordEnd, "mtllib"))
                     {
                         skipWhitespaces(iterator, data.end());
                         value = parseString(iterator, data.end());
@@ -226,7 +354,7 @@ namespace ouzel
                         // TODO don't load material lib every time
                         bundle.loadAsset(Loader::Material, value, value, mipmaps);
                     }
-                    else if (keyword == "usemtl")
+                    else if (isKeyword(keywordBegin, keywordEnd, "usemtl"))
                     {
                         skipWhitespaces(iterator, data.end());
                         value = parseString(iterator, data.end());
@@ -235,11 +363,11 @@ namespace ouzel
 
                         material = cache.getMaterial(value);
                     }
-                    else if (keyword == "o")
+                    else if (isKeyword(keywordBegin, keywordEnd, "o"))
                     {
                         if (objectCount)
                         {
-                            scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
+                            scene::StaticMeshData meshData(boundingBox, std::move(indices), std::move(vertices), material);
                             bundle.setStaticMeshData(objectName, std::move(meshData));
                         }
 
@@ -255,7 +383,7 @@ namespace ouzel
                         boundingBox.reset();
                         ++objectCount;
                     }
-                    else if (keyword == "v")
+                    else if (isKeyword(keywordBegin, keywordEnd, "v"))
                     {
                         Vector3F position;
 
@@ -270,7 +398,7 @@ namespace ouzel
 
                         positions.push_back(position);
                     }
-                    else if (keyword == "vt")
+                    else if (isKeyword(keywordBegin, keywordEnd, "vt"))
                     {
                         Vector2F texCoord;
 
@@ -283,7 +411,7 @@ namespace ouzel
 
                         texCoords.push_back(texCoord);
                     }
-                    else if (keyword == "vn")
+                    else if (isKeyword(keywordBegin, keywordEnd, "vn"))
                     {
                         Vector3F normal;
 
@@ -298,20 +426,21 @@ namespace ouzel
 
                         normals.push_back(normal);
                     }
-                    else if (keyword == "f")
+                    else if (isKeyword(keywordBegin, keywordEnd, "f"))
                     {
-                        std::vector<std::uint32_t> vertexIndices;
+                        vertexIndices.clear();
 
-                        auto i = std::make_tuple<std::uint32_t, std::uint32_t, std::uint32_t>(0, 0, 0);
+                        std::uint32_t i[3] = {0, 0, 0};
                         std::int32_t positionIndex = 0;
                         std::int32_t texCoordIndex = 0;
                         std::int32_t normalIndex = 0;
 
                         while (iterator != data.end())
                         {
-                            if (isNewline(*iterator)) break;
-
                             skipWhitespaces(iterator, data.end());
+                            if (iterator == data.end() || isNewline(*iterator)) break;
+
+                            i[0] = i[1] = i[2] = 0;
                             positionIndex = parseInt32(iterator, data.end());
 
                             if (positionIndex < 0)
@@ -320,7 +449,7 @@ namespace ouzel
                             if (positionIndex < 1 || positionIndex > static_cast<std::int32_t>(positions.size()))
                                 throw std::runtime_error("Invalid position index");
 
-                            std::get<0>(i) = static_cast<std::uint32_t>(positionIndex);
+                            i[0] = static_cast<std::uint32_t>(positionIndex);
 
                             // has texture coordinates
                             if (parseToken(data, iterator, '/'))
@@ -336,7 +465,7 @@ namespace ouzel
                                     if (texCoordIndex < 1 || texCoordIndex > static_cast<std::int32_t>(texCoords.size()))
                                         throw std::runtime_error("Invalid texture coordinate index");
 
-                                    std::get<1>(i) = static_cast<std::uint32_t>(texCoordIndex);
+                                    i[1] = static_cast<std::uint32_t>(texCoordIndex);
                                 }
 
                                 // has normal
@@ -350,30 +479,25 @@ namespace ouzel
                                     if (normalIndex < 1 || normalIndex > static_cast<std::int32_t>(normals.size()))
                                         throw std::runtime_error("Invalid normal index");
 
-                                    std::get<2>(i) = static_cast<std::uint32_t>(normalIndex);
+                                    i[2] = static_cast<std::uint32_t>(normalIndex);
                                 }
                             }
 
-                            std::uint32_t index = 0;
+                            const auto result = vertexMap.insert(i[0], i[1], i[2],
+                                                                 static_cast<std::uint32_t>(vertices.size()));
 
-                            auto vertexIterator = vertexMap.find(i);
-                            if (vertexIterator == vertexMap.end())
+                            if (result.second)
                             {
-                                index = static_cast<std::uint32_t>(vertices.size());
-                                vertexMap[i] = index;
-
                                 graphics::Vertex vertex;
-                                if (std::get<0>(i) >= 1) vertex.position = positions[std::get<0>(i) - 1];
-                                if (std::get<1>(i) >= 1) vertex.texCoords[0] = texCoords[std::get<1>(i) - 1];
+                                if (i[0] >= 1) vertex.position = positions[i[0] - 1];
+                                if (i[1] >= 1) vertex.texCoords[0] = texCoords[i[1] - 1];
                                 vertex.color = Color::white();
-                                if (std::get<2>(i) >= 1) vertex.normal = normals[std::get<2>(i) - 1];
+                                if (i[2] >= 1) vertex.normal = normals[i[2] - 1];
                                 vertices.push_back(vertex);
                                 boundingBox.insertPoint(vertex.position);
                             }
-                            else
-                                index = vertexIterator->second;
 
-                            vertexIndices.push_back(index);
+                            vertexIndices.push_back(result.first);
                         }
 
                         if (vertexIndices.size() < 3)
@@ -401,7 +525,7 @@ namespace ouzel
 
             if (objectCount)
             {
-                scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
+                scene::StaticMeshData meshData(boundingBox, std::move(indices), std::move(vertices), material);
                 bundle.setStaticMeshData(objectName, std::move(meshData));
             }
 
@@ -125,6 +125,16 @@ namespace ouzel
                 }
             }
 
+            // atlases written by the asset cooker also make every frame available as a sprite named after its image
+            if (metaObject.hasMember("atlas") && metaObject["atlas"].as<bool>())
+                for (const scene::SpriteData::Frame& frame : animation.frames)
+                {
+                    scene::SpriteData frameSpriteData;
+                    frameSpriteData.texture = spriteData.texture;
+                    frameSpriteData.animations[""].frames.push_back(frame);
+                    bundle.setSpriteData(frame.getName(), frameSpriteData);
+                }
+
             spriteData.animations[""] = std::move(animation);
 
             bundle.setSpriteData(name, spriteData);
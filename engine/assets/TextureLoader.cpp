@@ -0,0 +1,116 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include "TextureLoader.hpp"
+#include "Bundle.hpp"
+#include "core/Engine.hpp"
+#include "graphics/Texture.hpp"
+#include "storage/MappedFile.hpp"
+#include "storage/Path.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        namespace
+        {
+            constexpr std::uint8_t MAGIC[4] = {'O', 'T', 'E', 'X'};
+        }
+
+        TextureLoader::TextureLoader(Cache& initCache):
+            Loader(initCache, Loader::Image)
+        {
+        }
+
+        bool TextureLoader::loadAsset(Bundle& bundle,
+                                      const std::string& name,
+                                      const std::vector<std::uint8_t>& data,
+                                      bool mipmaps)
+        {
+            // other images are loaded by the image loader
+            if (data.size() < sizeof(MAGIC) ||
+                std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+                return false;
+
+            loadTexture(bundle, name, data.data(), data.size(), mipmaps);
+
+            return true;
+        }
+
+        bool TextureLoader::loadFile(Bundle& bundle,
+                                     const std::string& name,
+                                     const std::string& filename,
+                                     bool mipmaps)
+        {
+            if (storage::Path(filename).getExtension() != "otexture")
+                return false;
+
+            const storage::MappedFile file = bundle.getFileSystem().mapFile(filename);
+
+            // the file is in an archive, let the bundle read it
+            if (!file.getData())
+                return false;
+
+            loadTexture(bundle, name, file.getData(), file.getSize(), mipmaps);
+
+            return true;
+        }
+
+        void TextureLoader::loadTexture(Bundle& bundle,
+                                        const std::string& name,
+                                        const std::uint8_t* data,
+                                        std::size_t size,
+                                        bool mipmaps)
+        {
+            if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+                throw std::runtime_error("Invalid texture container");
+
+            if (decodeLittleEndian<std::uint32_t>(data + 4) != VERSION)
+                throw std::runtime_error("Unsupported texture container version");
+
+            const auto pixelFormat = static_cast<graphics::PixelFormat>(decodeLittleEndian<std::uint32_t>(data + 8));
+            const auto pixelSize = graphics::getPixelSize(pixelFormat);
+            if (pixelSize == 0)
+                throw std::runtime_error("Unsupported pixel format");
+
+            const Size2U textureSize(decodeLittleEndian<std::uint32_t>(data + 12),
+                                     decodeLittleEndian<std::uint32_t>(data + 16));
+            const auto levelCount = decodeLittleEndian<std::uint32_t>(data + 20);
+
+            if (levelCount == 0 || levelCount > (size - HEADER_SIZE) / LEVEL_HEADER_SIZE)
+                throw std::runtime_error("Invalid mip level count");
+
+            const std::uint32_t usedLevelCount = mipmaps ? levelCount : 1;
+
+            std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> levels;
+            levels.reserve(usedLevelCount);
+
+            for (std::uint32_t level = 0; level < usedLevelCount; ++level)
+            {
+                const std::uint8_t* levelHeader = data + HEADER_SIZE + level * LEVEL_HEADER_SIZE;
+                const Size2U levelSize(decodeLittleEndian<std::uint32_t>(levelHeader),
+                                       decodeLittleEndian<std::uint32_t>(levelHeader + 4));
+                const auto offset = decodeLittleEndian<std::uint64_t>(levelHeader + 8);
+                const auto dataSize = decodeLittleEndian<std::uint64_t>(levelHeader + 16);
+
+                if (dataSize != static_cast<std::uint64_t>(levelSize.v[0]) * levelSize.v[1] * pixelSize ||
+                    offset > size || dataSize > size - offset)
+                    throw std::runtime_error("Invalid mip level");
+
+                // the only copy of the pixels, from the mapped pages to the buffer owned by the render device
+                const std::uint8_t* levelData = data + offset;
+                levels.emplace_back(levelSize, std::vector<std::uint8_t>(levelData, levelData + dataSize));
+            }
+
+            auto texture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
+                                                               std::move(levels),
+                                                               textureSize, 0,
+                                                               pixelFormat);
+
+            bundle.setTexture(name, texture);
+        }
+    } // namespace assets
+} // namespace ouzel
@@ -0,0 +1,52 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_TEXTURELOADER_HPP
+#define OUZEL_ASSETS_TEXTURELOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "assets/Loader.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // Loads the .otexture containers written by the asset cooker, they hold the whole mip chain
+        // in the final pixel format, so the levels are uploaded without decoding or converting them.
+        // Layout (little-endian): "OTEX", version, pixel format, width, height, level count, flags and
+        // a reserved field (all 32-bit), then per level its width, height (32-bit), offset and size (64-bit)
+        // followed by the level data, each level starting at an offset aligned to ALIGNMENT
+        class TextureLoader final: public Loader
+        {
+        public:
+            static constexpr std::uint32_t VERSION = 1;
+            static constexpr std::size_t HEADER_SIZE = 32;
+            static constexpr std::size_t LEVEL_HEADER_SIZE = 24;
+            static constexpr std::size_t ALIGNMENT = 16;
+
+            enum Flags
+            {
+                PremultipliedAlpha = 0x01
+            };
+
+            explicit TextureLoader(Cache& initCache);
+            bool loadAsset(Bundle& bundle,
+                           const std::string& name,
+                           const std::vector<std::uint8_t>& data,
+                           bool mipmaps = true) final;
+            bool loadFile(Bundle& bundle,
+                          const std::string& name,
+                          const std::string& filename,
+                          bool mipmaps) final;
+
+        private:
+            static void loadTexture(Bundle& bundle,
+                                    const std::string& name,
+                                    const std::uint8_t* data,
+                                    std::size_t size,
+                                    bool mipmaps);
+        };
+    } // namespace assets
+} // namespace ouzel
+
+#endif // OUZEL_ASSETS_TEXTURELOADER_HPP
@@ -10,6 +10,7 @@
 #include "coreaudio/CAAudioDevice.hpp"
 #include "dsound/DSAudioDevice.hpp"
 #include "empty/EmptyAudioDevice.hpp"
+#include "offline/OfflineAudioDevice.hpp"
 #include "openal/OALAudioDevice.hpp"
 #include "opensl/OSLAudioDevice.hpp"
 #include "xaudio2/XA2AudioDevice.hpp"
@@ -59,6 +60,8 @@ namespace ouzel
                 return Driver::ALSA;
             else if (driver == "wasapi")
                 return Driver::WASAPI;
+            else if (driver == "offline")
+                return Driver::Offline;
             else
                 throw std::runtime_error("Invalid audio driver");
         }
@@ -70,6 +73,7 @@ namespace ouzel
             if (availableDrivers.empty())
             {
                 availableDrivers.insert(Driver::Empty);
+                availableDrivers.insert(Driver::Offline);
 
 #if OUZEL_COMPILE_OPENAL
                 availableDrivers.insert(Driver::OpenAL);
@@ -140,6 +144,9 @@ namespace ouzel
                         engine->log(Log::Level::Info) << "Using WASAPI audio driver";
                         return std::make_unique<wasapi::AudioDevice>(512, 44100, 0, dataGetter);
 #endif
+                    case Driver::Offline:
+                        engine->log(Log::Level::Info) << "Using offline audio driver";
+                        return std::make_unique<offline::AudioDevice>(512, 44100, 0, dataGetter);
                     default:
                         engine->log(Log::Level::Info) << "Not using audio driver";
                         static_cast<void>(debugAudio);
@@ -209,6 +216,7 @@ namespace ouzel
 
         void Audio::getSamples(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples)
         {
+            Profiler::Zone zone(engine->getProfiler(), "Mixer::getSamples");
             mixer.getSamples(frames, channels, sampleRate, samples);
         }
 
@@ -1,11 +1,594 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
 #include "AudioDevice.hpp"
+#include "math/MathUtils.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
+        namespace
+        {
+            constexpr float INT16_SCALE = 32767.0F;
+            constexpr float INT24_SCALE = 8388607.0F;
+            constexpr float INT32_SCALE = 2147483520.0F; // largest float below 2^31
+
+            inline std::uint32_t xorshift(std::uint32_t x) noexcept
+            {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                return x;
+            }
+
+            // returns a random number in range [0, 1)
+            inline float toUnit(std::uint32_t x) noexcept
+            {
+                const std::uint32_t bits = (x >> 9) | 0x3F800000U;
+                float result;
+                std::memcpy(&result, &bits, sizeof(result));
+                return result - 1.0F;
+            }
+
+            // triangular probability density function noise in range (-1, 1)
+            inline float tpdf(std::uint32_t& state) noexcept
+            {
+                state = xorshift(state);
+                const float r1 = toUnit(state);
+                state = xorshift(state);
+                const float r2 = toUnit(state);
+                return r1 - r2;
+            }
+
+            inline std::int32_t convertSample(float sample, float scale) noexcept
+            {
+                return static_cast<std::int32_t>(std::lrint(clamp(sample, -1.0F, 1.0F) * scale));
+            }
+
+#if defined(__SSE2__)
+            inline __m128i xorshift(__m128i x) noexcept
+            {
+                x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+                x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+                x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+                return x;
+            }
+
+            inline __m128 toUnit(__m128i x) noexcept
+            {
+                const __m128i bits = _mm_or_si128(_mm_srli_epi32(x, 9), _mm_set1_epi32(0x3F800000));
+                return _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(1.0F));
+            }
+
+            inline __m128 tpdf(__m128i& state) noexcept
+            {
+                state = xorshift(state);
+                const __m128 r1 = toUnit(state);
+                state = xorshift(state);
+                const __m128 r2 = toUnit(state);
+                return _mm_sub_ps(r1, r2);
+            }
+#elif defined(__ARM_NEON__)
+            inline uint32x4_t xorshift(uint32x4_t x) noexcept
+            {
+                x = veorq_u32(x, vshlq_n_u32(x, 13));
+                x = veorq_u32(x, vshrq_n_u32(x, 17));
+                x = veorq_u32(x, vshlq_n_u32(x, 5));
+                return x;
+            }
+
+            inline float32x4_t toUnit(uint32x4_t x) noexcept
+            {
+                const uint32x4_t bits = vorrq_u32(vshrq_n_u32(x, 9), vdupq_n_u32(0x3F800000U));
+                return vsubq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(1.0F));
+            }
+
+            inline float32x4_t tpdf(uint32x4_t& state) noexcept
+            {
+                state = xorshift(state);
+                const float32x4_t r1 = toUnit(state);
+                state = xorshift(state);
+                const float32x4_t r2 = toUnit(state);
+                return vsubq_f32(r1, r2);
+            }
+
+            // round to nearest, vcvtq_s32_f32 truncates towards zero
+            inline int32x4_t roundToInt(float32x4_t x) noexcept
+            {
+                const float32x4_t half = vbslq_f32(vcltq_f32(x, vdupq_n_f32(0.0F)), vdupq_n_f32(-0.5F), vdupq_n_f32(0.5F));
+                return vcvtq_s32_f32(vaddq_f32(x, half));
+            }
+#endif
+
+            // converts the float samples to 16-bit integers with saturation and optional dither
+            void convert(const float* source, std::int16_t* destination, std::size_t count, std::uint32_t* ditherState)
+            {
+                std::size_t i = 0;
+
+                if (isSimdAvailable)
+                {
+#if defined(__SSE2__)
+                    const __m128 minValue = _mm_set1_ps(-1.0F);
+                    const __m128 maxValue = _mm_set1_ps(1.0F);
+                    const __m128 scale = _mm_set1_ps(INT16_SCALE);
+                    __m128i state = ditherState ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(ditherState)) : _mm_setzero_si128();
+
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), minValue), maxValue), scale);
+                        __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i + 4), minValue), maxValue), scale);
+
+                        if (ditherState)
+                        {
+                            a = _mm_add_ps(a, tpdf(state));
+                            b = _mm_add_ps(b, tpdf(state));
+                        }
+
+                        // packs saturates the values that dither pushed out of range
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i),
+                                         _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+                    }
+
+                    if (ditherState) _mm_storeu_si128(reinterpret_cast<__m128i*>(ditherState), state);
+#elif defined(__ARM_NEON__)
+                    const float32x4_t minValue = vdupq_n_f32(-1.0F);
+                    const float32x4_t maxValue = vdupq_n_f32(1.0F);
+                    const float32x4_t scale = vdupq_n_f32(INT16_SCALE);
+                    uint32x4_t state = ditherState ? vld1q_u32(ditherState) : vdupq_n_u32(0);
+
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(source + i), minValue), maxValue), scale);
+                        float32x4_t b = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(source + i + 4), minValue), maxValue), scale);
+
+                        if (ditherState)
+                        {
+                            a = vaddq_f32(a, tpdf(state));
+                            b = vaddq_f32(b, tpdf(state));
+                        }
+
+                        vst1q_s16(destination + i, vcombine_s16(vqmovn_s32(roundToInt(a)), vqmovn_s32(roundToInt(b))));
+                    }
+
+                    if (ditherState) vst1q_u32(ditherState, state);
+#endif
+                }
+
+                for (; i < count; ++i)
+                {
+                    float value = clamp(source[i], -1.0F, 1.0F) * INT16_SCALE;
+                    if (ditherState) value += tpdf(ditherState[i % 4]);
+                    destination[i] = static_cast<std::int16_t>(clamp(std::lrint(value), -32768L, 32767L));
+                }
+            }
+
+            // converts the float samples to 24-bit or 32-bit integers with saturation
+            void convert(const float* source, std::int32_t* destination, std::size_t count, float scale)
+            {
+                std::size_t i = 0;
+
+                if (isSimdAvailable)
+                {
+#if defined(__SSE2__)
+                    const __m128 minValue = _mm_set1_ps(-1.0F);
+                    const __m128 maxValue = _mm_set1_ps(1.0F);
+                    const __m128 scaleValue = _mm_set1_ps(scale);
+
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), minValue), maxValue), scaleValue);
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_cvtps_epi32(a));
+                    }
+#elif defined(__ARM_NEON__)
+                    const float32x4_t minValue = vdupq_n_f32(-1.0F);
+                    const float32x4_t maxValue = vdupq_n_f32(1.0F);
+                    const float32x4_t scaleValue = vdupq_n_f32(scale);
+
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(source + i), minValue), maxValue), scaleValue);
+                        vst1q_s32(destination + i, roundToInt(a));
+                    }
+#endif
+                }
+
+                for (; i < count; ++i)
+                    destination[i] = convertSample(source[i], scale);
+            }
+
+            template <std::uint32_t channels, class T>
+            void interleave(const T* planar, T* result, std::uint32_t frames, std::uint32_t firstFrame)
+            {
+                for (std::uint32_t frame = firstFrame; frame < frames; ++frame)
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                        result[frame * channels + channel] = planar[channel * frames + frame];
+            }
+
+            template <class T>
+            void interleave(const T* planar, T* result, std::uint32_t frames, std::uint32_t channels)
+            {
+                for (std::uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    const T* planarChannel = &planar[channel * frames];
+
+                    for (std::uint32_t frame = 0; frame < frames; ++frame)
+                        result[frame * channels + channel] = planarChannel[frame];
+                }
+            }
+
+            // 32-bit samples (float or integer)
+            template <class T>
+            void interleaveStereo32(const T* planar, T* result, std::uint32_t frames)
+            {
+                static_assert(sizeof(T) == 4, "Invalid sample size");
+                std::uint32_t frame = 0;
+
+                if (isSimdAvailable)
+                {
+                    const T* left = planar;
+                    const T* right = planar + frames;
+#if defined(__SSE2__)
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + frame));
+                        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + frame));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + frame * 2), _mm_unpacklo_epi32(l, r));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + frame * 2 + 4), _mm_unpackhi_epi32(l, r));
+                    }
+#elif defined(__ARM_NEON__)
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        uint32x4x2_t samples;
+                        samples.val[0] = vld1q_u32(reinterpret_cast<const std::uint32_t*>(left + frame));
+                        samples.val[1] = vld1q_u32(reinterpret_cast<const std::uint32_t*>(right + frame));
+                        vst2q_u32(reinterpret_cast<std::uint32_t*>(result + frame * 2), samples);
+                    }
+#endif
+                }
+
+                interleave<2>(planar, result, frames, frame);
+            }
+
+            void interleaveStereo(const float* planar, float* result, std::uint32_t frames)
+            {
+                interleaveStereo32(planar, result, frames);
+            }
+
+            void interleaveStereo(const std::int32_t* planar, std::int32_t* result, std::uint32_t frames)
+            {
+                interleaveStereo32(planar, result, frames);
+            }
+
+            void interleaveStereo(const std::int16_t* planar, std::int16_t* result, std::uint32_t frames)
+            {
+                std::uint32_t frame = 0;
+
+                if (isSimdAvailable)
+                {
+                    const std::int16_t* left = planar;
+                    const std::int16_t* right = planar + frames;
+#if defined(__SSE2__)
+                    for (; frame + 8 <= frames; frame += 8)
+                    {
+                        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + frame));
+                        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + frame));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + frame * 2), _mm_unpacklo_epi16(l, r));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + frame * 2 + 8), _mm_unpackhi_epi16(l, r));
+                    }
+#elif defined(__ARM_NEON__)
+                    for (; frame + 8 <= frames; frame += 8)
+                    {
+                        int16x8x2_t samples;
+                        samples.val[0] = vld1q_s16(left + frame);
+                        samples.val[1] = vld1q_s16(right + frame);
+                        vst2q_s16(result + frame * 2, samples);
+                    }
+#endif
+                }
+
+                interleave<2>(planar, result, frames, frame);
+            }
+
+            // 32-bit samples (float or integer), a 4x4 transpose of the first four channels and pairs of the last two
+            template <class T>
+            void interleave6Channels32(const T* planar, T* result, std::uint32_t frames)
+            {
+                static_assert(sizeof(T) == 4, "Invalid sample size");
+                std::uint32_t frame = 0;
+
+                if (isSimdAvailable)
+                {
+#if defined(__SSE2__)
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const float* source = reinterpret_cast<const float*>(planar + frame);
+                        __m128 c0 = _mm_loadu_ps(source);
+                        __m128 c1 = _mm_loadu_ps(source + frames);
+                        __m128 c2 = _mm_loadu_ps(source + frames * 2);
+                        __m128 c3 = _mm_loadu_ps(source + frames * 3);
+                        const __m128 c4 = _mm_loadu_ps(source + frames * 4);
+                        const __m128 c5 = _mm_loadu_ps(source + frames * 5);
+                        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                        const __m128 p0 = _mm_unpacklo_ps(c4, c5);
+                        const __m128 p1 = _mm_unpackhi_ps(c4, c5);
+
+                        float* destination = reinterpret_cast<float*>(result + frame * 6);
+                        _mm_storeu_ps(destination, c0);
+                        _mm_storel_pi(reinterpret_cast<__m64*>(destination + 4), p0);
+                        _mm_storeu_ps(destination + 6, c1);
+                        _mm_storeh_pi(reinterpret_cast<__m64*>(destination + 10), p0);
+                        _mm_storeu_ps(destination + 12, c2);
+                        _mm_storel_pi(reinterpret_cast<__m64*>(destination + 16), p1);
+                        _mm_storeu_ps(destination + 18, c3);
+                        _mm_storeh_pi(reinterpret_cast<__m64*>(destination + 22), p1);
+                    }
+#elif defined(__ARM_NEON__)
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const std::uint32_t* source = reinterpret_cast<const std::uint32_t*>(planar + frame);
+                        const uint32x4x2_t t0 = vtrnq_u32(vld1q_u32(source), vld1q_u32(source + frames));
+                        const uint32x4x2_t t1 = vtrnq_u32(vld1q_u32(source + frames * 2), vld1q_u32(source + frames * 3));
+                        const uint32x4x2_t p = vzipq_u32(vld1q_u32(source + frames * 4), vld1q_u32(source + frames * 5));
+
+                        std::uint32_t* destination = reinterpret_cast<std::uint32_t*>(result + frame * 6);
+                        vst1q_u32(destination, vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0])));
+                        vst1_u32(destination + 4, vget_low_u32(p.val[0]));
+                        vst1q_u32(destination + 6, vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1])));
+                        vst1_u32(destination + 10, vget_high_u32(p.val[0]));
+                        vst1q_u32(destination + 12, vcombine_u32(vget_high_u32(t0.val[0]), vget_high_u32(t1.val[0])));
+                        vst1_u32(destination + 16, vget_low_u32(p.val[1]));
+                        vst1q_u32(destination + 18, vcombine_u32(vget_high_u32(t0.val[1]), vget_high_u32(t1.val[1])));
+                        vst1_u32(destination + 22, vget_high_u32(p.val[1]));
+                    }
+#endif
+                }
+
+                interleave<6>(planar, result, frames, frame);
+            }
+
+            void interleave6Channels(const float* planar, float* result, std::uint32_t frames)
+            {
+                interleave6Channels32(planar, result, frames);
+            }
+
+            void interleave6Channels(const std::int32_t* planar, std::int32_t* result, std::uint32_t frames)
+            {
+                interleave6Channels32(planar, result, frames);
+            }
+
+            void interleave6Channels(const std::int16_t* planar, std::int16_t* result, std::uint32_t frames)
+            {
+                std::uint32_t frame = 0;
+
+                if (isSimdAvailable)
+                {
+#if defined(__SSE2__)
+                    for (; frame + 8 <= frames; frame += 8)
+                    {
+                        __m128i c[6];
+                        for (std::uint32_t channel = 0; channel < 6; ++channel)
+                            c[channel] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planar + channel * frames + frame));
+
+                        // channel pairs of frames 0-3 and 4-7
+                        const __m128i a0 = _mm_unpacklo_epi16(c[0], c[1]);
+                        const __m128i a1 = _mm_unpackhi_epi16(c[0], c[1]);
+                        const __m128i a2 = _mm_unpacklo_epi16(c[2], c[3]);
+                        const __m128i a3 = _mm_unpackhi_epi16(c[2], c[3]);
+                        __m128i pairs[2] = {_mm_unpacklo_epi16(c[4], c[5]), _mm_unpackhi_epi16(c[4], c[5])};
+
+                        // the first four channels of two frames each
+                        const __m128i quads[4] = {
+                            _mm_unpacklo_epi32(a0, a2),
+                            _mm_unpackhi_epi32(a0, a2),
+                            _mm_unpacklo_epi32(a1, a3),
+                            _mm_unpackhi_epi32(a1, a3)
+                        };
+
+                        std::int16_t* destination = result + frame * 6;
+                        for (std::uint32_t i = 0; i < 4; ++i)
+                        {
+                            _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i * 12), quads[i]);
+                            _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i * 12 + 6), _mm_unpackhi_epi64(quads[i], quads[i]));
+                        }
+
+                        for (std::uint32_t i = 0; i < 8; ++i)
+                        {
+                            const std::int32_t pair = _mm_cvtsi128_si32(pairs[i / 4]);
+                            std::memcpy(destination + i * 6 + 4, &pair, sizeof(pair));
+                            pairs[i / 4] = _mm_srli_si128(pairs[i / 4], 4);
+                        }
+                    }
+#elif defined(__ARM_NEON__)
+                    // channel pairs are 32-bit units, so three of them are interleaved with vst3
+                    for (; frame + 8 <= frames; frame += 8)
+                    {
+                        const std::int16_t* source = planar + frame;
+                        const int16x8x2_t p0 = vzipq_s16(vld1q_s16(source), vld1q_s16(source + frames));
+                        const int16x8x2_t p1 = vzipq_s16(vld1q_s16(source + frames * 2), vld1q_s16(source + frames * 3));
+                        const int16x8x2_t p2 = vzipq_s16(vld1q_s16(source + frames * 4), vld1q_s16(source + frames * 5));
+
+                        std::uint32_t* destination = reinterpret_cast<std::uint32_t*>(result + frame * 6);
+                        for (std::uint32_t half = 0; half < 2; ++half)
+                        {
+                            uint32x4x3_t samples;
+                            samples.val[0] = vreinterpretq_u32_s16(p0.val[half]);
+                            samples.val[1] = vreinterpretq_u32_s16(p1.val[half]);
+                            samples.val[2] = vreinterpretq_u32_s16(p2.val[half]);
+                            vst3q_u32(destination + half * 12, samples);
+                        }
+                    }
+#endif
+                }
+
+                interleave<6>(planar, result, frames, frame);
+            }
+
+            // 32-bit samples (float or integer), two 4x4 transposes per 4 frames
+            template <class T>
+            void interleave8Channels32(const T* planar, T* result, std::uint32_t frames)
+            {
+                static_assert(sizeof(T) == 4, "Invalid sample size");
+                std::uint32_t frame = 0;
+
+#if defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        for (std::uint32_t half = 0; half < 2; ++half)
+                        {
+                            const T* source = planar + half * 4 * frames + frame;
+                            __m128 c0 = _mm_loadu_ps(reinterpret_cast<const float*>(source));
+                            __m128 c1 = _mm_loadu_ps(reinterpret_cast<const float*>(source + frames));
+                            __m128 c2 = _mm_loadu_ps(reinterpret_cast<const float*>(source + frames * 2));
+                            __m128 c3 = _mm_loadu_ps(reinterpret_cast<const float*>(source + frames * 3));
+                            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+                            float* destination = reinterpret_cast<float*>(result + frame * 8 + half * 4);
+                            _mm_storeu_ps(destination, c0);
+                            _mm_storeu_ps(destination + 8, c1);
+                            _mm_storeu_ps(destination + 16, c2);
+                            _mm_storeu_ps(destination + 24, c3);
+                        }
+                    }
+                }
+#elif defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        for (std::uint32_t half = 0; half < 2; ++half)
+                        {
+                            const std::uint32_t* source = reinterpret_cast<const std::uint32_t*>(planar + half * 4 * frames + frame);
+                            const uint32x4x2_t t0 = vtrnq_u32(vld1q_u32(source), vld1q_u32(source + frames));
+                            const uint32x4x2_t t1 = vtrnq_u32(vld1q_u32(source + frames * 2), vld1q_u32(source + frames * 3));
+
+                            std::uint32_t* destination = reinterpret_cast<std::uint32_t*>(result + frame * 8 + half * 4);
+                            vst1q_u32(destination, vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0])));
+                            vst1q_u32(destination + 8, vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1])));
+                            vst1q_u32(destination + 16, vcombine_u32(vget_high_u32(t0.val[0]), vget_high_u32(t1.val[0])));
+                            vst1q_u32(destination + 24, vcombine_u32(vget_high_u32(t0.val[1]), vget_high_u32(t1.val[1])));
+                        }
+                    }
+                }
+#endif
+
+                interleave<8>(planar, result, frames, frame);
+            }
+
+            void interleave8Channels(const float* planar, float* result, std::uint32_t frames)
+            {
+                interleave8Channels32(planar, result, frames);
+            }
+
+            void interleave8Channels(const std::int32_t* planar, std::int32_t* result, std::uint32_t frames)
+            {
+                interleave8Channels32(planar, result, frames);
+            }
+
+            void interleave8Channels(const std::int16_t* planar, std::int16_t* result, std::uint32_t frames)
+            {
+                std::uint32_t frame = 0;
+
+#if defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    // 8x8 transpose of 16-bit samples
+                    for (; frame + 8 <= frames; frame += 8)
+                    {
+                        __m128i c[8];
+                        for (std::uint32_t channel = 0; channel < 8; ++channel)
+                            c[channel] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planar + channel * frames + frame));
+
+                        const __m128i a0 = _mm_unpacklo_epi16(c[0], c[1]);
+                        const __m128i a1 = _mm_unpackhi_epi16(c[0], c[1]);
+                        const __m128i a2 = _mm_unpacklo_epi16(c[2], c[3]);
+                        const __m128i a3 = _mm_unpackhi_epi16(c[2], c[3]);
+                        const __m128i a4 = _mm_unpacklo_epi16(c[4], c[5]);
+                        const __m128i a5 = _mm_unpackhi_epi16(c[4], c[5]);
+                        const __m128i a6 = _mm_unpacklo_epi16(c[6], c[7]);
+                        const __m128i a7 = _mm_unpackhi_epi16(c[6], c[7]);
+
+                        const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+                        const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+                        const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+                        const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+                        const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+                        const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+                        const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+                        const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+                        __m128i* destination = reinterpret_cast<__m128i*>(result + frame * 8);
+                        _mm_storeu_si128(destination + 0, _mm_unpacklo_epi64(b0, b4));
+                        _mm_storeu_si128(destination + 1, _mm_unpackhi_epi64(b0, b4));
+                        _mm_storeu_si128(destination + 2, _mm_unpacklo_epi64(b1, b5));
+                        _mm_storeu_si128(destination + 3, _mm_unpackhi_epi64(b1, b5));
+                        _mm_storeu_si128(destination + 4, _mm_unpacklo_epi64(b2, b6));
+                        _mm_storeu_si128(destination + 5, _mm_unpackhi_epi64(b2, b6));
+                        _mm_storeu_si128(destination + 6, _mm_unpacklo_epi64(b3, b7));
+                        _mm_storeu_si128(destination + 7, _mm_unpackhi_epi64(b3, b7));
+                    }
+                }
+#elif defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    // 8x8 transpose of 16-bit samples, same steps as the SSE2 version
+                    for (; frame + 8 <= frames; frame += 8)
+                    {
+                        int16x8_t c[8];
+                        for (std::uint32_t channel = 0; channel < 8; ++channel)
+                            c[channel] = vld1q_s16(planar + channel * frames + frame);
+
+                        const int16x8x2_t a01 = vzipq_s16(c[0], c[1]);
+                        const int16x8x2_t a23 = vzipq_s16(c[2], c[3]);
+                        const int16x8x2_t a45 = vzipq_s16(c[4], c[5]);
+                        const int16x8x2_t a67 = vzipq_s16(c[6], c[7]);
+
+                        const int32x4x2_t b01 = vzipq_s32(vreinterpretq_s32_s16(a01.val[0]), vreinterpretq_s32_s16(a23.val[0]));
+                        const int32x4x2_t b23 = vzipq_s32(vreinterpretq_s32_s16(a01.val[1]), vreinterpretq_s32_s16(a23.val[1]));
+                        const int32x4x2_t b45 = vzipq_s32(vreinterpretq_s32_s16(a45.val[0]), vreinterpretq_s32_s16(a67.val[0]));
+                        const int32x4x2_t b67 = vzipq_s32(vreinterpretq_s32_s16(a45.val[1]), vreinterpretq_s32_s16(a67.val[1]));
+
+                        const int32x4_t b[8] = {b01.val[0], b01.val[1], b23.val[0], b23.val[1],
+                                                b45.val[0], b45.val[1], b67.val[0], b67.val[1]};
+
+                        std::int32_t* destination = reinterpret_cast<std::int32_t*>(result + frame * 8);
+                        for (std::uint32_t i = 0; i < 4; ++i)
+                        {
+                            vst1q_s32(destination + i * 8, vcombine_s32(vget_low_s32(b[i]), vget_low_s32(b[i + 4])));
+                            vst1q_s32(destination + i * 8 + 4, vcombine_s32(vget_high_s32(b[i]), vget_high_s32(b[i + 4])));
+                        }
+                    }
+                }
+#endif
+
+                interleave<8>(planar, result, frames, frame);
+            }
+
+            template <class T>
+            void interleaveSamples(const T* planar, T* result, std::uint32_t frames, std::uint32_t channels)
+            {
+                switch (channels)
+                {
+                    case 1: std::copy(planar, planar + frames, result); break;
+                    case 2: interleaveStereo(planar, result, frames); break;
+                    case 6: interleave6Channels(planar, result, frames); break;
+                    case 8: interleave8Channels(planar, result, frames); break;
+                    default: interleave(planar, result, frames, channels); break;
+                }
+            }
+        }
+
         AudioDevice::AudioDevice(Driver initDriver,
                                  std::uint32_t initBufferSize,
                                  std::uint32_t initSampleRate,
@@ -22,38 +605,51 @@ namespace ouzel
         {
         }
 
+        std::uint32_t AudioDevice::getSampleSize() const
+        {
+            switch (sampleFormat)
+            {
+                case SampleFormat::SignedInt16: return sizeof(std::int16_t);
+                case SampleFormat::SignedInt24: return sizeof(std::int32_t);
+                case SampleFormat::SignedInt32: return sizeof(std::int32_t);
+                case SampleFormat::Float32: return sizeof(float);
+                default: throw std::runtime_error("Invalid sample format");
+            }
+        }
+
         void AudioDevice::getData(std::uint32_t frames, std::vector<std::uint8_t>& result)
+        {
+            result.resize(frames * channels * getSampleSize());
+            getData(frames, result.data());
+        }
+
+        void AudioDevice::getData(std::uint32_t frames, void* result)
         {
             dataGetter(frames, channels, sampleRate, buffer);
 
+            const std::size_t sampleCount = frames * channels;
+
             switch (sampleFormat)
             {
                 case SampleFormat::SignedInt16:
                 {
-                    result.resize(frames * channels * sizeof(std::int16_t));
-                    std::int16_t* resultPtr = reinterpret_cast<std::int16_t*>(result.data());
-
-                    for (std::uint32_t channel = 0; channel < channels; ++channel)
-                    {
-                        float* bufferChannel = &buffer[channel * frames];
-
-                        for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            resultPtr[frame * channels + channel] = static_cast<std::int16_t>(bufferChannel[frame] * 32767.0F);
-                    }
+                    int16Buffer.resize(sampleCount);
+                    convert(buffer.data(), int16Buffer.data(), sampleCount, ditherEnabled ? ditherState : nullptr);
+                    interleaveSamples(int16Buffer.data(), static_cast<std::int16_t*>(result), frames, channels);
+                    break;
+                }
+                case SampleFormat::SignedInt24:
+                case SampleFormat::SignedInt32:
+                {
+                    int32Buffer.resize(sampleCount);
+                    convert(buffer.data(), int32Buffer.data(), sampleCount,
+                            (sampleFormat == SampleFormat::SignedInt24) ? INT24_SCALE : INT32_SCALE);
+                    interleaveSamples(int32Buffer.data(), static_cast<std::int32_t*>(result), frames, channels);
                     break;
                 }
                 case SampleFormat::Float32:
                 {
-                    result.resize(frames * channels * sizeof(float));
-                    float* resultPtr = reinterpret_cast<float*>(result.data());
-
-                    for (std::uint32_t channel = 0; channel < channels; ++channel)
-                    {
-                        float* bufferChannel = &buffer[channel * frames];
-
-                        for (std::uint32_t frame = 0; frame < frames; ++frame)
-                            resultPtr[frame * channels + channel] = bufferChannel[frame];
-                    }
+                    interleaveSamples(buffer.data(), static_cast<float*>(result), frames, channels);
                     break;
                 }
                 default:
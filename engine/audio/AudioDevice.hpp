@@ -3,6 +3,8 @@
 #ifndef OUZEL_AUDIO_AUDIODEVICE_HPP
 #define OUZEL_AUDIO_AUDIODEVICE_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include "audio/Driver.hpp"
@@ -38,6 +40,11 @@ namespace ouzel
             inline auto getBufferSize() const noexcept { return bufferSize; }
             inline auto getSampleRate() const noexcept { return sampleRate; }
             inline auto getChannels() const noexcept { return channels; }
+            inline auto getSampleFormat() const noexcept { return sampleFormat; }
+
+            // TPDF dither applied when converting to 16-bit samples
+            inline bool isDitherEnabled() const noexcept { return ditherEnabled; }
+            inline void setDitherEnabled(bool newDitherEnabled) noexcept { ditherEnabled = newDitherEnabled; }
 
             virtual void start() = 0;
             virtual void stop() = 0;
@@ -47,6 +54,8 @@ namespace ouzel
 
         protected:
             void getData(std::uint32_t frames, std::vector<std::uint8_t>& result);
+            void getData(std::uint32_t frames, void* result); // result must hold frames * channels samples
+            std::uint32_t getSampleSize() const;
 
             std::uint16_t apiMajorVersion = 0;
             std::uint16_t apiMinorVersion = 0;
@@ -59,6 +68,10 @@ namespace ouzel
         private:
             std::function<void(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate, std::vector<float>& samples)> dataGetter;
             std::vector<float> buffer;
+            std::vector<std::int16_t> int16Buffer;
+            std::vector<std::int32_t> int32Buffer;
+            std::atomic_bool ditherEnabled{false};
+            std::uint32_t ditherState[4] = {0x12345678U, 0x9ABCDEF1U, 0x23456789U, 0xABCDEF12U};
         };
     } // namespace audio
 } // namespace ouzel
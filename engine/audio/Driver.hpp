@@ -16,7 +16,8 @@ namespace ouzel
             OpenSL,
             CoreAudio,
             ALSA,
-            WASAPI
+            WASAPI,
+            Offline
         };
     } // namespace audio
 } // namespace ouzel
@@ -10,6 +10,8 @@ namespace ouzel
         enum class SampleFormat
         {
             SignedInt16,
+            SignedInt24, // 24-bit samples in the low bytes of a 32-bit container
+            SignedInt32,
             Float32
         };
     } // namespace audio
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_ALSA
 
+#include <chrono>
 #include <system_error>
 #include "ALSAAudioDevice.hpp"
 #include "core/Engine.hpp"
@@ -36,7 +37,15 @@ namespace ouzel
                 if ((result = snd_pcm_hw_params_any(playbackHandle, hwParams)) < 0)
                     throw std::system_error(result, std::system_category(), "Failed to initialize hardware parameters");
 
-                if ((result = snd_pcm_hw_params_set_access(playbackHandle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0)
+                // write directly to the device buffer if possible
+                if (snd_pcm_hw_params_test_access(playbackHandle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0)
+                {
+                    if ((result = snd_pcm_hw_params_set_access(playbackHandle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED)) < 0)
+                        throw std::system_error(result, std::system_category(), "Failed to set access type");
+
+                    mmapAccess = true;
+                }
+                else if ((result = snd_pcm_hw_params_set_access(playbackHandle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0)
                     throw std::system_error(result, std::system_category(), "Failed to set access type");
 
                 if (snd_pcm_hw_params_test_format(playbackHandle, hwParams, SND_PCM_FORMAT_FLOAT_LE) == 0)
@@ -46,6 +55,20 @@ namespace ouzel
 
                     sampleFormat = SampleFormat::Float32;
                 }
+                else if (snd_pcm_hw_params_test_format(playbackHandle, hwParams, SND_PCM_FORMAT_S32_LE) == 0)
+                {
+                    if ((result = snd_pcm_hw_params_set_format(playbackHandle, hwParams, SND_PCM_FORMAT_S32_LE)) < 0)
+                        throw std::system_error(result, std::system_category(), "Failed to set sample format");
+
+                    sampleFormat = SampleFormat::SignedInt32;
+                }
+                else if (snd_pcm_hw_params_test_format(playbackHandle, hwParams, SND_PCM_FORMAT_S24_LE) == 0)
+                {
+                    if ((result = snd_pcm_hw_params_set_format(playbackHandle, hwParams, SND_PCM_FORMAT_S24_LE)) < 0)
+                        throw std::system_error(result, std::system_category(), "Failed to set sample format");
+
+                    sampleFormat = SampleFormat::SignedInt24;
+                }
                 else if (snd_pcm_hw_params_test_format(playbackHandle, hwParams, SND_PCM_FORMAT_S16_LE) == 0)
                 {
                     if ((result = snd_pcm_hw_params_set_format(playbackHandle, hwParams, SND_PCM_FORMAT_S16_LE)) < 0)
@@ -90,7 +113,8 @@ namespace ouzel
                 if ((result = snd_pcm_sw_params_current(playbackHandle, swParams)) < 0)
                     throw std::system_error(result, std::system_category(), "Failed to initialize software parameters");
 
-                if ((result = snd_pcm_sw_params_set_avail_min(playbackHandle, swParams, 4096)) < 0)
+                // wake up the audio thread once per period
+                if ((result = snd_pcm_sw_params_set_avail_min(playbackHandle, swParams, periodSize)) < 0)
                     throw std::system_error(result, std::system_category(), "Failed to set minimum available count");
 
                 if ((result = snd_pcm_sw_params_set_start_threshold(playbackHandle, swParams, 0)) < 0)
@@ -104,6 +128,13 @@ namespace ouzel
 
                 snd_pcm_sw_params_free(swParams);
                 swParams = nullptr;
+
+                // wait at most two periods so that stop requests are not delayed
+                waitTimeout = static_cast<int>(2 * periodSize * 1000 / sampleRate);
+                if (waitTimeout < 10) waitTimeout = 10;
+
+                engine->log(Log::Level::Info) << "ALSA period size " << periodSize << ", periods " << periods <<
+                    (mmapAccess ? ", using mmap access" : ", using read/write access");
             }
 
             AudioDevice::~AudioDevice()
@@ -136,23 +167,12 @@ namespace ouzel
                 {
                     try
                     {
-                        int result;
-
                         snd_pcm_sframes_t frames;
 
                         if ((frames = snd_pcm_avail_update(playbackHandle)) < 0)
                         {
-                            if (frames == -EPIPE)
-                            {
-                                engine->log(Log::Level::Warning) << "Buffer underrun occurred";
-
-                                if ((result = snd_pcm_prepare(playbackHandle)) < 0)
-                                    throw std::system_error(result, std::system_category(), "Failed to prepare audio interface");
-
-                                continue;
-                            }
-                            else
-                                throw std::system_error(frames, std::system_category(), "Failed to get available frames");
+                            recover(static_cast<int>(frames));
+                            continue;
                         }
 
                         if (static_cast<snd_pcm_uframes_t>(frames) > periods * periodSize)
@@ -163,22 +183,32 @@ namespace ouzel
                         }
 
                         if (static_cast<snd_pcm_uframes_t>(frames) < periodSize)
+                        {
+                            // block until a period is free instead of spinning
+                            int result;
+                            if ((result = snd_pcm_wait(playbackHandle, waitTimeout)) < 0)
+                                recover(result);
+
                             continue;
+                        }
 
-                        getData(frames, data);
+                        // only write whole periods
+                        const auto writeFrames = static_cast<snd_pcm_uframes_t>(frames) / periodSize * periodSize;
 
-                        if ((result = snd_pcm_writei(playbackHandle, data.data(), frames)) < 0)
-                        {
-                            if (result == -EPIPE)
-                            {
-                                engine->log(Log::Level::Warning) << "Buffer underrun occurred";
-
-                                if ((result = snd_pcm_prepare(playbackHandle)) < 0)
-                                    throw std::system_error(result, std::system_category(), "Failed to prepare audio interface");
-                            }
-                            else
-                                throw std::system_error(result, std::system_category(), "Failed to write data");
-                        }
+                        const auto callbackStart = std::chrono::steady_clock::now();
+
+                        if (mmapAccess)
+                            writeMmap(writeFrames);
+                        else
+                            writeInterleaved(writeFrames);
+
+                        const auto duration = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - callbackStart).count());
+                        callbackDuration = duration;
+                        if (duration > maxCallbackDuration) maxCallbackDuration = duration;
+
+                        snd_pcm_sframes_t delay;
+                        if (snd_pcm_delay(playbackHandle, &delay) == 0 && delay >= 0)
+                            latency = static_cast<std::uint32_t>(delay);
                     }
                     catch (const std::exception& e)
                     {
@@ -186,6 +216,83 @@ namespace ouzel
                     }
                 }
             }
+
+            void AudioDevice::recover(int error)
+            {
+                if (error == -EPIPE)
+                {
+                    ++xrunCount;
+                    engine->log(Log::Level::Warning) << "Buffer underrun occurred";
+                }
+
+                // handles underruns (EPIPE), suspends (ESTRPIPE) and interrupts (EINTR)
+                int result;
+                if ((result = snd_pcm_recover(playbackHandle, error, 1)) < 0)
+                    throw std::system_error(result, std::system_category(), "Failed to recover audio interface");
+            }
+
+            void AudioDevice::writeMmap(snd_pcm_uframes_t frames)
+            {
+                while (frames > 0)
+                {
+                    const snd_pcm_channel_area_t* areas;
+                    snd_pcm_uframes_t offset;
+                    snd_pcm_uframes_t count = frames;
+
+                    int result;
+                    if ((result = snd_pcm_mmap_begin(playbackHandle, &areas, &offset, &count)) < 0)
+                    {
+                        recover(result);
+                        return;
+                    }
+
+                    // interleaved access, so all the channels are in the first area
+                    auto destination = static_cast<std::uint8_t*>(areas[0].addr) + areas[0].first / 8 + offset * areas[0].step / 8;
+                    getData(static_cast<std::uint32_t>(count), destination);
+
+                    const snd_pcm_sframes_t committed = snd_pcm_mmap_commit(playbackHandle, offset, count);
+                    if (committed < 0)
+                    {
+                        recover(static_cast<int>(committed));
+                        return;
+                    }
+                    else if (static_cast<snd_pcm_uframes_t>(committed) != count)
+                    {
+                        recover(-EPIPE);
+                        return;
+                    }
+
+                    frames -= count;
+                }
+
+                if (snd_pcm_state(playbackHandle) == SND_PCM_STATE_PREPARED)
+                {
+                    int result;
+                    if ((result = snd_pcm_start(playbackHandle)) < 0)
+                        recover(result);
+                }
+            }
+
+            void AudioDevice::writeInterleaved(snd_pcm_uframes_t frames)
+            {
+                getData(static_cast<std::uint32_t>(frames), data);
+
+                const auto frameSize = getSampleSize() * channels;
+                std::size_t offset = 0;
+
+                while (frames > 0)
+                {
+                    const snd_pcm_sframes_t written = snd_pcm_writei(playbackHandle, data.data() + offset, frames);
+                    if (written < 0)
+                    {
+                        recover(static_cast<int>(written));
+                        return;
+                    }
+
+                    frames -= static_cast<snd_pcm_uframes_t>(written);
+                    offset += static_cast<std::size_t>(written) * frameSize;
+                }
+            }
         } // namespace alsa
     } // namespace audio
 } // namespace ouzel
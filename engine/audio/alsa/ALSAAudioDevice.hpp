@@ -35,8 +35,21 @@ namespace ouzel
                 void start() final;
                 void stop() final;
 
+                inline auto isMmapAccess() const noexcept { return mmapAccess; }
+
+                // number of buffer underruns since the device was created
+                inline std::uint32_t getXrunCount() const noexcept { return xrunCount; }
+                // time it took to produce the last period (in microseconds)
+                inline std::uint32_t getCallbackDuration() const noexcept { return callbackDuration; }
+                inline std::uint32_t getMaxCallbackDuration() const noexcept { return maxCallbackDuration; }
+                // number of frames queued in the device before the last written period is played
+                inline std::uint32_t getLatency() const noexcept { return latency; }
+
             private:
                 void run();
+                void recover(int error);
+                void writeMmap(snd_pcm_uframes_t frames);
+                void writeInterleaved(snd_pcm_uframes_t frames);
 
                 snd_pcm_t* playbackHandle = nullptr;
                 snd_pcm_hw_params_t* hwParams = nullptr;
@@ -44,9 +57,16 @@ namespace ouzel
 
                 unsigned int periods = 4;
                 snd_pcm_uframes_t periodSize = 1024;
+                bool mmapAccess = false;
+                int waitTimeout = 100; // in milliseconds
 
                 std::vector<std::uint8_t> data;
 
+                std::atomic<std::uint32_t> xrunCount{0};
+                std::atomic<std::uint32_t> callbackDuration{0};
+                std::atomic<std::uint32_t> maxCallbackDuration{0};
+                std::atomic<std::uint32_t> latency{0};
+
                 std::atomic_bool running{false};
                 Thread audioThread;
             };
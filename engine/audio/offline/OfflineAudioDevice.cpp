@@ -0,0 +1,291 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include "OfflineAudioDevice.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace offline
+        {
+            namespace
+            {
+                constexpr std::uint16_t WAVE_FORMAT_PCM = 1;
+                constexpr std::uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+                constexpr std::uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+                constexpr std::uint32_t WAVE_HEADER_SIZE = 44;
+                constexpr std::uint32_t WAVE_EXTENSIBLE_HEADER_SIZE = 68;
+
+                // the GUID of the sub format is the format tag followed by these bytes
+                constexpr std::uint8_t SUBTYPE_GUID_TAIL[14] = {
+                    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+                };
+
+                void encodeLittleEndian(std::uint8_t* buffer, std::uint32_t value, std::uint32_t size) noexcept
+                {
+                    for (std::uint32_t i = 0; i < size; ++i)
+                        buffer[i] = static_cast<std::uint8_t>(value >> (i * 8));
+                }
+
+                // same speaker layouts as the OpenSL ES device, zero leaves the channels unassigned
+                std::uint32_t getChannelMask(std::uint32_t channels) noexcept
+                {
+                    switch (channels)
+                    {
+                        case 1: return 0x004; // front center
+                        case 2: return 0x003; // front left and right
+                        case 4: return 0x033; // front and back left and right
+                        case 6: return 0x60F; // 5.1 with side speakers
+                        case 7: return 0x70F; // 6.1
+                        case 8: return 0x63F; // 7.1
+                        default: return 0;
+                    }
+                }
+
+                // size of a sample in the WAV file (24-bit samples are packed)
+                std::uint32_t getFileSampleSize(SampleFormat sampleFormat)
+                {
+                    switch (sampleFormat)
+                    {
+                        case SampleFormat::SignedInt16: return 2;
+                        case SampleFormat::SignedInt24: return 3;
+                        case SampleFormat::SignedInt32: return 4;
+                        case SampleFormat::Float32: return 4;
+                        default: throw std::runtime_error("Invalid sample format");
+                    }
+                }
+
+                // more than two channels and integer samples wider than 16 bits require the extensible format
+                bool isExtensible(SampleFormat sampleFormat, std::uint32_t channels)
+                {
+                    return channels > 2 ||
+                        (sampleFormat != SampleFormat::Float32 && getFileSampleSize(sampleFormat) > 2);
+                }
+
+                std::vector<std::uint8_t> encodeHeader(SampleFormat sampleFormat,
+                                                       std::uint32_t channels,
+                                                       std::uint32_t sampleRate,
+                                                       std::uint32_t dataSize)
+                {
+                    const std::uint32_t sampleSize = getFileSampleSize(sampleFormat);
+                    const std::uint16_t formatTag = (sampleFormat == SampleFormat::Float32) ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
+                    const bool extensible = isExtensible(sampleFormat, channels);
+
+                    std::vector<std::uint8_t> header(extensible ? WAVE_EXTENSIBLE_HEADER_SIZE : WAVE_HEADER_SIZE);
+                    const std::uint32_t formatSize = static_cast<std::uint32_t>(header.size()) - 28;
+                    const std::uint32_t paddedDataSize = dataSize + (dataSize & 1);
+
+                    std::uint8_t* data = header.data();
+                    std::copy_n("RIFF", 4, data);
+                    encodeLittleEndian(data + 4, static_cast<std::uint32_t>(header.size()) - 8 + paddedDataSize, 4);
+                    std::copy_n("WAVEfmt ", 8, data + 8);
+                    encodeLittleEndian(data + 16, formatSize, 4);
+                    encodeLittleEndian(data + 20, extensible ? WAVE_FORMAT_EXTENSIBLE : formatTag, 2);
+                    encodeLittleEndian(data + 22, channels, 2);
+                    encodeLittleEndian(data + 24, sampleRate, 4);
+                    encodeLittleEndian(data + 28, sampleRate * channels * sampleSize, 4); // byte rate
+                    encodeLittleEndian(data + 32, channels * sampleSize, 2); // block align
+                    encodeLittleEndian(data + 34, sampleSize * 8, 2); // bits per sample
+                    data += 36;
+
+                    if (extensible)
+                    {
+                        encodeLittleEndian(data, 22, 2); // size of the extension
+                        encodeLittleEndian(data + 2, sampleSize * 8, 2); // valid bits per sample
+                        encodeLittleEndian(data + 4, getChannelMask(channels), 4);
+                        encodeLittleEndian(data + 8, formatTag, 2);
+                        std::copy(std::begin(SUBTYPE_GUID_TAIL), std::end(SUBTYPE_GUID_TAIL), data + 10);
+                        data += 24;
+                    }
+
+                    std::copy_n("data", 4, data);
+                    encodeLittleEndian(data + 4, dataSize, 4);
+
+                    return header;
+                }
+            }
+
+            AudioDevice::AudioDevice(std::uint32_t initBufferSize,
+                                     std::uint32_t initSampleRate,
+                                     std::uint32_t initChannels,
+                                     const std::function<void(std::uint32_t frames,
+                                                              std::uint32_t channels,
+                                                              std::uint32_t sampleRate,
+                                                              std::vector<float>& samples)>& initDataGetter):
+                audio::AudioDevice(Driver::Offline, initBufferSize, initSampleRate, initChannels, initDataGetter)
+            {
+                sampleFormat = SampleFormat::Float32;
+            }
+
+            AudioDevice::~AudioDevice()
+            {
+                running = false;
+                if (renderThread.isJoinable()) renderThread.join();
+
+                closeOutputFile();
+            }
+
+            void AudioDevice::start()
+            {
+                started = true;
+
+                if (mode != Mode::Manual && !running)
+                {
+                    running = true;
+                    renderThread = Thread(&AudioDevice::run, this);
+                }
+            }
+
+            void AudioDevice::stop()
+            {
+                started = false;
+                running = false;
+                if (renderThread.isJoinable()) renderThread.join();
+            }
+
+            void AudioDevice::setMode(Mode newMode)
+            {
+                const bool wasStarted = started;
+                stop();
+                mode = newMode;
+                if (wasStarted) start();
+            }
+
+            void AudioDevice::setSampleFormat(SampleFormat newSampleFormat)
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+
+                if (outputFile.is_open())
+                    throw std::runtime_error("Sample format can not be changed while writing to a file");
+
+                getFileSampleSize(newSampleFormat); // validate the format
+                sampleFormat = newSampleFormat;
+                capturedData.clear();
+            }
+
+            void AudioDevice::render(std::uint32_t frames)
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+
+                getData(frames, data);
+
+                if (captureEnabled)
+                    capturedData.insert(capturedData.end(), data.begin(), data.end());
+
+                if (outputFile.is_open())
+                {
+                    if (sampleFormat == SampleFormat::SignedInt24)
+                    {
+                        // pack the 32-bit containers into 3 bytes
+                        std::size_t packedSize = 0;
+                        for (std::size_t i = 0; i + 4 <= data.size(); i += 4)
+                        {
+                            data[packedSize++] = data[i];
+                            data[packedSize++] = data[i + 1];
+                            data[packedSize++] = data[i + 2];
+                        }
+                        data.resize(packedSize);
+                    }
+
+                    // the RIFF sizes are 32-bit, so the file is finished before the next buffer would overflow them
+                    const std::uint64_t headerSize = isExtensible(sampleFormat, channels) ? WAVE_EXTENSIBLE_HEADER_SIZE : WAVE_HEADER_SIZE;
+                    if (headerSize - 8 + outputDataSize + data.size() + 1 > std::numeric_limits<std::uint32_t>::max())
+                    {
+                        closeOutputFile();
+                        throw std::runtime_error("WAV file size limit reached, closing the output file");
+                    }
+
+                    outputFile.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+                    outputDataSize += static_cast<std::uint32_t>(data.size());
+                }
+
+                renderedFrames += frames;
+            }
+
+            void AudioDevice::setCaptureEnabled(bool newCaptureEnabled)
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+                captureEnabled = newCaptureEnabled;
+            }
+
+            std::vector<std::uint8_t> AudioDevice::getCapturedData()
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+                return capturedData;
+            }
+
+            void AudioDevice::clearCapturedData()
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+                capturedData.clear();
+            }
+
+            void AudioDevice::setOutputFile(const std::string& filename)
+            {
+                std::unique_lock<std::mutex> lock(renderMutex);
+
+                closeOutputFile();
+
+                if (filename.empty()) return;
+
+                outputFile.open(filename, std::ios::binary | std::ios::trunc);
+                if (!outputFile)
+                    throw std::runtime_error("Failed to open file " + filename);
+
+                // the sizes are patched when the file is closed
+                const std::vector<std::uint8_t> header = encodeHeader(sampleFormat, channels, sampleRate, 0);
+                outputFile.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+                outputDataSize = 0;
+
+                engine->log(Log::Level::Info) << "Writing audio to " << filename;
+            }
+
+            void AudioDevice::closeOutputFile()
+            {
+                if (!outputFile.is_open()) return;
+
+                // chunks are padded to an even size
+                if (outputDataSize & 1) outputFile.put(0);
+
+                const std::vector<std::uint8_t> header = encodeHeader(sampleFormat, channels, sampleRate, outputDataSize);
+                outputFile.seekp(0);
+                outputFile.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+                outputFile.close();
+            }
+
+            void AudioDevice::run()
+            {
+                Thread::setCurrentThreadName("Audio");
+
+                const std::chrono::microseconds bufferDuration(static_cast<std::uint64_t>(bufferSize) * 1000000U / sampleRate);
+                auto nextRenderTime = std::chrono::steady_clock::now();
+
+                while (running)
+                {
+                    try
+                    {
+                        render(bufferSize);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        engine->log(Log::Level::Error) << e.what();
+                    }
+
+                    if (mode == Mode::Realtime)
+                    {
+                        nextRenderTime += bufferDuration;
+                        std::this_thread::sleep_until(nextRenderTime);
+                    }
+                }
+            }
+        } // namespace offline
+    } // namespace audio
+} // namespace ouzel
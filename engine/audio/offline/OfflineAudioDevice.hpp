@@ -0,0 +1,84 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
+#define OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "audio/AudioDevice.hpp"
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace offline
+        {
+            // Renders the mix without audio hardware into memory and/or a WAV file
+            class AudioDevice final: public audio::AudioDevice
+            {
+            public:
+                enum class Mode
+                {
+                    Realtime, // render one buffer every buffer duration of wall clock time
+                    Unthrottled, // render as fast as possible
+                    Manual // render only when render() is called (deterministic)
+                };
+
+                AudioDevice(std::uint32_t initBufferSize,
+                            std::uint32_t initSampleRate,
+                            std::uint32_t initChannels,
+                            const std::function<void(std::uint32_t frames,
+                                                     std::uint32_t channels,
+                                                     std::uint32_t sampleRate,
+                                                     std::vector<float>& samples)>& initDataGetter);
+                ~AudioDevice() override;
+
+                void start() final;
+                void stop() final;
+
+                inline auto getMode() const noexcept { return mode; }
+                void setMode(Mode newMode);
+
+                void setSampleFormat(SampleFormat newSampleFormat);
+
+                // renders the given number of frames on the calling thread
+                void render(std::uint32_t frames);
+                inline std::uint64_t getRenderedFrames() const noexcept { return renderedFrames; }
+
+                // interleaved samples in the device sample format
+                inline bool isCaptureEnabled() const noexcept { return captureEnabled; }
+                void setCaptureEnabled(bool newCaptureEnabled);
+                std::vector<std::uint8_t> getCapturedData();
+                void clearCapturedData();
+
+                // streams everything that is rendered from now on to a WAV file, empty filename closes the file
+                void setOutputFile(const std::string& filename);
+
+            private:
+                void run();
+                void closeOutputFile();
+
+                Mode mode = Mode::Realtime;
+
+                std::mutex renderMutex;
+                std::vector<std::uint8_t> data;
+                bool captureEnabled = false;
+                std::vector<std::uint8_t> capturedData;
+                std::ofstream outputFile;
+                std::uint32_t outputDataSize = 0;
+                std::atomic<std::uint64_t> renderedFrames{0};
+
+                std::atomic_bool started{false};
+                std::atomic_bool running{false};
+                Thread renderThread;
+            };
+        } // namespace offline
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
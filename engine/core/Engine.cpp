@@ -22,6 +22,7 @@
 #    include "opengl/ColorVSGLES3.h"
 #    include "opengl/TexturePSGLES3.h"
 #    include "opengl/TextureVSGLES3.h"
+#    include "opengl/TextureInstancedVSGLES3.h"
 #  else
 #    include "opengl/ColorPSGL2.h"
 #    include "opengl/ColorVSGL2.h"
@@ -31,10 +32,12 @@
 #    include "opengl/ColorVSGL3.h"
 #    include "opengl/TexturePSGL3.h"
 #    include "opengl/TextureVSGL3.h"
+#    include "opengl/TextureInstancedVSGL3.h"
 #    include "opengl/ColorPSGL4.h"
 #    include "opengl/ColorVSGL4.h"
 #    include "opengl/TexturePSGL4.h"
 #    include "opengl/TextureVSGL4.h"
+#    include "opengl/TextureInstancedVSGL4.h"
 #  endif
 #endif
 
@@ -336,6 +339,48 @@ namespace ouzel
 
                 assetBundle.setShader(SHADER_TEXTURE, std::move(textureShader));
 
+                // the instanced static meshes fall back to the CPU transforms without this shader
+                if (renderer->getDevice()->isInstancingSupported())
+                {
+#  if OUZEL_OPENGLES
+                    std::vector<std::uint8_t> pixelShader(std::begin(TexturePSGLES3_glsl),
+                                                          std::end(TexturePSGLES3_glsl));
+                    std::vector<std::uint8_t> vertexShader(std::begin(TextureInstancedVSGLES3_glsl),
+                                                           std::end(TextureInstancedVSGLES3_glsl));
+#  else
+                    std::vector<std::uint8_t> pixelShader;
+                    std::vector<std::uint8_t> vertexShader;
+
+                    if (renderer->getDevice()->getAPIMajorVersion() == 3)
+                    {
+                        pixelShader.assign(std::begin(TexturePSGL3_glsl), std::end(TexturePSGL3_glsl));
+                        vertexShader.assign(std::begin(TextureInstancedVSGL3_glsl), std::end(TextureInstancedVSGL3_glsl));
+                    }
+                    else
+                    {
+                        pixelShader.assign(std::begin(TexturePSGL4_glsl), std::end(TexturePSGL4_glsl));
+                        vertexShader.assign(std::begin(TextureInstancedVSGL4_glsl), std::end(TextureInstancedVSGL4_glsl));
+                    }
+#  endif
+
+                    auto textureInstancedShader = std::make_unique<graphics::Shader>(*renderer,
+                                                                                     std::move(pixelShader),
+                                                                                     std::move(vertexShader),
+                                                                                     std::set<graphics::Vertex::Attribute::Usage>{
+                                                                                         graphics::Vertex::Attribute::Usage::Position,
+                                                                                         graphics::Vertex::Attribute::Usage::Color,
+                                                                                         graphics::Vertex::Attribute::Usage::TextureCoordinates0
+                                                                                     },
+                                                                                     std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                         {"color", graphics::DataType::FloatVector4}
+                                                                                     },
+                                                                                     std::vector<std::pair<std::string, graphics::DataType>>{
+                                                                                         {"viewProj", graphics::DataType::FloatMatrix4}
+                                                                                     });
+
+                    assetBundle.setShader(SHADER_TEXTURE_INSTANCED, std::move(textureInstancedShader));
+                }
+
                 auto colorShader = std::make_unique<graphics::Shader>(*renderer);
 
                 switch (renderer->getDevice()->getAPIMajorVersion())
@@ -699,21 +744,63 @@ namespace ouzel
 
     void Engine::update()
     {
+        // collect the events of the previous frame from all the threads
+        profiler.update();
+
+        Profiler::Zone zone(profiler, "Engine::update");
+
         eventDispatcher.dispatchEvents();
+        jobSystem.executeUpdateThreadJobs();
 
         const auto currentTime = std::chrono::steady_clock::now();
         auto diff = currentTime - previousUpdateTime;
 
         if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
         {
-            if (diff > std::chrono::seconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
+            // skip the first frame, because previousUpdateTime is not set yet
+            if (previousUpdateTime.time_since_epoch().count() != 0)
+                frameTimeHistogram.addSample(diff);
+
+            if (diff > std::chrono::milliseconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
 
             previousUpdateTime = currentTime;
             const float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
 
+            const float rate = fixedUpdateRate;
+            if (rate > 0.0F)
+            {
+                auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0F / rate));
+                if (step.count() <= 0) step = std::chrono::steady_clock::duration(1);
+                const float stepDelta = 1.0F / rate;
+
+                fixedUpdateTime += diff;
+
+                const std::uint32_t maxSteps = maxFixedUpdateSteps;
+                for (std::uint32_t i = 0; i < maxSteps && fixedUpdateTime >= step; ++i)
+                {
+                    fixedUpdateTime -= step;
+
+                    auto fixedUpdateEvent = std::make_unique<UpdateEvent>();
+                    fixedUpdateEvent->type = Event::Type::FixedUpdate;
+                    fixedUpdateEvent->delta = stepDelta;
+                    eventDispatcher.dispatchEvent(std::move(fixedUpdateEvent));
+                }
+
+                // drop the time that could not be caught up with
+                if (fixedUpdateTime >= step) fixedUpdateTime %= step;
+
+                fixedUpdateAlpha = static_cast<float>(fixedUpdateTime.count()) / static_cast<float>(step.count());
+            }
+            else
+            {
+                fixedUpdateTime = std::chrono::steady_clock::duration::zero();
+                fixedUpdateAlpha = 1.0F;
+            }
+
             auto updateEvent = std::make_unique<UpdateEvent>();
             updateEvent->type = Event::Type::Update;
             updateEvent->delta = delta;
+            updateEvent->alpha = fixedUpdateAlpha;
             eventDispatcher.dispatchEvent(std::move(updateEvent));
         }
 
@@ -727,9 +814,12 @@ namespace ouzel
         if (oneUpdatePerFrame) renderer->waitForNextFrame();
     }
 
-    void Engine::executeOnMainThread(const std::function<void()>& func)
+    bool Engine::executeOnMainThread(const std::function<void()>& func)
     {
-        if (active) runOnMainThread(func);
+        if (!active) return false;
+
+        runOnMainThread(func);
+        return true;
     }
 
     void Engine::engineMain()
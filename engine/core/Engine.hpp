@@ -11,6 +11,9 @@
 #include <thread>
 #include <vector>
 #include "core/Application.hpp"
+#include "core/FrameTimeHistogram.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
 #include "core/Timer.hpp"
 #include "core/Window.hpp"
 #include "graphics/Renderer.hpp"
@@ -34,6 +37,7 @@ namespace ouzel
     std::unique_ptr<Application> main(const std::vector<std::string>& args);
 
     const std::string SHADER_TEXTURE = "shaderTexture";
+    const std::string SHADER_TEXTURE_INSTANCED = "shaderTextureInstanced";
     const std::string SHADER_COLOR = "shaderColor";
 
     const std::string BLEND_NO_BLEND = "blendNoBlend";
@@ -64,6 +68,9 @@ namespace ouzel
         inline auto& getLogger() { return logger; }
         inline auto& getLogger() const { return logger; }
 
+        inline auto& getProfiler() { return profiler; }
+        inline auto& getProfiler() const { return profiler; }
+
         inline auto& getFileSystem() { return fileSystem; }
         inline auto& getFileSystem() const { return fileSystem; }
 
@@ -89,6 +96,9 @@ namespace ouzel
         inline auto& getNetwork() { return network; }
         inline auto& getNetwork() const { return network; }
 
+        inline auto& getJobSystem() { return jobSystem; }
+        inline auto& getJobSystem() const { return jobSystem; }
+
         inline auto& getDefaultSettings() const noexcept { return defaultSettings; }
         inline auto& getUserSettings() const noexcept { return userSettings; }
 
@@ -102,7 +112,8 @@ namespace ouzel
 
         void update();
 
-        void executeOnMainThread(const std::function<void()>& func);
+        // returns false if the function was dropped because the engine is not running
+        bool executeOnMainThread(const std::function<void()>& func);
 
         virtual void openUrl(const std::string& url);
 
@@ -112,6 +123,20 @@ namespace ouzel
         inline bool isOneUpdatePerFrame() const noexcept { return oneUpdatePerFrame; }
         inline void setOneUpdatePerFrame(bool value) { oneUpdatePerFrame = value; }
 
+        // fixed update rate in Hz, 0 disables FixedUpdate events
+        inline auto getFixedUpdateRate() const noexcept { return fixedUpdateRate.load(); }
+        inline void setFixedUpdateRate(float newFixedUpdateRate) { fixedUpdateRate = newFixedUpdateRate; }
+
+        // maximum number of FixedUpdate events per frame, remaining time is dropped
+        inline auto getMaxFixedUpdateSteps() const noexcept { return maxFixedUpdateSteps.load(); }
+        inline void setMaxFixedUpdateSteps(std::uint32_t newMaxFixedUpdateSteps) { maxFixedUpdateSteps = newMaxFixedUpdateSteps; }
+
+        // interpolation factor between the last two fixed updates
+        inline auto getFixedUpdateAlpha() const noexcept { return fixedUpdateAlpha; }
+
+        inline auto& getFrameTimeHistogram() const noexcept { return frameTimeHistogram; }
+        inline void resetFrameTimeHistogram() noexcept { frameTimeHistogram.reset(); }
+
     protected:
         class Command final
         {
@@ -132,6 +157,7 @@ namespace ouzel
         virtual void runOnMainThread(const std::function<void()>& func) = 0;
 
         Logger logger;
+        Profiler profiler;
         storage::FileSystem fileSystem;
         EventDispatcher eventDispatcher;
         std::unique_ptr<Window> window;
@@ -153,13 +179,21 @@ namespace ouzel
         std::condition_variable updateCondition;
 #endif
         std::chrono::steady_clock::time_point previousUpdateTime;
+        std::chrono::steady_clock::duration fixedUpdateTime{0};
+        float fixedUpdateAlpha = 1.0F;
+        FrameTimeHistogram frameTimeHistogram;
 
         std::atomic_bool active{false};
         std::atomic_bool paused{false};
         std::atomic_bool oneUpdatePerFrame{false};
+        std::atomic<float> fixedUpdateRate{0.0F};
+        std::atomic<std::uint32_t> maxFixedUpdateSteps{5};
 
         std::atomic_bool screenSaverEnabled{true};
         std::vector<std::string> args;
+
+        // declared last, so that the workers are stopped before the other subsystems are destroyed
+        JobSystem jobSystem;
     };
 
     extern Engine* engine;
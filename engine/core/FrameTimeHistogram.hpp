@@ -0,0 +1,94 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_CORE_FRAMETIMEHISTOGRAM_HPP
+#define OUZEL_CORE_FRAMETIMEHISTOGRAM_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ouzel
+{
+    // Fixed-size histogram of frame durations with 0.1 ms buckets up to 100 ms,
+    // longer frames are collected in the last bucket
+    class FrameTimeHistogram final
+    {
+    public:
+        static constexpr std::size_t BUCKET_COUNT = 1001;
+        static constexpr std::int64_t BUCKET_WIDTH = 100; // in microseconds
+
+        FrameTimeHistogram() noexcept = default;
+
+        void addSample(const std::chrono::steady_clock::duration duration) noexcept
+        {
+            const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+            const auto bucket = static_cast<std::size_t>(microseconds.count() / BUCKET_WIDTH);
+            ++buckets[bucket < BUCKET_COUNT - 1 ? bucket : BUCKET_COUNT - 1];
+
+            if (sampleCount == 0 || microseconds < minimum) minimum = microseconds;
+            if (sampleCount == 0 || microseconds > maximum) maximum = microseconds;
+            total += microseconds;
+            ++sampleCount;
+        }
+
+        void reset() noexcept
+        {
+            buckets.fill(0);
+            sampleCount = 0;
+            total = std::chrono::microseconds::zero();
+            minimum = std::chrono::microseconds::zero();
+            maximum = std::chrono::microseconds::zero();
+        }
+
+        inline auto getSampleCount() const noexcept { return sampleCount; }
+
+        // all times are in seconds
+        inline float getMinimum() const noexcept { return toSeconds(minimum); }
+        inline float getMaximum() const noexcept { return toSeconds(maximum); }
+        inline float getAverage() const noexcept
+        {
+            return sampleCount ? toSeconds(total) / static_cast<float>(sampleCount) : 0.0F;
+        }
+
+        // returns the upper bound of the bucket that contains the given percentile (0.0 - 1.0)
+        float getPercentile(const float percentile) const noexcept
+        {
+            if (sampleCount == 0) return 0.0F;
+
+            const auto clamped = percentile < 0.0F ? 0.0F : (percentile > 1.0F ? 1.0F : percentile);
+            auto rank = static_cast<std::uint64_t>(clamped * static_cast<float>(sampleCount));
+            if (rank == 0) rank = 1;
+
+            std::uint64_t count = 0;
+            for (std::size_t i = 0; i < BUCKET_COUNT - 1; ++i)
+            {
+                count += buckets[i];
+                if (count >= rank)
+                {
+                    const std::chrono::microseconds upperBound{BUCKET_WIDTH * static_cast<std::int64_t>(i + 1)};
+                    return toSeconds(upperBound < maximum ? upperBound : maximum);
+                }
+            }
+
+            return toSeconds(maximum);
+        }
+
+        inline float getMedian() const noexcept { return getPercentile(0.5F); }
+
+        inline auto& getBuckets() const noexcept { return buckets; }
+
+    private:
+        static float toSeconds(const std::chrono::microseconds duration) noexcept
+        {
+            return static_cast<float>(duration.count()) / 1000000.0F;
+        }
+
+        std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+        std::uint64_t sampleCount = 0;
+        std::chrono::microseconds total{0};
+        std::chrono::microseconds minimum{0};
+        std::chrono::microseconds maximum{0};
+    };
+}
+
+#endif // OUZEL_CORE_FRAMETIMEHISTOGRAM_HPP
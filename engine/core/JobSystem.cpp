@@ -0,0 +1,326 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <thread>
+#include "JobSystem.hpp"
+#include "Engine.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace
+    {
+        constexpr std::size_t NO_WORKER = std::numeric_limits<std::size_t>::max();
+
+        thread_local const JobSystem* currentJobSystem = nullptr;
+        thread_local std::size_t currentWorker = NO_WORKER;
+    }
+
+    JobSystem::JobSystem(std::size_t workerCount):
+        statsResetTime(std::chrono::steady_clock::now())
+    {
+        for (std::size_t i = 0; i < workerCount; ++i)
+            workers.push_back(std::make_unique<Worker>());
+
+        // start the threads after all the workers are created, because they steal from each other
+        for (std::size_t i = 0; i < workerCount; ++i)
+            workers[i]->thread = Thread(&JobSystem::workerMain, this, i);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+        sleepCondition.notify_all();
+
+        for (const auto& worker : workers)
+            if (worker->thread.isJoinable()) worker->thread.join();
+    }
+
+    std::size_t JobSystem::getDefaultWorkerCount()
+    {
+#if defined(__EMSCRIPTEN__)
+        return 0;
+#else
+        const auto hardwareConcurrency = std::thread::hardware_concurrency();
+        return (hardwareConcurrency > 1) ? hardwareConcurrency - 1 : 1;
+#endif
+    }
+
+    void JobSystem::run(Job job, Counter* counter)
+    {
+        if (counter) ++counter->value;
+
+        Task task;
+        task.job = std::move(job);
+        task.counter = counter;
+        schedule(std::move(task));
+    }
+
+    void JobSystem::run(Job job, Counter& dependency, Counter* counter)
+    {
+        if (counter) ++counter->value;
+
+        Task task;
+        task.job = std::move(job);
+        task.counter = counter;
+
+        std::unique_lock<std::mutex> lock(dependency.mutex);
+        if (dependency.value == 0)
+        {
+            lock.unlock();
+            schedule(std::move(task));
+        }
+        else
+            dependency.waitingTasks.push_back(std::move(task));
+    }
+
+    void JobSystem::runOnUpdateThread(Job job, Counter* counter)
+    {
+        if (counter) ++counter->value;
+
+        Task task;
+        task.job = std::move(job);
+        task.counter = counter;
+
+        std::unique_lock<std::mutex> lock(updateThreadMutex);
+        updateThreadTasks.push_back(std::move(task));
+    }
+
+    void JobSystem::wait(const Counter& counter)
+    {
+        const std::size_t index = (currentJobSystem == this) ? currentWorker : NO_WORKER;
+
+        while (!counter.isDone())
+        {
+            Task task;
+            if (findTask(index, task))
+                execute(task);
+            else
+            {
+                // sleep until the counter is done or there is a job to help with
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepCondition.wait(lock, [this, &counter]() { return counter.isDone() || pendingTasks > 0; });
+            }
+        }
+
+        // synchronize with the thread that finished the last job
+        std::unique_lock<std::mutex> lock(counter.mutex);
+    }
+
+    void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize,
+                                const std::function<void(std::size_t rangeBegin, std::size_t rangeEnd)>& function)
+    {
+        if (begin >= end) return;
+
+        if (grainSize == 0)
+        {
+            // a few ranges per thread to balance the load
+            const std::size_t rangeCount = (workers.size() + 1) * 4;
+            grainSize = std::max<std::size_t>(1, (end - begin + rangeCount - 1) / rangeCount);
+        }
+
+        if (workers.empty() || end - begin <= grainSize)
+        {
+            function(begin, end);
+            return;
+        }
+
+        Counter counter;
+
+        for (std::size_t rangeBegin = begin; rangeBegin < end; rangeBegin += grainSize)
+        {
+            const std::size_t rangeEnd = std::min(rangeBegin + grainSize, end);
+            run([&function, rangeBegin, rangeEnd]() {
+                function(rangeBegin, rangeEnd);
+            }, &counter);
+        }
+
+        wait(counter);
+    }
+
+    void JobSystem::executeUpdateThreadJobs()
+    {
+        {
+            std::unique_lock<std::mutex> lock(updateThreadMutex);
+            std::swap(updateThreadTasks, executingUpdateThreadTasks);
+        }
+
+        for (Task& task : executingUpdateThreadTasks)
+            execute(task);
+
+        executingUpdateThreadTasks.clear();
+    }
+
+    std::vector<JobSystem::WorkerStats> JobSystem::getWorkerStats() const
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - statsResetTime).count();
+
+        std::vector<WorkerStats> result;
+        result.reserve(workers.size());
+
+        for (const auto& worker : workers)
+        {
+            WorkerStats stats;
+            stats.executedJobs = worker->executedJobs;
+            stats.stolenJobs = worker->stolenJobs;
+            const std::uint64_t busyTime = worker->busyTime;
+            stats.busyTime = static_cast<float>(busyTime) / 1000000000.0F;
+            stats.utilization = (elapsed > 0) ? static_cast<float>(busyTime) / static_cast<float>(elapsed) : 0.0F;
+            result.push_back(stats);
+        }
+
+        return result;
+    }
+
+    void JobSystem::resetWorkerStats()
+    {
+        for (const auto& worker : workers)
+        {
+            worker->executedJobs = 0;
+            worker->stolenJobs = 0;
+            worker->busyTime = 0;
+        }
+
+        statsResetTime = std::chrono::steady_clock::now();
+    }
+
+    void JobSystem::workerMain(std::size_t index)
+    {
+        Thread::setCurrentThreadName("Worker " + std::to_string(index));
+
+        currentJobSystem = this;
+        currentWorker = index;
+
+        Worker& worker = *workers[index];
+
+        while (running)
+        {
+            Task task;
+            if (findTask(index, task))
+            {
+                const auto startTime = std::chrono::steady_clock::now();
+                execute(task);
+                const auto duration = std::chrono::steady_clock::now() - startTime;
+
+                ++worker.executedJobs;
+                worker.busyTime += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepCondition.wait(lock, [this]() { return !running || pendingTasks > 0; });
+            }
+        }
+    }
+
+    void JobSystem::schedule(Task task)
+    {
+        if (workers.empty())
+        {
+            execute(task);
+            return;
+        }
+
+        // workers push to their own deque, other threads distribute the jobs
+        const std::size_t index = (currentJobSystem == this) ? currentWorker : nextWorker++ % workers.size();
+        Worker& worker = *workers[index];
+
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            ++pendingTasks;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+
+        sleepCondition.notify_one();
+    }
+
+    bool JobSystem::findTask(std::size_t index, Task& task)
+    {
+        if (index != NO_WORKER)
+        {
+            Worker& worker = *workers[index];
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty())
+            {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                --pendingTasks;
+                return true;
+            }
+        }
+
+        if (pendingTasks == 0) return false;
+
+        const std::size_t first = (index != NO_WORKER) ? index + 1 : 0;
+        for (std::size_t i = 0; i < workers.size(); ++i)
+        {
+            const std::size_t victimIndex = (first + i) % workers.size();
+            if (victimIndex == index) continue;
+
+            Worker& victim = *workers[victimIndex];
+            std::unique_lock<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --pendingTasks;
+                if (index != NO_WORKER) ++workers[index]->stolenJobs;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobSystem::execute(Task& task)
+    {
+        try
+        {
+            task.job();
+        }
+        catch (const std::exception& e)
+        {
+            engine->log(Log::Level::Error) << "Job failed: " << e.what();
+        }
+
+        finish(task.counter);
+    }
+
+    void JobSystem::finish(Counter* counter)
+    {
+        if (!counter) return;
+
+        // the counter is decremented under the lock, so that wait can't return (and the counter can't be destroyed) before it is released
+        std::vector<Task> waitingTasks;
+        bool done = false;
+        {
+            std::unique_lock<std::mutex> lock(counter->mutex);
+            if (--counter->value == 0)
+            {
+                std::swap(waitingTasks, counter->waitingTasks);
+                done = true;
+            }
+        }
+
+        if (done)
+        {
+            // wake the threads that wait for the counter, taking the lock makes sure they are either sleeping or haven't checked it yet
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+            }
+            sleepCondition.notify_all();
+        }
+
+        for (Task& task : waitingTasks)
+            schedule(std::move(task));
+    }
+}
@@ -0,0 +1,130 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_CORE_JOBSYSTEM_HPP
+#define OUZEL_CORE_JOBSYSTEM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    // Work-stealing job scheduler, every worker has its own deque and steals from the others when it runs out of jobs
+    class JobSystem final
+    {
+    public:
+        using Job = std::function<void()>;
+
+        class Counter;
+
+    private:
+        struct Task final
+        {
+            Job job;
+            Counter* counter = nullptr;
+        };
+
+    public:
+        // Tracks the number of unfinished jobs
+        class Counter final
+        {
+        public:
+            Counter() noexcept = default;
+
+            Counter(const Counter&) = delete;
+            Counter& operator=(const Counter&) = delete;
+            Counter(Counter&&) = delete;
+            Counter& operator=(Counter&&) = delete;
+
+            inline bool isDone() const noexcept { return value == 0; }
+
+        private:
+            friend JobSystem;
+
+            std::atomic<std::size_t> value{0};
+            mutable std::mutex mutex;
+            std::vector<Task> waitingTasks; // tasks that depend on this counter
+        };
+
+        struct WorkerStats final
+        {
+            std::uint64_t executedJobs = 0;
+            std::uint64_t stolenJobs = 0;
+            float busyTime = 0.0F; // in seconds
+            float utilization = 0.0F; // busy time divided by the time since the last reset
+        };
+
+        explicit JobSystem(std::size_t workerCount = getDefaultWorkerCount());
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        // one worker per hardware thread, except the one running the engine
+        static std::size_t getDefaultWorkerCount();
+
+        inline auto getWorkerCount() const noexcept { return workers.size(); }
+
+        // the counter (if not null) is decremented after the job has finished
+        void run(Job job, Counter* counter = nullptr);
+        // the job is started after the dependency counter reaches zero
+        void run(Job job, Counter& dependency, Counter* counter = nullptr);
+        // the job is executed on the thread that runs Engine::update at the beginning of the next frame
+        void runOnUpdateThread(Job job, Counter* counter = nullptr);
+
+        // executes pending jobs on the calling thread until the counter reaches zero, sleeps while there is nothing to run
+        void wait(const Counter& counter);
+
+        // calls the function for ranges of at most grainSize elements (0 picks a size based on the worker count) and waits for them
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize,
+                         const std::function<void(std::size_t rangeBegin, std::size_t rangeEnd)>& function);
+
+        void executeUpdateThreadJobs();
+
+        std::vector<WorkerStats> getWorkerStats() const;
+        void resetWorkerStats();
+
+    private:
+        struct Worker final
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks; // the owner works on the back, thieves take from the front
+            Thread thread;
+
+            std::atomic<std::uint64_t> executedJobs{0};
+            std::atomic<std::uint64_t> stolenJobs{0};
+            std::atomic<std::uint64_t> busyTime{0}; // in nanoseconds
+        };
+
+        void workerMain(std::size_t index);
+        void schedule(Task task);
+        bool findTask(std::size_t index, Task& task);
+        void execute(Task& task);
+        void finish(Counter* counter);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<std::size_t> nextWorker{0};
+
+        std::atomic<std::size_t> pendingTasks{0};
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic_bool running{true};
+
+        std::mutex updateThreadMutex;
+        std::vector<Task> updateThreadTasks;
+        std::vector<Task> executingUpdateThreadTasks;
+
+        std::chrono::steady_clock::time_point statsResetTime;
+    };
+}
+
+#endif // OUZEL_CORE_JOBSYSTEM_HPP
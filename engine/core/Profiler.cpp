@@ -0,0 +1,313 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "Profiler.hpp"
+
+namespace ouzel
+{
+    namespace
+    {
+        std::atomic<std::uint64_t> lastProfilerId{0};
+
+        void appendEscaped(std::string& str, const char* value)
+        {
+            constexpr char digits[] = "0123456789abcdef";
+
+            for (const char* c = value; *c; ++c)
+            {
+                const auto character = static_cast<unsigned char>(*c);
+
+                if (character == '"' || character == '\\')
+                {
+                    str.push_back('\\');
+                    str.push_back(*c);
+                }
+                else if (character < 0x20)
+                {
+                    str += "\\u00";
+                    str.push_back(digits[character >> 4]);
+                    str.push_back(digits[character & 0x0F]);
+                }
+                else
+                    str.push_back(*c);
+            }
+        }
+    }
+
+    // Single producer (the profiled thread), single consumer (Profiler::update) ring buffer of events
+    class Profiler::Buffer final
+    {
+    public:
+        static constexpr std::size_t CAPACITY = 16384; // must be a power of two
+
+        explicit Buffer(std::uint32_t initThreadId):
+            threadId(initThreadId), events(CAPACITY)
+        {
+        }
+
+        bool write(const Event& event) noexcept
+        {
+            const std::uint64_t position = writePosition.load(std::memory_order_relaxed);
+            if (position - readPosition.load(std::memory_order_acquire) == CAPACITY) return false;
+
+            events[static_cast<std::size_t>(position & (CAPACITY - 1))] = event;
+            writePosition.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool read(Event& event) noexcept
+        {
+            const std::uint64_t position = readPosition.load(std::memory_order_relaxed);
+            if (position == writePosition.load(std::memory_order_acquire)) return false;
+
+            event = events[static_cast<std::size_t>(position & (CAPACITY - 1))];
+            readPosition.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        const std::uint32_t threadId;
+        std::uint32_t openZoneCount = 0; // zones whose begin event was recorded, used only by the producer
+
+    private:
+        std::vector<Event> events;
+        std::atomic<std::uint64_t> writePosition{0};
+        std::atomic<std::uint64_t> readPosition{0};
+    };
+
+    Profiler::Profiler():
+        startTime(std::chrono::steady_clock::now()),
+        id(++lastProfilerId)
+    {
+    }
+
+    void Profiler::startCapture()
+    {
+        update();
+
+        {
+            std::unique_lock<std::mutex> lock(eventsMutex);
+            events.clear();
+        }
+
+        droppedEventCount = 0;
+        capturing = true;
+    }
+
+    void Profiler::stopCapture()
+    {
+        capturing = false;
+        update();
+    }
+
+    bool Profiler::beginZone(const char* name)
+    {
+        if (!isCapturing()) return false;
+
+        Buffer& buffer = getBuffer();
+        if (!record(buffer, EventType::Begin, name, 0)) return false;
+
+        ++buffer.openZoneCount;
+        return true;
+    }
+
+    void Profiler::endZone()
+    {
+        // the end is recorded for every recorded begin, even if the capture was stopped inside the zone
+        Buffer* buffer = findBuffer();
+        if (!buffer || buffer->openZoneCount == 0) return;
+
+        --buffer->openZoneCount;
+        record(*buffer, EventType::End, nullptr, 0);
+    }
+
+    void Profiler::setCounter(const char* name, std::int64_t value)
+    {
+        if (!isCapturing()) return;
+
+        record(getBuffer(), EventType::Counter, name, value);
+    }
+
+    std::uint64_t Profiler::getTime() const
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+    }
+
+    void Profiler::addGpuZone(const char* name, std::uint64_t beginTime, std::uint64_t endTime)
+    {
+        if (!isCapturing()) return;
+
+        Event event;
+        event.time = beginTime;
+        event.value = static_cast<std::int64_t>(endTime > beginTime ? endTime - beginTime : 0);
+        event.threadId = GPU_THREAD_ID;
+        event.type = EventType::Complete;
+        if (name) std::strncpy(event.name, name, MAX_NAME_LENGTH);
+
+        std::unique_lock<std::mutex> lock(eventsMutex);
+        events.push_back(event);
+    }
+
+    void Profiler::update()
+    {
+        // only one thread at a time may read from the buffers
+        std::unique_lock<std::mutex> lock(buffersMutex);
+        std::unique_lock<std::mutex> eventsLock(eventsMutex);
+
+        for (auto i = buffers.begin(); i != buffers.end();)
+        {
+            // the buffer is only owned by the profiler after its thread has exited
+            const bool threadExited = i->use_count() == 1;
+
+            Event event;
+            while ((*i)->read(event))
+                events.push_back(event);
+
+            if (threadExited)
+                i = buffers.erase(i);
+            else
+                ++i;
+        }
+    }
+
+    std::vector<Profiler::Event> Profiler::getEvents() const
+    {
+        std::unique_lock<std::mutex> lock(eventsMutex);
+        return events;
+    }
+
+    std::string Profiler::getTrace() const
+    {
+        std::unique_lock<std::mutex> lock(eventsMutex);
+
+        std::string result = "{\"traceEvents\":[";
+
+        // a zone can be open when the capture starts or stops, so unmatched end events are skipped and unmatched begin events are closed at the end
+        std::unordered_map<std::uint32_t, std::uint32_t> openZoneCounts;
+        std::uint64_t lastTime = 0;
+        bool first = true;
+
+        // timestamps and durations are in microseconds
+        const auto toMicroseconds = [](std::uint64_t time) {
+            const std::string nanoseconds = std::to_string(1000 + time % 1000);
+            return std::to_string(time / 1000) + '.' + nanoseconds.substr(1);
+        };
+
+        const auto appendEvent = [&result, &first, &toMicroseconds](const Event& event) {
+            if (!first) result += ',';
+            first = false;
+            result += "\n{\"name\":\"";
+            appendEscaped(result, event.name);
+            result += "\",\"ph\":\"";
+
+            switch (event.type)
+            {
+                case EventType::Begin: result += 'B'; break;
+                case EventType::End: result += 'E'; break;
+                case EventType::Counter: result += 'C'; break;
+                case EventType::Complete: result += 'X'; break;
+            }
+
+            result += "\",\"ts\":" + toMicroseconds(event.time);
+            result += ",\"pid\":0,\"tid\":" + std::to_string(event.threadId);
+
+            if (event.type == EventType::Counter)
+                result += ",\"args\":{\"value\":" + std::to_string(event.value) + '}';
+            else if (event.type == EventType::Complete)
+                result += ",\"dur\":" + toMicroseconds(static_cast<std::uint64_t>(event.value));
+
+            result += '}';
+        };
+
+        if (std::any_of(events.begin(), events.end(), [](const Event& event) { return event.threadId == GPU_THREAD_ID; }))
+        {
+            result += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(GPU_THREAD_ID) + ",\"args\":{\"name\":\"GPU\"}}";
+            first = false;
+        }
+
+        for (const Event& event : events)
+        {
+            if (event.type == EventType::Begin)
+                ++openZoneCounts[event.threadId];
+            else if (event.type == EventType::End)
+            {
+                auto& openZoneCount = openZoneCounts[event.threadId];
+                if (openZoneCount == 0) continue;
+                --openZoneCount;
+            }
+
+            lastTime = std::max(lastTime, event.time);
+            appendEvent(event);
+        }
+
+        for (const auto& openZoneCount : openZoneCounts)
+            for (std::uint32_t i = 0; i < openZoneCount.second; ++i)
+            {
+                Event event;
+                event.time = lastTime;
+                event.threadId = openZoneCount.first;
+                event.type = EventType::End;
+                appendEvent(event);
+            }
+
+        result += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        return result;
+    }
+
+    void Profiler::exportTrace(const std::string& filename) const
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open file " + filename);
+
+        const std::string trace = getTrace();
+        file.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+    }
+
+    bool Profiler::record(Buffer& buffer, EventType type, const char* name, std::int64_t value)
+    {
+        Event event;
+        event.time = getTime();
+        event.value = value;
+        event.threadId = buffer.threadId;
+        event.type = type;
+        if (name) std::strncpy(event.name, name, MAX_NAME_LENGTH);
+
+        if (buffer.write(event)) return true;
+
+        ++droppedEventCount;
+        return false;
+    }
+
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<Profiler::Buffer>>>& Profiler::getThreadBuffers()
+    {
+        thread_local std::vector<std::pair<std::uint64_t, std::shared_ptr<Buffer>>> threadBuffers;
+        return threadBuffers;
+    }
+
+    Profiler::Buffer* Profiler::findBuffer() const
+    {
+        for (const auto& threadBuffer : getThreadBuffers())
+            if (threadBuffer.first == id)
+                return threadBuffer.second.get();
+
+        return nullptr;
+    }
+
+    Profiler::Buffer& Profiler::getBuffer()
+    {
+        if (Buffer* buffer = findBuffer()) return *buffer;
+
+        std::unique_lock<std::mutex> lock(buffersMutex);
+        auto buffer = std::make_shared<Buffer>(static_cast<std::uint32_t>(++lastThreadId));
+        buffers.push_back(buffer);
+        lock.unlock();
+
+        getThreadBuffers().emplace_back(id, buffer);
+        return *buffer;
+    }
+}
@@ -0,0 +1,126 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_CORE_PROFILER_HPP
+#define OUZEL_CORE_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ouzel
+{
+    // Records timing zones and counters from any thread while a capture is running,
+    // every thread writes to its own lock-free ring buffer, which is drained once per frame by update.
+    // Render devices that support timer queries add the GPU time of the debug marker zones on a separate track.
+    // The captured events can be exported in the Chrome trace event format (chrome://tracing).
+    class Profiler final
+    {
+    public:
+        static constexpr std::size_t MAX_NAME_LENGTH = 39;
+        static constexpr std::uint32_t GPU_THREAD_ID = 0; // the track of the GPU zones, the threads are numbered from 1
+
+        enum class EventType: std::uint8_t
+        {
+            Begin,
+            End,
+            Counter,
+            Complete // a zone with its duration in value, used for the GPU zones
+        };
+
+        struct Event final
+        {
+            std::uint64_t time = 0; // in nanoseconds since the profiler was created
+            std::int64_t value = 0;
+            std::uint32_t threadId = 0;
+            EventType type = EventType::Begin;
+            char name[MAX_NAME_LENGTH + 1]{};
+        };
+
+        // Times the scope it is declared in
+        class Zone final
+        {
+        public:
+            Zone(Profiler& initProfiler, const char* name):
+                profiler(initProfiler),
+                active(profiler.beginZone(name))
+            {
+            }
+
+            ~Zone()
+            {
+                if (active) profiler.endZone();
+            }
+
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+            Zone(Zone&&) = delete;
+            Zone& operator=(Zone&&) = delete;
+
+        private:
+            Profiler& profiler;
+            bool active;
+        };
+
+        Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+        Profiler(Profiler&&) = delete;
+        Profiler& operator=(Profiler&&) = delete;
+
+        inline bool isCapturing() const noexcept { return capturing.load(std::memory_order_relaxed); }
+        // discards the events of the previous capture
+        void startCapture();
+        void stopCapture();
+
+        // returns false if the zone was not recorded because no capture is running
+        bool beginZone(const char* name);
+        bool beginZone(const std::string& name) { return beginZone(name.c_str()); }
+        // closes the last zone of the calling thread that was recorded by beginZone
+        void endZone();
+        void setCounter(const char* name, std::int64_t value);
+
+        // time in nanoseconds since the profiler was created, the time base of the events
+        std::uint64_t getTime() const;
+        // adds a zone that was timed on the GPU, the times must be converted to the profiler's time base
+        void addGpuZone(const char* name, std::uint64_t beginTime, std::uint64_t endTime);
+
+        // moves the recorded events from the thread buffers to the capture
+        void update();
+
+        std::vector<Event> getEvents() const;
+
+        // number of events lost because a thread's buffer was full
+        inline std::uint64_t getDroppedEventCount() const noexcept { return droppedEventCount; }
+
+        std::string getTrace() const;
+        void exportTrace(const std::string& filename) const;
+
+    private:
+        class Buffer;
+
+        static std::vector<std::pair<std::uint64_t, std::shared_ptr<Buffer>>>& getThreadBuffers();
+        bool record(Buffer& buffer, EventType type, const char* name, std::int64_t value);
+        Buffer* findBuffer() const;
+        Buffer& getBuffer();
+
+        const std::chrono::steady_clock::time_point startTime;
+        const std::uint64_t id; // identifies the profiler in thread local storage
+        std::atomic_bool capturing{false};
+        std::atomic<std::uint64_t> droppedEventCount{0};
+
+        std::mutex buffersMutex;
+        std::vector<std::shared_ptr<Buffer>> buffers;
+        std::uint32_t lastThreadId = 0;
+
+        mutable std::mutex eventsMutex;
+        std::vector<Event> events;
+    };
+}
+
+#endif // OUZEL_CORE_PROFILER_HPP
@@ -85,6 +85,7 @@ namespace ouzel
             SoundFinish,
 
             Update,
+            FixedUpdate, // sent at a fixed rate before the Update event (see Engine::setFixedUpdateRate)
 
             User // user defined event
         };
@@ -181,6 +182,7 @@ namespace ouzel
     struct UpdateEvent final: Event
     {
         float delta;
+        float alpha = 1.0F; // fraction of the fixed update step that has elapsed since the last FixedUpdate event
     };
 
     struct UserEvent final: Event
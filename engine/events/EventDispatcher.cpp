@@ -161,6 +161,10 @@ namespace ouzel
                         if (eventHandler->updateHandler)
                             handled = eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get()));
                         break;
+                    case Event::Type::FixedUpdate:
+                        if (eventHandler->fixedUpdateHandler)
+                            handled = eventHandler->fixedUpdateHandler(*static_cast<UpdateEvent*>(event.get()));
+                        break;
                     case Event::Type::User:
                         if (eventHandler->userHandler)
                             handled = eventHandler->userHandler(*static_cast<UserEvent*>(event.get()));
@@ -1,5 +1,6 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <cstring>
 #include <stdexcept>
 #include "Buffer.hpp"
 #include "Renderer.hpp"
@@ -71,26 +72,63 @@ namespace ouzel
                                                                         initSize));
         }
 
+        Buffer::Buffer(Renderer& initRenderer,
+                       BufferType initType,
+                       std::uint32_t initFlags,
+                       std::vector<std::uint8_t>&& initData,
+                       std::uint32_t initSize):
+            renderer(&initRenderer),
+            resource(initRenderer.getDevice()->createResource()),
+            type(initType),
+            flags(initFlags),
+            size(initSize)
+        {
+            if (!initData.empty() && initSize != initData.size())
+                throw std::runtime_error("Invalid buffer data");
+
+            initRenderer.addCommand(std::make_unique<InitBufferCommand>(resource,
+                                                                        initType,
+                                                                        initFlags,
+                                                                        std::move(initData),
+                                                                        initSize));
+        }
+
         void Buffer::setData(const void* newData, std::uint32_t newSize)
         {
-            if (resource)
-                renderer->addCommand(std::make_unique<SetBufferDataCommand>(resource,
-                                                                            std::vector<std::uint8_t>(static_cast<const std::uint8_t*>(newData),
-                                                                                                 static_cast<const std::uint8_t*>(newData) + newSize)));
+            setData(0, newData, newSize);
         }
 
         void Buffer::setData(const std::vector<std::uint8_t>& newData)
+        {
+            setData(0, newData);
+        }
+
+        void Buffer::setData(std::uint32_t offset, const void* newData, std::uint32_t newSize)
+        {
+            void* stagingData = stageData(offset, newSize);
+            if (stagingData) std::memcpy(stagingData, newData, newSize);
+        }
+
+        void Buffer::setData(std::uint32_t offset, const std::vector<std::uint8_t>& newData)
+        {
+            setData(offset, newData.data(), static_cast<std::uint32_t>(newData.size()));
+        }
+
+        void* Buffer::stageData(std::uint32_t offset, std::uint32_t newSize)
         {
             if (!(flags & Flags::Dynamic))
                 throw std::runtime_error("Buffer is not dynamic");
 
-            if (newData.empty())
+            if (newSize == 0)
                 throw std::runtime_error("Invalid buffer data");
 
-            if (newData.size() > size) size = static_cast<std::uint32_t>(newData.size());
+            if (offset + newSize > size) size = offset + newSize;
+
+            if (!resource) return nullptr;
 
-            if (resource)
-                renderer->addCommand(std::make_unique<SetBufferDataCommand>(resource, newData));
+            std::uint8_t* stagingData = renderer->allocateStaging(newSize);
+            renderer->addCommand(std::make_unique<SetBufferDataCommand>(resource, stagingData, newSize, offset));
+            return stagingData;
         }
     } // namespace graphics
 } // namespace ouzel
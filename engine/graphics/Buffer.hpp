@@ -34,10 +34,24 @@ namespace ouzel
                    std::uint32_t initFlags,
                    const std::vector<std::uint8_t>& initData,
                    std::uint32_t initSize);
+            Buffer(Renderer& initRenderer,
+                   BufferType initType,
+                   std::uint32_t initFlags,
+                   std::vector<std::uint8_t>&& initData,
+                   std::uint32_t initSize);
 
             void setData(const void* newData, std::uint32_t newSize);
             void setData(const std::vector<std::uint8_t>& newData);
 
+            // updates a part of the buffer starting at the given offset in bytes, the rest of the contents is preserved
+            void setData(std::uint32_t offset, const void* newData, std::uint32_t newSize);
+            void setData(std::uint32_t offset, const std::vector<std::uint8_t>& newData);
+
+            // returns memory for newSize bytes that will be uploaded to the buffer at the given offset,
+            // it has to be filled before the frame is presented and is read in place by the render thread,
+            // returns nullptr if the buffer has no resource
+            void* stageData(std::uint32_t offset, std::uint32_t newSize);
+
             inline auto& getResource() const noexcept { return resource; }
 
             inline auto getType() const noexcept { return type; }
@@ -3,8 +3,12 @@
 #ifndef OUZEL_GRAPHICS_COMMANDS_HPP
 #define OUZEL_GRAPHICS_COMMANDS_HPP
 
+#include <memory>
 #include <queue>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 #include "graphics/BlendFactor.hpp"
 #include "graphics/BlendOperation.hpp"
 #include "graphics/BufferType.hpp"
@@ -18,6 +22,7 @@
 #include "graphics/RasterizerState.hpp"
 #include "graphics/SamplerFilter.hpp"
 #include "graphics/SamplerAddressMode.hpp"
+#include "graphics/StagingAllocator.hpp"
 #include "graphics/StencilOperation.hpp"
 #include "graphics/TextureType.hpp"
 #include "graphics/Vertex.hpp"
@@ -48,6 +53,7 @@ namespace ouzel
                 SetDepthStencilState,
                 SetPipelineState,
                 Draw,
+                DrawInstanced,
                 PushDebugMarker,
                 PopDebugMarker,
                 InitBlendState,
@@ -363,6 +369,40 @@ namespace ouzel
             const std::uint32_t startIndex;
         };
 
+        // draws the mesh once for every Instance in the instance buffer
+        class DrawInstancedCommand final: public Command
+        {
+        public:
+            constexpr DrawInstancedCommand(std::uintptr_t initIndexBuffer,
+                                           std::uint32_t initIndexCount,
+                                           std::uint32_t initIndexSize,
+                                           std::uintptr_t initVertexBuffer,
+                                           std::uintptr_t initInstanceBuffer,
+                                           std::uint32_t initInstanceCount,
+                                           DrawMode initDrawMode,
+                                           std::uint32_t initStartIndex) noexcept:
+                Command(Command::Type::DrawInstanced),
+                indexBuffer(initIndexBuffer),
+                indexCount(initIndexCount),
+                indexSize(initIndexSize),
+                vertexBuffer(initVertexBuffer),
+                instanceBuffer(initInstanceBuffer),
+                instanceCount(initInstanceCount),
+                drawMode(initDrawMode),
+                startIndex(initStartIndex)
+            {
+            }
+
+            const std::uintptr_t indexBuffer;
+            const std::uint32_t indexCount;
+            const std::uint32_t indexSize;
+            const std::uintptr_t vertexBuffer;
+            const std::uintptr_t instanceBuffer;
+            const std::uint32_t instanceCount;
+            const DrawMode drawMode;
+            const std::uint32_t startIndex;
+        };
+
         class PushDebugMarkerCommand final: public Command
         {
         public:
@@ -426,13 +466,13 @@ namespace ouzel
             InitBufferCommand(std::uintptr_t initBuffer,
                               BufferType initBufferType,
                               std::uint32_t initFlags,
-                              const std::vector<std::uint8_t>& initData,
+                              std::vector<std::uint8_t> initData,
                               std::uint32_t initSize) noexcept:
                 Command(Command::Type::InitBuffer),
                 buffer(initBuffer),
                 bufferType(initBufferType),
                 flags(initFlags),
-                data(initData),
+                data(std::move(initData)),
                 size(initSize)
             {
             }
@@ -447,24 +487,31 @@ namespace ouzel
         class SetBufferDataCommand final: public Command
         {
         public:
+            // the data is owned by the command buffer's staging memory
             SetBufferDataCommand(std::uintptr_t initBuffer,
-                                 const std::vector<std::uint8_t>& initData) noexcept:
+                                 const std::uint8_t* initData,
+                                 std::uint32_t initSize,
+                                 std::uint32_t initOffset) noexcept:
                 Command(Command::Type::SetBufferData),
                 buffer(initBuffer),
-                data(initData)
+                data(initData),
+                size(initSize),
+                offset(initOffset)
             {
             }
 
             const std::uintptr_t buffer;
-            const std::vector<std::uint8_t> data;
+            const std::uint8_t* const data;
+            const std::uint32_t size;
+            const std::uint32_t offset;
         };
 
         class InitShaderCommand final: public Command
         {
         public:
             InitShaderCommand(std::uintptr_t initShader,
-                              const std::vector<std::uint8_t>& initFragmentShader,
-                              const std::vector<std::uint8_t>& initVertexShader,
+                              std::vector<std::uint8_t> initFragmentShader,
+                              std::vector<std::uint8_t> initVertexShader,
                               const std::set<Vertex::Attribute::Usage>& initVertexAttributes,
                               const std::vector<std::pair<std::string, DataType>>& initFragmentShaderConstantInfo,
                               const std::vector<std::pair<std::string, DataType>>& initVertexShaderConstantInfo,
@@ -472,8 +519,8 @@ namespace ouzel
                               const std::string& initVertexShaderFunction) noexcept:
                 Command(Command::Type::InitShader),
                 shader(initShader),
-                fragmentShader(initFragmentShader),
-                vertexShader(initVertexShader),
+                fragmentShader(std::move(initFragmentShader)),
+                vertexShader(std::move(initVertexShader)),
                 vertexAttributes(initVertexAttributes),
                 fragmentShaderConstantInfo(initFragmentShaderConstantInfo),
                 vertexShaderConstantInfo(initVertexShaderConstantInfo),
@@ -498,8 +545,8 @@ namespace ouzel
             SetShaderConstantsCommand(std::vector<std::vector<float>> initFragmentShaderConstants,
                                       std::vector<std::vector<float>> initVertexShaderConstants) noexcept:
                 Command(Command::Type::SetShaderConstants),
-                fragmentShaderConstants(initFragmentShaderConstants),
-                vertexShaderConstants(initVertexShaderConstants)
+                fragmentShaderConstants(std::move(initFragmentShaderConstants)),
+                vertexShaderConstants(std::move(initVertexShaderConstants))
             {
             }
 
@@ -511,14 +558,14 @@ namespace ouzel
         {
         public:
             InitTextureCommand(std::uintptr_t initTexture,
-                               const std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>& initLevels,
+                               std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> initLevels,
                                TextureType initTextureType,
                                std::uint32_t initFlags,
                                std::uint32_t initSampleCount,
                                PixelFormat initPixelFormat) noexcept:
                 Command(Command::Type::InitTexture),
                 texture(initTexture),
-                levels(initLevels),
+                levels(std::move(initLevels)),
                 textureType(initTextureType),
                 flags(initFlags),
                 sampleCount(initSampleCount),
@@ -538,20 +585,20 @@ namespace ouzel
         {
         public:
             SetTextureDataCommand(std::uintptr_t initTexture,
-                                  const std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>& initLevels) noexcept:
+                                  std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> initLevels) noexcept:
                 Command(Command::Type::SetTextureData),
                 texture(initTexture),
-                levels(initLevels),
+                levels(std::move(initLevels)),
                 face(CubeFace::PositiveX)
             {
             }
 
             SetTextureDataCommand(std::uintptr_t initTexture,
-                                  const std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>& initLevels,
+                                  std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> initLevels,
                                   CubeFace initFace) noexcept:
                 Command(Command::Type::SetTextureData),
                 texture(initTexture),
-                levels(initLevels),
+                levels(std::move(initLevels)),
                 face(initFace)
             {
             }
@@ -612,6 +659,43 @@ namespace ouzel
             {
             }
 
+            explicit CommandBuffer(const std::shared_ptr<StagingAllocator>& initStagingAllocator) noexcept:
+                stagingAllocator(initStagingAllocator)
+            {
+            }
+
+            ~CommandBuffer()
+            {
+                if (stagingAllocator) stagingAllocator->releasePages(stagingPages);
+            }
+
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+            CommandBuffer(CommandBuffer&& other) noexcept:
+                name(std::move(other.name)),
+                commands(std::move(other.commands)),
+                stagingAllocator(std::move(other.stagingAllocator)),
+                stagingPages(std::move(other.stagingPages))
+            {
+                other.stagingPages.clear();
+            }
+
+            CommandBuffer& operator=(CommandBuffer&& other) noexcept
+            {
+                if (&other == this) return *this;
+
+                if (stagingAllocator) stagingAllocator->releasePages(stagingPages);
+
+                name = std::move(other.name);
+                commands = std::move(other.commands);
+                stagingAllocator = std::move(other.stagingAllocator);
+                stagingPages = std::move(other.stagingPages);
+                other.stagingPages.clear();
+
+                return *this;
+            }
+
             inline auto& getName() const noexcept { return name; }
 
             inline auto isEmpty() const noexcept { return commands.empty(); }
@@ -633,9 +717,24 @@ namespace ouzel
                 return commands;
             }
 
+            // memory for the data of the upload commands, it stays valid until the command buffer is destroyed
+            std::uint8_t* allocateStaging(std::size_t size)
+            {
+                if (!stagingPages.empty())
+                    if (std::uint8_t* result = stagingPages.back().allocate(size))
+                        return result;
+
+                stagingPages.push_back(stagingAllocator ?
+                                       stagingAllocator->acquirePage(size) :
+                                       StagingAllocator::Page(size));
+                return stagingPages.back().allocate(size);
+            }
+
         private:
             std::string name;
             std::queue<std::unique_ptr<Command>> commands;
+            std::shared_ptr<StagingAllocator> stagingAllocator;
+            std::vector<StagingAllocator::Page> stagingPages;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_IMAGEDATA_HPP
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 #include "graphics/PixelFormat.hpp"
 #include "math/Size.hpp"
@@ -19,8 +20,8 @@ namespace ouzel
 
             Image(PixelFormat initPixelFormat,
                   const Size2U& initSize,
-                  const std::vector<std::uint8_t>& initData):
-                pixelFormat(initPixelFormat), size(initSize), data(initData)
+                  std::vector<std::uint8_t> initData):
+                pixelFormat(initPixelFormat), size(initSize), data(std::move(initData))
             {
             }
 
@@ -24,7 +24,8 @@ namespace ouzel
             renderTargetsSupported(false),
             clampToBorderSupported(false),
             multisamplingSupported(false),
-            uintIndicesSupported(false)
+            uintIndicesSupported(false),
+            instancingSupported(false)
         {
         }
 
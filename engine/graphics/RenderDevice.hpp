@@ -100,6 +100,7 @@ namespace ouzel
             inline auto isNPOTTexturesSupported() const noexcept { return npotTexturesSupported; }
             inline auto isAnisotropicFilteringSupported() const noexcept { return anisotropicFilteringSupported; }
             inline auto isRenderTargetsSupported() const noexcept { return renderTargetsSupported; }
+            inline auto isInstancingSupported() const noexcept { return instancingSupported; }
 
             auto& getProjectionTransform(bool renderTarget) const noexcept
             {
@@ -214,6 +215,7 @@ namespace ouzel
             bool clampToBorderSupported:1;
             bool multisamplingSupported:1;
             bool uintIndicesSupported:1;
+            bool instancingSupported:1;
 
             Matrix4F projectionTransform = Matrix4F::identity();
             Matrix4F renderTargetProjectionTransform = Matrix4F::identity();
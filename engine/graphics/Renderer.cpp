@@ -256,6 +256,31 @@ namespace ouzel
                                                      startIndex));
         }
 
+        void Renderer::drawInstanced(std::uintptr_t indexBuffer,
+                                     std::uint32_t indexCount,
+                                     std::uint32_t indexSize,
+                                     std::uintptr_t vertexBuffer,
+                                     std::uintptr_t instanceBuffer,
+                                     std::uint32_t instanceCount,
+                                     DrawMode drawMode,
+                                     std::uint32_t startIndex)
+        {
+            if (!device->isInstancingSupported())
+                throw std::runtime_error("Instanced drawing is not supported");
+
+            if (!indexBuffer || !vertexBuffer || !instanceBuffer)
+                throw std::runtime_error("Invalid mesh buffer passed to render queue");
+
+            addCommand(std::make_unique<DrawInstancedCommand>(indexBuffer,
+                                                              indexCount,
+                                                              indexSize,
+                                                              vertexBuffer,
+                                                              instanceBuffer,
+                                                              instanceCount,
+                                                              drawMode,
+                                                              startIndex));
+        }
+
         void Renderer::pushDebugMarker(const std::string& name)
         {
             addCommand(std::make_unique<PushDebugMarkerCommand>(name));
@@ -278,12 +303,64 @@ namespace ouzel
             addCommand(std::make_unique<SetTexturesCommand>(textures));
         }
 
+        void Renderer::addCommand(std::unique_ptr<Command> command)
+        {
+            ++currentFrameStatistics.commandCount;
+
+            switch (command->type)
+            {
+                case Command::Type::Draw:
+                case Command::Type::DrawInstanced:
+                    ++currentFrameStatistics.drawCount;
+                    break;
+                case Command::Type::SetRenderTarget:
+                case Command::Type::SetScissorTest:
+                case Command::Type::SetViewport:
+                case Command::Type::SetDepthStencilState:
+                case Command::Type::SetPipelineState:
+                case Command::Type::SetShaderConstants:
+                case Command::Type::SetTextures:
+                    ++currentFrameStatistics.stateChangeCount;
+                    break;
+                case Command::Type::InitBuffer:
+                    currentFrameStatistics.uploadedBytes += static_cast<const InitBufferCommand*>(command.get())->data.size();
+                    break;
+                case Command::Type::SetBufferData:
+                    currentFrameStatistics.uploadedBytes += static_cast<const SetBufferDataCommand*>(command.get())->size;
+                    break;
+                case Command::Type::InitTexture:
+                    for (const auto& level : static_cast<const InitTextureCommand*>(command.get())->levels)
+                        currentFrameStatistics.uploadedBytes += level.second.size();
+                    break;
+                case Command::Type::SetTextureData:
+                    for (const auto& level : static_cast<const SetTextureDataCommand*>(command.get())->levels)
+                        currentFrameStatistics.uploadedBytes += level.second.size();
+                    break;
+                default:
+                    break;
+            }
+
+            commandBuffer.pushCommand(std::move(command));
+        }
+
         void Renderer::present()
         {
             refillQueue = false;
             addCommand(std::make_unique<PresentCommand>());
             device->submitCommandBuffer(std::move(commandBuffer));
-            commandBuffer = CommandBuffer();
+            commandBuffer = CommandBuffer(stagingAllocator);
+
+            frameStatistics = currentFrameStatistics;
+            currentFrameStatistics = FrameStatistics();
+
+            Profiler& profiler = engine->getProfiler();
+            if (profiler.isCapturing())
+            {
+                profiler.setCounter("Commands", frameStatistics.commandCount);
+                profiler.setCounter("Draws", frameStatistics.drawCount);
+                profiler.setCounter("State changes", frameStatistics.stateChangeCount);
+                profiler.setCounter("Uploaded bytes", static_cast<std::int64_t>(frameStatistics.uploadedBytes));
+            }
         }
 
         void Renderer::waitForNextFrame()
@@ -69,18 +69,36 @@ namespace ouzel
                       std::uintptr_t vertexBuffer,
                       DrawMode drawMode,
                       std::uint32_t startIndex);
+            void drawInstanced(std::uintptr_t indexBuffer,
+                               std::uint32_t indexCount,
+                               std::uint32_t indexSize,
+                               std::uintptr_t vertexBuffer,
+                               std::uintptr_t instanceBuffer,
+                               std::uint32_t instanceCount,
+                               DrawMode drawMode,
+                               std::uint32_t startIndex);
             void pushDebugMarker(const std::string& name);
             void popDebugMarker();
             void setShaderConstants(const std::vector<std::vector<float>>& fragmentShaderConstants,
                                     const std::vector<std::vector<float>>& vertexShaderConstants);
             void setTextures(const std::vector<std::uintptr_t>& textures);
 
-            inline void addCommand(std::unique_ptr<Command> command)
-            {
-                commandBuffer.pushCommand(std::move(command));
-            }
+            void addCommand(std::unique_ptr<Command> command);
+            // memory for upload data that the render thread reads in place, valid until the frame is presented
+            inline std::uint8_t* allocateStaging(std::size_t stagingSize) { return commandBuffer.allocateStaging(stagingSize); }
             void present();
 
+            struct FrameStatistics final
+            {
+                std::uint32_t commandCount = 0;
+                std::uint32_t drawCount = 0;
+                std::uint32_t stateChangeCount = 0;
+                std::uint64_t uploadedBytes = 0;
+            };
+
+            // statistics of the last presented frame
+            inline auto& getFrameStatistics() const noexcept { return frameStatistics; }
+
             void waitForNextFrame();
             inline bool getRefillQueue() const noexcept { return refillQueue; }
 
@@ -103,7 +121,10 @@ namespace ouzel
             std::unique_ptr<RenderDevice> device;
 
             Size2U size;
-            CommandBuffer commandBuffer;
+            std::shared_ptr<StagingAllocator> stagingAllocator = std::make_shared<StagingAllocator>();
+            CommandBuffer commandBuffer{stagingAllocator};
+            FrameStatistics frameStatistics;
+            FrameStatistics currentFrameStatistics;
 
             bool newFrame = false;
             std::mutex frameMutex;
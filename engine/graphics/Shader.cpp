@@ -32,5 +32,26 @@ namespace ouzel
                                                                         fragmentShaderFunction,
                                                                         vertexShaderFunction));
         }
+
+        Shader::Shader(Renderer& initRenderer,
+                       std::vector<std::uint8_t>&& initFragmentShader,
+                       std::vector<std::uint8_t>&& initVertexShader,
+                       const std::set<Vertex::Attribute::Usage>& initVertexAttributes,
+                       const std::vector<std::pair<std::string, DataType>>& initFragmentShaderConstantInfo,
+                       const std::vector<std::pair<std::string, DataType>>& initVertexShaderConstantInfo,
+                       const std::string& fragmentShaderFunction,
+                       const std::string& vertexShaderFunction):
+            resource(initRenderer.getDevice()->createResource()),
+            vertexAttributes(initVertexAttributes)
+        {
+            initRenderer.addCommand(std::make_unique<InitShaderCommand>(resource,
+                                                                        std::move(initFragmentShader),
+                                                                        std::move(initVertexShader),
+                                                                        initVertexAttributes,
+                                                                        initFragmentShaderConstantInfo,
+                                                                        initVertexShaderConstantInfo,
+                                                                        fragmentShaderFunction,
+                                                                        vertexShaderFunction));
+        }
     } // namespace graphics
 } // namespace ouzel
@@ -31,6 +31,14 @@ namespace ouzel
                    const std::vector<std::pair<std::string, DataType>>& initVertexShaderConstantInfo,
                    const std::string& fragmentShaderFunction = "",
                    const std::string& vertexShaderFunction = "");
+            Shader(Renderer& initRenderer,
+                   std::vector<std::uint8_t>&& initFragmentShader,
+                   std::vector<std::uint8_t>&& initVertexShader,
+                   const std::set<Vertex::Attribute::Usage>& initVertexAttributes,
+                   const std::vector<std::pair<std::string, DataType>>& initFragmentShaderConstantInfo,
+                   const std::vector<std::pair<std::string, DataType>>& initVertexShaderConstantInfo,
+                   const std::string& fragmentShaderFunction = "",
+                   const std::string& vertexShaderFunction = "");
 
             inline auto& getResource() const noexcept { return resource; }
 
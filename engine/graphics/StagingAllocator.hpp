@@ -0,0 +1,95 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_STAGINGALLOCATOR_HPP
+#define OUZEL_GRAPHICS_STAGINGALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // Owns the pages that hold the data of upload commands, a command buffer takes pages from
+        // the allocator while it is recorded and gives them back when the render thread has executed it,
+        // so the memory is reused from frame to frame instead of being allocated for every upload
+        class StagingAllocator final
+        {
+        public:
+            static constexpr std::size_t PAGE_SIZE = 1024 * 1024;
+            static constexpr std::size_t MAX_FREE_SIZE = 64 * 1024 * 1024;
+            static constexpr std::size_t ALIGNMENT = 16;
+
+            class Page final
+            {
+            public:
+                explicit Page(std::size_t initSize):
+                    data(new std::uint8_t[initSize]), size(initSize)
+                {
+                }
+
+                inline auto getSize() const noexcept { return size; }
+
+                // returns nullptr if there is not enough space left
+                std::uint8_t* allocate(std::size_t allocationSize) noexcept
+                {
+                    const std::size_t offset = (used + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+                    if (offset > size || allocationSize > size - offset) return nullptr;
+
+                    used = offset + allocationSize;
+                    return data.get() + offset;
+                }
+
+                void reset() noexcept { used = 0; }
+
+            private:
+                std::unique_ptr<std::uint8_t[]> data;
+                std::size_t size = 0;
+                std::size_t used = 0;
+            };
+
+            Page acquirePage(std::size_t minimumSize)
+            {
+                std::unique_lock<std::mutex> lock(pagesMutex);
+
+                for (auto i = freePages.begin(); i != freePages.end(); ++i)
+                    if (i->getSize() >= minimumSize)
+                    {
+                        Page page = std::move(*i);
+                        freePages.erase(i);
+                        freeSize -= page.getSize();
+                        return page;
+                    }
+
+                lock.unlock();
+
+                return Page(minimumSize > PAGE_SIZE ? minimumSize : PAGE_SIZE);
+            }
+
+            void releasePages(std::vector<Page>& pages)
+            {
+                std::lock_guard<std::mutex> lock(pagesMutex);
+
+                for (Page& page : pages)
+                    if (freeSize + page.getSize() <= MAX_FREE_SIZE)
+                    {
+                        freeSize += page.getSize();
+                        page.reset();
+                        freePages.push_back(std::move(page));
+                    }
+
+                pages.clear();
+            }
+
+        private:
+            std::mutex pagesMutex;
+            std::vector<Page> freePages;
+            std::size_t freeSize = 0;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_STAGINGALLOCATOR_HPP
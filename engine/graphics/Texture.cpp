@@ -572,7 +572,7 @@ namespace ouzel
             }
 
             std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> calculateSizes(const Size2U& size,
-                                                                                const std::vector<std::uint8_t>& data,
+                                                                                std::vector<std::uint8_t> data,
                                                                                 std::uint32_t mipmaps,
                                                                                 PixelFormat pixelFormat)
             {
@@ -581,13 +581,14 @@ namespace ouzel
                 std::uint32_t newWidth = size.v[0];
                 std::uint32_t newHeight = size.v[1];
 
-                levels.emplace_back(size, data);
-
                 std::uint32_t previousWidth = newWidth;
                 std::uint32_t previousHeight = newHeight;
                 std::vector<float> previousData;
 
-                decode(size, data, pixelFormat, previousData);
+                // only the mip levels need the decoded pixels
+                if (mipmaps != 1) decode(size, data, pixelFormat, previousData);
+
+                levels.emplace_back(size, std::move(data));
 
                 std::vector<float> newData;
                 std::vector<std::uint8_t> encodedData;
@@ -669,7 +670,7 @@ namespace ouzel
             std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> levels = calculateSizes(size, mipmaps, pixelFormat);
 
             initRenderer.addCommand(std::make_unique<InitTextureCommand>(resource,
-                                                                        levels,
+                                                                        std::move(levels),
                                                                         TextureType::TwoDimensional,
                                                                         flags,
                                                                         sampleCount,
@@ -700,7 +701,7 @@ namespace ouzel
             std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> levels = calculateSizes(size, initData, mipmaps, pixelFormat);
 
             initRenderer.addCommand(std::make_unique<InitTextureCommand>(resource,
-                                                                         levels,
+                                                                         std::move(levels),
                                                                          TextureType::TwoDimensional,
                                                                          flags,
                                                                          sampleCount,
@@ -712,6 +713,19 @@ namespace ouzel
                          const Size2U& initSize,
                          std::uint32_t initFlags,
                          PixelFormat initPixelFormat):
+            Texture(initRenderer,
+                    std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>(initLevels),
+                    initSize,
+                    initFlags,
+                    initPixelFormat)
+        {
+        }
+
+        Texture::Texture(Renderer& initRenderer,
+                         std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>&& initLevels,
+                         const Size2U& initSize,
+                         std::uint32_t initFlags,
+                         PixelFormat initPixelFormat):
             renderer(&initRenderer),
             resource(initRenderer.getDevice()->createResource()),
             size(initSize),
@@ -723,17 +737,15 @@ namespace ouzel
             if ((flags & Flags::BindRenderTarget) && (mipmaps == 0 || mipmaps > 1))
                 throw std::runtime_error("Invalid mip map count");
 
-            std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> levels = initLevels;
-
             if (!initRenderer.getDevice()->isNPOTTexturesSupported() &&
                 (!isPowerOfTwo(size.v[0]) || !isPowerOfTwo(size.v[1])))
             {
                 mipmaps = 1;
-                levels.resize(1);
+                initLevels.resize(1);
             }
 
             initRenderer.addCommand(std::make_unique<InitTextureCommand>(resource,
-                                                                         levels,
+                                                                         std::move(initLevels),
                                                                          TextureType::TwoDimensional,
                                                                          flags,
                                                                          sampleCount,
@@ -741,15 +753,20 @@ namespace ouzel
         }
 
         void Texture::setData(const std::vector<std::uint8_t>& newData, CubeFace face)
+        {
+            setData(std::vector<std::uint8_t>(newData), face);
+        }
+
+        void Texture::setData(std::vector<std::uint8_t>&& newData, CubeFace face)
         {
             if (!(flags & Flags::Dynamic) || flags & Flags::BindRenderTarget)
                 throw std::runtime_error("Texture is not dynamic");
 
-            std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> levels = calculateSizes(size, newData, mipmaps, pixelFormat);
+            std::vector<std::pair<Size2U, std::vector<std::uint8_t>>> levels = calculateSizes(size, std::move(newData), mipmaps, pixelFormat);
 
             if (resource)
                 renderer->addCommand(std::make_unique<SetTextureDataCommand>(resource,
-                                                                             levels,
+                                                                             std::move(levels),
                                                                              face));
         }
 
@@ -44,12 +44,19 @@ namespace ouzel
                     const Size2U& initSize,
                     std::uint32_t initFlags = 0,
                     PixelFormat initPixelFormat = PixelFormat::RGBA8UNorm);
+            Texture(Renderer& initRenderer,
+                    std::vector<std::pair<Size2U, std::vector<std::uint8_t>>>&& initLevels,
+                    const Size2U& initSize,
+                    std::uint32_t initFlags = 0,
+                    PixelFormat initPixelFormat = PixelFormat::RGBA8UNorm);
 
             inline auto& getResource() const noexcept { return resource; }
 
             inline auto& getSize() const noexcept { return size; }
 
             void setData(const std::vector<std::uint8_t>& newData, CubeFace face = CubeFace::PositiveX);
+            // the data becomes the first mip level without being copied
+            void setData(std::vector<std::uint8_t>&& newData, CubeFace face = CubeFace::PositiveX);
 
             inline auto getFlags() const noexcept { return flags; }
             inline auto getMipmaps() const noexcept { return mipmaps; }
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_VERTEX_HPP
 
 #include "graphics/DataType.hpp"
+#include "math/Matrix.hpp"
 #include "math/Vector.hpp"
 #include "math/Color.hpp"
 
@@ -51,6 +52,20 @@ namespace ouzel
             Vector2F texCoords[2];
             Vector3F normal;
         };
+
+        // per-instance data of the instanced draws
+        class Instance final
+        {
+        public:
+            Instance() noexcept = default;
+            Instance(const Matrix4F& initTransform, float initOpacity) noexcept:
+                transform(initTransform), opacity(initOpacity)
+            {
+            }
+
+            Matrix4F transform;
+            float opacity = 1.0F;
+        };
     } // namespace graphics
 } // namespace ouzel
 
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_DIRECT3D11
 
+#include <algorithm>
 #include "D3D11Buffer.hpp"
 #include "D3D11RenderDevice.hpp"
 
@@ -16,24 +17,31 @@ namespace ouzel
             Buffer::Buffer(RenderDevice& initRenderDevice,
                            BufferType initType,
                            std::uint32_t initFlags,
-                           const std::vector<std::uint8_t>& data,
+                           const std::vector<std::uint8_t>& initData,
                            std::uint32_t initSize):
                 RenderResource(initRenderDevice),
                 type(initType),
                 flags(initFlags),
                 size(static_cast<UINT>(initSize))
             {
-                createBuffer(initSize, data);
+                createBuffer(initSize, initData);
+
+                if (flags & Flags::Dynamic)
+                    data = initData;
             }
 
-            void Buffer::setData(const std::vector<std::uint8_t>& data)
+            void Buffer::setData(const std::uint8_t* newData, std::uint32_t newSize, std::uint32_t offset)
             {
                 if (!(flags & Flags::Dynamic))
                     throw std::runtime_error("Buffer is not dynamic");
 
-                if (data.empty())
+                if (newSize == 0)
                     throw std::runtime_error("Data is empty");
 
+                const std::size_t end = offset + newSize;
+                if (data.size() < end) data.resize(end);
+                std::copy(newData, newData + newSize, data.begin() + offset);
+
                 if (!buffer || data.size() > size)
                     createBuffer(static_cast<UINT>(data.size()), data);
                 else
@@ -56,7 +64,7 @@ namespace ouzel
                 }
             }
 
-            void Buffer::createBuffer(UINT newSize, const std::vector<std::uint8_t>& data)
+            void Buffer::createBuffer(UINT newSize, const std::vector<std::uint8_t>& bufferData)
             {
                 if (newSize)
                 {
@@ -84,7 +92,7 @@ namespace ouzel
 
                     HRESULT hr;
 
-                    if (data.empty())
+                    if (bufferData.empty())
                     {
 						ID3D11Buffer* newBuffer;
                         if (FAILED(hr = renderDevice.getDevice()->CreateBuffer(&bufferDesc, nullptr, &newBuffer)))
@@ -95,7 +103,7 @@ namespace ouzel
                     else
                     {
                         D3D11_SUBRESOURCE_DATA bufferResourceData;
-                        bufferResourceData.pSysMem = data.data();
+                        bufferResourceData.pSysMem = bufferData.data();
                         bufferResourceData.SysMemPitch = 0;
                         bufferResourceData.SysMemSlicePitch = 0;
 
@@ -37,10 +37,10 @@ namespace ouzel
                 Buffer(RenderDevice& initRenderDevice,
                        BufferType initType,
                        std::uint32_t initFlags,
-                       const std::vector<std::uint8_t>& data,
+                       const std::vector<std::uint8_t>& initData,
                        std::uint32_t initSize);
 
-                void setData(const std::vector<std::uint8_t>& data);
+                void setData(const std::uint8_t* newData, std::uint32_t newSize, std::uint32_t offset);
 
                 inline auto getFlags() const noexcept { return flags; }
                 inline auto getType() const noexcept { return type; }
@@ -49,13 +49,14 @@ namespace ouzel
                 inline auto& getBuffer() const noexcept { return buffer; }
 
             private:
-                void createBuffer(UINT newSize, const std::vector<std::uint8_t>& data);
+                void createBuffer(UINT newSize, const std::vector<std::uint8_t>& bufferData);
 
                 BufferType type;
                 std::uint32_t flags = 0;
 
                 Pointer<ID3D11Buffer> buffer;
                 UINT size = 0;
+                std::vector<std::uint8_t> data; // dynamic buffers can only be written as a whole, so partial updates are applied to this copy
             };
         } // namespace d3d11
     } // namespace graphics
@@ -372,6 +372,8 @@ namespace ouzel
 
             void RenderDevice::process()
             {
+                Profiler::Zone zone(engine->getProfiler(), "RenderDevice::process");
+
                 graphics::RenderDevice::process();
                 executeAll();
 
@@ -693,13 +695,15 @@ namespace ouzel
 
                             case Command::Type::PushDebugMarker:
                             {
-                                // D3D11 does not support debug markers
+                                // D3D11 does not support debug markers, they are only used as profiler zones
+                                auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
+                                engine->getProfiler().beginZone(pushDebugMarkerCommand->name);
                                 break;
                             }
 
                             case Command::Type::PopDebugMarker:
                             {
-                                // D3D11 does not support debug markers
+                                engine->getProfiler().endZone();
                                 break;
                             }
 
@@ -744,7 +748,9 @@ namespace ouzel
                                 auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
 
                                 auto buffer = getResource<Buffer>(setBufferDataCommand->buffer);
-                                buffer->setData(setBufferDataCommand->data);
+                                buffer->setData(setBufferDataCommand->data,
+                                                setBufferDataCommand->size,
+                                                setBufferDataCommand->offset);
                                 break;
                             }
 
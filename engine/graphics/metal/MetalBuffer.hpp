@@ -36,7 +36,7 @@ namespace ouzel
                        const std::vector<std::uint8_t>& initData,
                        std::uint32_t initSize);
 
-                void setData(const std::vector<std::uint8_t>& data);
+                void setData(const std::uint8_t* newData, std::uint32_t newSize, std::uint32_t offset);
 
                 inline auto getFlags() const noexcept { return flags; }
                 inline auto getType() const noexcept { return type; }
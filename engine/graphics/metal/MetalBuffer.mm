@@ -30,18 +30,28 @@ namespace ouzel
                     std::copy(data.begin(), data.end(), static_cast<std::uint8_t*>([buffer.get() contents]));
             }
 
-            void Buffer::setData(const std::vector<std::uint8_t>& data)
+            void Buffer::setData(const std::uint8_t* newData, std::uint32_t newSize, std::uint32_t offset)
             {
                 if (!(flags & Flags::Dynamic))
                     throw Error("Buffer is not dynamic");
 
-                if (data.empty())
+                if (newSize == 0)
                     throw Error("Data is empty");
 
-                if (!buffer || data.size() > size)
-                    createBuffer(static_cast<std::uint32_t>(data.size()));
+                if (!buffer || offset + newSize > size)
+                {
+                    // preserve the contents outside of the updated range
+                    std::vector<std::uint8_t> contents;
+                    if (buffer && offset > 0)
+                        contents.assign(static_cast<std::uint8_t*>([buffer.get() contents]),
+                                        static_cast<std::uint8_t*>([buffer.get() contents]) + std::min<NSUInteger>(size, offset));
+
+                    createBuffer(static_cast<NSUInteger>(offset + newSize));
+
+                    std::copy(contents.begin(), contents.end(), static_cast<std::uint8_t*>([buffer.get() contents]));
+                }
 
-                std::copy(data.begin(), data.end(), static_cast<std::uint8_t*>([buffer.get() contents]));
+                std::copy(newData, newData + newSize, static_cast<std::uint8_t*>([buffer.get() contents]) + offset);
             }
 
             void Buffer::createBuffer(NSUInteger newSize)
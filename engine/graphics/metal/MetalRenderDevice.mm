@@ -193,6 +193,8 @@ namespace ouzel
 
             void RenderDevice::process()
             {
+                Profiler::Zone zone(engine->getProfiler(), "RenderDevice::process");
+
                 graphics::RenderDevice::process();
                 executeAll();
 
@@ -591,6 +593,7 @@ namespace ouzel
                                     throw Error("Metal render command encoder not initialized");
 
                                 [currentRenderCommandEncoder pushDebugGroup:static_cast<NSString* _Nonnull>([NSString stringWithUTF8String:pushDebugMarkerCommand->name.c_str()])];
+                                engine->getProfiler().beginZone(pushDebugMarkerCommand->name);
                                 break;
                             }
 
@@ -602,6 +605,7 @@ namespace ouzel
                                     throw Error("Metal render command encoder not initialized");
 
                                 [currentRenderCommandEncoder popDebugGroup];
+                                engine->getProfiler().endZone();
                                 break;
                             }
 
@@ -646,7 +650,9 @@ namespace ouzel
                                 auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
 
                                 auto buffer = getResource<Buffer>(setBufferDataCommand->buffer);
-                                buffer->setData(setBufferDataCommand->data);
+                                buffer->setData(setBufferDataCommand->data,
+                                                setBufferDataCommand->size,
+                                                setBufferDataCommand->offset);
                                 break;
                             }
 
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "OGLBuffer.hpp"
 #include "OGLRenderDevice.hpp"
 
@@ -74,15 +75,18 @@ namespace ouzel
                 }
             }
 
-            void Buffer::setData(const std::vector<std::uint8_t>& newData)
+            void Buffer::setData(const std::uint8_t* newData, std::uint32_t newSize, std::uint32_t offset)
             {
                 if (!(flags & Flags::Dynamic))
                     throw std::runtime_error("Buffer is not dynamic");
 
-                if (newData.empty())
+                if (newSize == 0)
                     throw std::invalid_argument("Data is empty");
 
-                data = newData;
+                // keep the whole contents of the buffer for reloading
+                const std::size_t end = offset + newSize;
+                data.resize(std::max(data.size(), std::max(end, static_cast<std::size_t>(size))));
+                std::copy(newData, newData + newSize, data.begin() + offset);
 
                 if (!bufferId)
                     throw std::runtime_error("Buffer not initialized");
@@ -102,7 +106,8 @@ namespace ouzel
                 }
                 else
                 {
-                    renderDevice.glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(data.size()), data.data());
+                    renderDevice.glBufferSubDataProc(bufferType, static_cast<GLintptr>(offset),
+                                                     static_cast<GLsizeiptr>(newSize), newData);
 
                     GLenum error;
 
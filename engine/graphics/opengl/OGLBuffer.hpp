@@ -42,7 +42,7 @@ namespace ouzel
 
                 void reload() final;
 
-                void setData(const std::vector<std::uint8_t>& newData);
+                void setData(const std::uint8_t* newData, std::uint32_t newSize, std::uint32_t offset);
 
                 inline auto getFlags() const noexcept { return flags; }
                 inline auto getType() const noexcept { return type; }
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <stdexcept>
 
 #include "graphics/opengl/OGL.h"
@@ -317,6 +318,11 @@ namespace ouzel
 
             RenderDevice::~RenderDevice()
             {
+#if !OUZEL_OPENGLES
+                if (!timerQueries.empty())
+                    glDeleteQueriesProc(static_cast<GLsizei>(timerQueries.size()), timerQueries.data());
+#endif
+
                 if (vertexArrayId) glDeleteVertexArraysProc(1, &vertexArrayId);
 
                 resources.clear();
@@ -401,6 +407,7 @@ namespace ouzel
                 glCullFaceProc = getter.get<PFNGLCULLFACEPROC>("glCullFace", ApiVersion(1, 0));
                 glScissorProc = getter.get<PFNGLSCISSORPROC>("glScissor", ApiVersion(1, 0));
                 glDrawElementsProc = getter.get<PFNGLDRAWELEMENTSPROC>("glDrawElements", ApiVersion(1, 0));
+                glDrawElementsInstancedProc = getter.get<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced", ApiVersion(3, 0));
                 glReadPixelsProc = getter.get<PFNGLREADPIXELSPROC>("glReadPixels", ApiVersion(1, 0));
 
                 glBlendFuncSeparateProc = getter.get<PFNGLBLENDFUNCSEPARATEPROC>("glBlendFuncSeparate", ApiVersion(2, 0));
@@ -448,6 +455,7 @@ namespace ouzel
                 glEnableVertexAttribArrayProc = getter.get<PFNGLENABLEVERTEXATTRIBARRAYPROC>("glEnableVertexAttribArray", ApiVersion(2, 0));
                 glDisableVertexAttribArrayProc = getter.get<PFNGLDISABLEVERTEXATTRIBARRAYPROC>("glDisableVertexAttribArray", ApiVersion(2, 0));
                 glVertexAttribPointerProc = getter.get<PFNGLVERTEXATTRIBPOINTERPROC>("glVertexAttribPointer", ApiVersion(2, 0));
+                glVertexAttribDivisorProc = getter.get<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor", ApiVersion(3, 0));
 
                 glGenFramebuffersProc = getter.get<PFNGLGENFRAMEBUFFERSPROC>("glGenFramebuffers", ApiVersion(2, 0));
                 glDeleteFramebuffersProc = getter.get<PFNGLDELETEFRAMEBUFFERSPROC>("glDeleteFramebuffers", ApiVersion(2, 0));
@@ -547,6 +555,8 @@ namespace ouzel
                 glCullFaceProc = getter.get<PFNGLCULLFACEPROC>("glCullFace", ApiVersion(1, 0));
                 glScissorProc = getter.get<PFNGLSCISSORPROC>("glScissor", ApiVersion(1, 0));
                 glDrawElementsProc = getter.get<PFNGLDRAWELEMENTSPROC>("glDrawElements", ApiVersion(1, 1));
+                glDrawElementsInstancedProc = getter.get<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced", ApiVersion(3, 1),
+                                                                                         {{"glDrawElementsInstancedARB", "GL_ARB_draw_instanced"}});
                 glReadPixelsProc = getter.get<PFNGLREADPIXELSPROC>("glReadPixels", ApiVersion(1, 0));
 
                 glBlendFuncSeparateProc = getter.get<PFNGLBLENDFUNCSEPARATEPROC>("glBlendFuncSeparate", ApiVersion(2, 0));
@@ -596,6 +606,8 @@ namespace ouzel
                 glEnableVertexAttribArrayProc = getter.get<PFNGLENABLEVERTEXATTRIBARRAYPROC>("glEnableVertexAttribArray", ApiVersion(2, 0));
                 glDisableVertexAttribArrayProc = getter.get<PFNGLDISABLEVERTEXATTRIBARRAYPROC>("glDisableVertexAttribArray", ApiVersion(2, 0));
                 glVertexAttribPointerProc = getter.get<PFNGLVERTEXATTRIBPOINTERPROC>("glVertexAttribPointer", ApiVersion(2, 0));
+                glVertexAttribDivisorProc = getter.get<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor", ApiVersion(3, 3),
+                                                                                     {{"glVertexAttribDivisorARB", "GL_ARB_instanced_arrays"}});
 
                 glMapBufferProc = getter.get<PFNGLMAPBUFFERPROC>("glMapBuffer", ApiVersion(2, 0));
                 glUnmapBufferProc = getter.get<PFNGLUNMAPBUFFERPROC>("glUnmapBuffer", ApiVersion(2, 0));
@@ -667,8 +679,25 @@ namespace ouzel
 
                 glPushGroupMarkerEXTProc = getter.get<PFNGLPUSHGROUPMARKEREXTPROC>("glPushGroupMarkerEXT", "GL_EXT_debug_marker");
                 glPopGroupMarkerEXTProc = getter.get<PFNGLPOPGROUPMARKEREXTPROC>("glPopGroupMarkerEXT", "GL_EXT_debug_marker");
+
+                glGenQueriesProc = getter.get<PFNGLGENQUERIESPROC>("glGenQueries", ApiVersion(1, 5));
+                glDeleteQueriesProc = getter.get<PFNGLDELETEQUERIESPROC>("glDeleteQueries", ApiVersion(1, 5));
+                glGetQueryObjectivProc = getter.get<PFNGLGETQUERYOBJECTIVPROC>("glGetQueryObjectiv", ApiVersion(1, 5));
+                glQueryCounterProc = getter.get<PFNGLQUERYCOUNTERPROC>("glQueryCounter", ApiVersion(3, 3),
+                                                                       {{"glQueryCounter", "GL_ARB_timer_query"}});
+                glGetQueryObjectui64vProc = getter.get<PFNGLGETQUERYOBJECTUI64VPROC>("glGetQueryObjectui64v", ApiVersion(3, 3),
+                                                                                     {{"glGetQueryObjectui64v", "GL_ARB_timer_query"}});
+                glGetInteger64vProc = getter.get<PFNGLGETINTEGER64VPROC>("glGetInteger64v", ApiVersion(3, 2),
+                                                                         {{"glGetInteger64v", "GL_ARB_sync"}});
+
+                timerQueriesSupported = glGenQueriesProc && glDeleteQueriesProc && glGetQueryObjectivProc &&
+                    glQueryCounterProc && glGetQueryObjectui64vProc && glGetInteger64vProc;
 #endif
 
+                // the instanced shaders are GLSL 3.30 and GLSL ES 3.00
+                instancingSupported = apiVersion >= ApiVersion(3, 0) &&
+                    glDrawElementsInstancedProc && glVertexAttribDivisorProc;
+
                 if (!multisamplingSupported) sampleCount = 1;
 
                 glDisableProc(GL_DITHER);
@@ -709,6 +738,99 @@ namespace ouzel
             {
             }
 
+            void RenderDevice::setVertexAttributes(GLuint vertexBufferId)
+            {
+                bindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+
+                std::uintptr_t vertexOffset = 0;
+
+                for (GLuint index = 0; index < RenderDevice::VERTEX_ATTRIBUTES.size(); ++index)
+                {
+                    const Vertex::Attribute& vertexAttribute = RenderDevice::VERTEX_ATTRIBUTES[index];
+
+                    void* vertexOffsetPointer;
+                    memcpy(&vertexOffsetPointer, &vertexOffset, sizeof(vertexOffset));
+
+                    glEnableVertexAttribArrayProc(index);
+                    glVertexAttribPointerProc(index,
+                                              getArraySize(vertexAttribute.dataType),
+                                              getVertexType(vertexAttribute.dataType),
+                                              isNormalized(vertexAttribute.dataType),
+                                              static_cast<GLsizei>(sizeof(Vertex)),
+                                              vertexOffsetPointer);
+
+                    vertexOffset += getDataTypeSize(vertexAttribute.dataType);
+                }
+
+                GLenum error;
+                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                    throw std::system_error(makeErrorCode(error), "Failed to update vertex attributes");
+            }
+
+#if !OUZEL_OPENGLES
+            GLuint RenderDevice::getTimerQuery()
+            {
+                if (freeTimerQueries.empty())
+                {
+                    GLuint queryId;
+                    glGenQueriesProc(1, &queryId);
+
+                    GLenum error;
+                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                        throw std::system_error(makeErrorCode(error), "Failed to create timer query");
+
+                    timerQueries.push_back(queryId);
+                    return queryId;
+                }
+
+                const GLuint queryId = freeTimerQueries.back();
+                freeTimerQueries.pop_back();
+                return queryId;
+            }
+
+            void RenderDevice::resolveGpuZones()
+            {
+                if (pendingGpuZones.empty()) return;
+
+                Profiler& profiler = engine->getProfiler();
+
+                // the offset from the GPU clock to the profiler's clock
+                GLint64 gpuTime = 0;
+                glGetInteger64vProc(GL_TIMESTAMP, &gpuTime);
+                const auto offset = static_cast<std::int64_t>(profiler.getTime()) - static_cast<std::int64_t>(gpuTime);
+
+                // the queries complete in order, so the first one that is not available ends the resolving
+                while (!pendingGpuZones.empty())
+                {
+                    const GpuZone& gpuZone = pendingGpuZones.front();
+
+                    GLint available = GL_FALSE;
+                    glGetQueryObjectivProc(gpuZone.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+                    if (!available) break;
+
+                    GLuint64 beginTime = 0;
+                    GLuint64 endTime = 0;
+                    glGetQueryObjectui64vProc(gpuZone.beginQuery, GL_QUERY_RESULT, &beginTime);
+                    glGetQueryObjectui64vProc(gpuZone.endQuery, GL_QUERY_RESULT, &endTime);
+
+                    const auto toProfilerTime = [offset](GLuint64 time) {
+                        const auto result = static_cast<std::int64_t>(time) + offset;
+                        return static_cast<std::uint64_t>(std::max<std::int64_t>(result, 0));
+                    };
+
+                    profiler.addGpuZone(gpuZone.name.c_str(), toProfilerTime(beginTime), toProfilerTime(endTime));
+
+                    freeTimerQueries.push_back(gpuZone.beginQuery);
+                    freeTimerQueries.push_back(gpuZone.endQuery);
+                    pendingGpuZones.pop_front();
+                }
+
+                GLenum error;
+                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                    throw std::system_error(makeErrorCode(error), "Failed to get timer query results");
+            }
+#endif
+
             void RenderDevice::setUniform(GLint location, DataType dataType, const void* data)
             {
                 switch (dataType)
@@ -766,6 +888,8 @@ namespace ouzel
 
             void RenderDevice::process()
             {
+                Profiler::Zone zone(engine->getProfiler(), "RenderDevice::process");
+
                 graphics::RenderDevice::process();
                 executeAll();
 
@@ -800,6 +924,9 @@ namespace ouzel
 
                             case Command::Type::Present:
                             {
+#if !OUZEL_OPENGLES
+                                if (timerQueriesSupported) resolveGpuZones();
+#endif
                                 present();
                                 break;
                             }
@@ -1095,31 +1222,9 @@ namespace ouzel
 
                                 // draw
                                 bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->getBufferId());
-                                bindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getBufferId());
-
-                                std::uintptr_t vertexOffset = 0;
-
-                                for (GLuint index = 0; index < RenderDevice::VERTEX_ATTRIBUTES.size(); ++index)
-                                {
-                                    const Vertex::Attribute& vertexAttribute = RenderDevice::VERTEX_ATTRIBUTES[index];
-
-                                    void* vertexOffsetPointer;
-                                    memcpy(&vertexOffsetPointer, &vertexOffset, sizeof(vertexOffset));
-
-                                    glEnableVertexAttribArrayProc(index);
-                                    glVertexAttribPointerProc(index,
-                                                              getArraySize(vertexAttribute.dataType),
-                                                              getVertexType(vertexAttribute.dataType),
-                                                              isNormalized(vertexAttribute.dataType),
-                                                              static_cast<GLsizei>(sizeof(Vertex)),
-                                                              vertexOffsetPointer);
-
-                                    vertexOffset += getDataTypeSize(vertexAttribute.dataType);
-                                }
+                                setVertexAttributes(vertexBuffer->getBufferId());
 
                                 GLenum error;
-                                if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                                    throw std::system_error(makeErrorCode(error), "Failed to update vertex attributes");
 
                                 assert(drawCommand->indexCount);
                                 assert(indexBuffer->getSize());
@@ -1141,16 +1246,119 @@ namespace ouzel
                                 break;
                             }
 
+                            case Command::Type::DrawInstanced:
+                            {
+                                auto drawCommand = static_cast<const DrawInstancedCommand*>(command.get());
+
+                                auto indexBuffer = getResource<Buffer>(drawCommand->indexBuffer);
+                                auto vertexBuffer = getResource<Buffer>(drawCommand->vertexBuffer);
+                                auto instanceBuffer = getResource<Buffer>(drawCommand->instanceBuffer);
+
+                                assert(indexBuffer);
+                                assert(indexBuffer->getBufferId());
+                                assert(vertexBuffer);
+                                assert(vertexBuffer->getBufferId());
+                                assert(instanceBuffer);
+                                assert(instanceBuffer->getBufferId());
+
+                                bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->getBufferId());
+                                setVertexAttributes(vertexBuffer->getBufferId());
+
+                                bindBuffer(GL_ARRAY_BUFFER, instanceBuffer->getBufferId());
+
+                                for (GLuint column = 0; column < 4; ++column)
+                                {
+                                    std::uintptr_t columnOffset = offsetof(Instance, transform) + column * 4 * sizeof(float);
+
+                                    void* columnOffsetPointer;
+                                    memcpy(&columnOffsetPointer, &columnOffset, sizeof(columnOffset));
+
+                                    glEnableVertexAttribArrayProc(INSTANCE_TRANSFORM_LOCATION + column);
+                                    glVertexAttribPointerProc(INSTANCE_TRANSFORM_LOCATION + column,
+                                                              4, GL_FLOAT, GL_FALSE,
+                                                              static_cast<GLsizei>(sizeof(Instance)),
+                                                              columnOffsetPointer);
+                                    glVertexAttribDivisorProc(INSTANCE_TRANSFORM_LOCATION + column, 1);
+                                }
+
+                                std::uintptr_t opacityOffset = offsetof(Instance, opacity);
+
+                                void* opacityOffsetPointer;
+                                memcpy(&opacityOffsetPointer, &opacityOffset, sizeof(opacityOffset));
+
+                                glEnableVertexAttribArrayProc(INSTANCE_OPACITY_LOCATION);
+                                glVertexAttribPointerProc(INSTANCE_OPACITY_LOCATION,
+                                                          1, GL_FLOAT, GL_FALSE,
+                                                          static_cast<GLsizei>(sizeof(Instance)),
+                                                          opacityOffsetPointer);
+                                glVertexAttribDivisorProc(INSTANCE_OPACITY_LOCATION, 1);
+
+                                GLenum error;
+                                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                                    throw std::system_error(makeErrorCode(error), "Failed to update instance attributes");
+
+                                assert(drawCommand->indexCount);
+                                assert(drawCommand->instanceCount);
+
+                                std::uintptr_t indexOffset = drawCommand->startIndex * drawCommand->indexSize;
+
+                                void* indexOffsetPointer;
+                                memcpy(&indexOffsetPointer, &indexOffset, sizeof(indexOffset));
+
+                                glDrawElementsInstancedProc(getDrawMode(drawCommand->drawMode),
+                                                            static_cast<GLsizei>(drawCommand->indexCount),
+                                                            getIndexType(drawCommand->indexSize),
+                                                            indexOffsetPointer,
+                                                            static_cast<GLsizei>(drawCommand->instanceCount));
+
+                                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                                    throw std::system_error(makeErrorCode(error), "Failed to draw instanced elements");
+
+                                // the plain draws don't read the instance attributes
+                                for (GLuint index = INSTANCE_TRANSFORM_LOCATION; index <= INSTANCE_OPACITY_LOCATION; ++index)
+                                {
+                                    glVertexAttribDivisorProc(index, 0);
+                                    glDisableVertexAttribArrayProc(index);
+                                }
+
+                                break;
+                            }
+
                             case Command::Type::PushDebugMarker:
                             {
                                 auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
                                 if (glPushGroupMarkerEXTProc) glPushGroupMarkerEXTProc(0, pushDebugMarkerCommand->name.c_str());
+                                engine->getProfiler().beginZone(pushDebugMarkerCommand->name);
+
+#if !OUZEL_OPENGLES
+                                if (timerQueriesSupported && engine->getProfiler().isCapturing())
+                                {
+                                    GpuZone gpuZone;
+                                    gpuZone.name = pushDebugMarkerCommand->name;
+                                    gpuZone.beginQuery = getTimerQuery();
+                                    glQueryCounterProc(gpuZone.beginQuery, GL_TIMESTAMP);
+                                    openGpuZones.push_back(std::move(gpuZone));
+                                }
+#endif
                                 break;
                             }
 
                             case Command::Type::PopDebugMarker:
                             {
                                 if (glPopGroupMarkerEXTProc) glPopGroupMarkerEXTProc();
+                                engine->getProfiler().endZone();
+
+#if !OUZEL_OPENGLES
+                                // closes the zone that was opened while capturing, also if the capture has stopped since
+                                if (!openGpuZones.empty())
+                                {
+                                    GpuZone gpuZone = std::move(openGpuZones.back());
+                                    openGpuZones.pop_back();
+                                    gpuZone.endQuery = getTimerQuery();
+                                    glQueryCounterProc(gpuZone.endQuery, GL_TIMESTAMP);
+                                    pendingGpuZones.push_back(std::move(gpuZone));
+                                }
+#endif
                                 break;
                             }
 
@@ -1195,7 +1403,9 @@ namespace ouzel
                                 auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
 
                                 auto buffer = getResource<Buffer>(setBufferDataCommand->buffer);
-                                buffer->setData(setBufferDataCommand->data);
+                                buffer->setData(setBufferDataCommand->data,
+                                                setBufferDataCommand->size,
+                                                setBufferDataCommand->offset);
                                 break;
                             }
 
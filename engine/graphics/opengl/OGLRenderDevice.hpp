@@ -10,8 +10,10 @@
 #include <cstring>
 #include <array>
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <queue>
+#include <string>
 #include <system_error>
 #include <unordered_map>
 #include <utility>
@@ -46,6 +48,10 @@ namespace ouzel
             {
                 friend Renderer;
             public:
+                // the instance attributes follow the vertex attributes, the transform takes a location per column
+                static constexpr GLuint INSTANCE_TRANSFORM_LOCATION = 5;
+                static constexpr GLuint INSTANCE_OPACITY_LOCATION = 9;
+
                 PFNGLGETINTEGERVPROC glGetIntegervProc = nullptr;
                 PFNGLGETSTRINGPROC glGetStringProc = nullptr;
                 PFNGLGETERRORPROC glGetErrorProc = nullptr;
@@ -74,6 +80,7 @@ namespace ouzel
                 PFNGLCULLFACEPROC glCullFaceProc = nullptr;
                 PFNGLSCISSORPROC glScissorProc = nullptr;
                 PFNGLDRAWELEMENTSPROC glDrawElementsProc = nullptr;
+                PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc = nullptr;
                 PFNGLREADPIXELSPROC glReadPixelsProc = nullptr;
 
                 PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparateProc = nullptr;
@@ -129,6 +136,13 @@ namespace ouzel
                 PFNGLPOLYGONMODEPROC glPolygonModeProc = nullptr;
                 PFNGLCLEARDEPTHPROC glClearDepthProc = nullptr;
                 PFNGLMAPBUFFERPROC glMapBufferProc = nullptr;
+
+                PFNGLGENQUERIESPROC glGenQueriesProc = nullptr;
+                PFNGLDELETEQUERIESPROC glDeleteQueriesProc = nullptr;
+                PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectivProc = nullptr;
+                PFNGLQUERYCOUNTERPROC glQueryCounterProc = nullptr;
+                PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64vProc = nullptr;
+                PFNGLGETINTEGER64VPROC glGetInteger64vProc = nullptr;
 #endif
 
                 PFNGLCREATESHADERPROC glCreateShaderProc = nullptr;
@@ -161,6 +175,7 @@ namespace ouzel
                 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc = nullptr;
                 PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc = nullptr;
                 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc = nullptr;
+                PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc = nullptr;
 
                 PFNGLGETSTRINGIPROC glGetStringiProc = nullptr;
                 PFNGLPUSHGROUPMARKEREXTPROC glPushGroupMarkerEXTProc = nullptr;
@@ -613,6 +628,12 @@ namespace ouzel
                 virtual void present();
                 void generateScreenshot(const std::string& filename) override;
                 void setUniform(GLint location, DataType dataType, const void* data);
+                void setVertexAttributes(GLuint vertexBufferId);
+
+#if !OUZEL_OPENGLES
+                GLuint getTimerQuery();
+                void resolveGpuZones();
+#endif
 
                 GLuint frameBufferId = 0;
                 GLsizei frameBufferWidth = 0;
@@ -684,6 +705,22 @@ namespace ouzel
 
                 StateCache stateCache;
 
+#if !OUZEL_OPENGLES
+                // debug marker zones timed on the GPU with timestamp queries, resolved without stalling a few frames later
+                struct GpuZone final
+                {
+                    std::string name;
+                    GLuint beginQuery = 0;
+                    GLuint endQuery = 0;
+                };
+
+                bool timerQueriesSupported = false;
+                std::vector<GpuZone> openGpuZones;
+                std::deque<GpuZone> pendingGpuZones;
+                std::vector<GLuint> timerQueries; // all the created queries
+                std::vector<GLuint> freeTimerQueries;
+#endif
+
                 std::vector<std::unique_ptr<RenderResource>> resources;
             };
         } // namespace opengl
@@ -168,6 +168,10 @@ namespace ouzel
                     }
                 }
 
+                // unused by the shaders that are not instanced
+                renderDevice.glBindAttribLocationProc(programId, RenderDevice::INSTANCE_TRANSFORM_LOCATION, "instanceTransform");
+                renderDevice.glBindAttribLocationProc(programId, RenderDevice::INSTANCE_OPACITY_LOCATION, "instanceOpacity");
+
                 renderDevice.glLinkProgramProc(programId);
 
                 renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
@@ -433,6 +433,31 @@ namespace ouzel
             return std::make_tuple(std::move(indices), std::move(vertices), fontTexture);
         }
 
+        bool BMFont::getGlyph(char32_t character, Glyph& glyph) const
+        {
+            auto iter = chars.find(character);
+
+            if (iter == chars.end())
+                return false;
+
+            const CharDescriptor& f = iter->second;
+
+            glyph.offset = Vector2F(f.xOffset, f.yOffset);
+            glyph.size = Vector2F(f.width, f.height);
+            glyph.leftTop = Vector2F(f.x / static_cast<float>(width),
+                                     f.y / static_cast<float>(height));
+            glyph.rightBottom = Vector2F((f.x + f.width) / static_cast<float>(width),
+                                         (f.y + f.height) / static_cast<float>(height));
+            glyph.advance = f.xAdvance;
+
+            return true;
+        }
+
+        float BMFont::getKerning(char32_t first, char32_t second) const
+        {
+            return static_cast<float>(getKerningPair(first, second));
+        }
+
         std::int16_t BMFont::getKerningPair(char32_t first, char32_t second) const
         {
             auto i = kern.find(std::make_pair(first, second));
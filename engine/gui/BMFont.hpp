@@ -20,6 +20,12 @@ namespace ouzel
                                      float fontSize,
                                      const Vector2F& anchor) const final;
 
+            bool isGlyphLayoutSupported() const noexcept final { return true; }
+            bool getGlyph(char32_t character, Glyph& glyph) const final;
+            float getKerning(char32_t first, char32_t second) const final;
+            float getLineHeight() const final { return static_cast<float>(lineHeight); }
+            std::shared_ptr<graphics::Texture> getTexture() const final { return fontTexture; }
+
             float getStringWidth(const std::string& text) const;
 
         private:
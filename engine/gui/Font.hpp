@@ -39,6 +39,23 @@ namespace ouzel
                                              Color color,
                                              float fontSize,
                                              const Vector2F& anchor) const = 0;
+
+            struct Glyph final
+            {
+                Vector2F offset; // from the pen position to the top left corner, in font units
+                Vector2F size;
+                Vector2F leftTop; // texture coordinates
+                Vector2F rightBottom;
+                float advance = 0.0F;
+            };
+
+            // Fonts that keep all their glyphs in a single texture can lay out the text glyph by glyph,
+            // which lets the text renderers re-layout only the edited part of the text
+            virtual bool isGlyphLayoutSupported() const noexcept { return false; }
+            virtual bool getGlyph(char32_t, Glyph&) const { return false; }
+            virtual float getKerning(char32_t, char32_t) const { return 0.0F; }
+            virtual float getLineHeight() const { return 0.0F; }
+            virtual std::shared_ptr<graphics::Texture> getTexture() const { return nullptr; }
         };
     } // namespace gui
 } // namespace ouzel
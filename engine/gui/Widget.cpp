@@ -1,19 +1,171 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "Widget.hpp"
+#include "Widgets.hpp"
+#include "core/Engine.hpp"
+#include "scene/Camera.hpp"
 
 namespace ouzel
 {
     namespace gui
     {
+        Widget::Widget():
+            eventHandler(EventHandler::PRIORITY_MAX + 1)
+        {
+        }
+
+        void Widget::draw(scene::Camera* camera, bool wireframe)
+        {
+            if (!menu || !menu->isBatched() || wireframe)
+            {
+                Actor::draw(camera, wireframe);
+                return;
+            }
+
+            // the rest of the components are drawn by the menu
+            const Matrix4F& worldTransform = getTransform();
+
+            for (scene::Component* component : components)
+            {
+                scene::Component::BatchData batchData;
+
+                if (!component->isHidden() && !isBatched(*component, batchData))
+                    component->draw(worldTransform,
+                                    opacity,
+                                    camera->getRenderViewProjection(),
+                                    wireframe);
+            }
+        }
+
+        void Widget::setPosition(const Vector2F& newPosition)
+        {
+            Actor::setPosition(newPosition);
+
+            if (menu) menu->navigationDirty = true;
+        }
+
+        void Widget::setPosition(const Vector3F& newPosition)
+        {
+            Actor::setPosition(newPosition);
+
+            if (menu) menu->navigationDirty = true;
+        }
+
+        void Widget::enter()
+        {
+            Actor::enter();
+
+            // the menu routes the UI events to its widgets
+            if (!menu && eventHandler.uiHandler)
+                engine->getEventDispatcher().addEventHandler(eventHandler);
+        }
+
+        void Widget::leave()
+        {
+            Actor::leave();
+
+            eventHandler.remove();
+        }
+
+        bool Widget::handleUI(const UIEvent&)
+        {
+            return false;
+        }
+
         void Widget::setEnabled(bool newEnabled)
         {
             enabled = newEnabled;
+            geometryDirty = true;
         }
 
         void Widget::setSelected(bool newSelected)
         {
             selected = newSelected;
+            geometryDirty = true;
+        }
+
+        bool Widget::isBatched(const scene::Component& component, scene::Component::BatchData& batchData) const
+        {
+            // the batches are drawn with the texture shader, so only the components that use it can be merged
+            return component.getBatchData(batchData) &&
+                batchData.shader == menu->batchShader &&
+                batchData.blendState &&
+                batchData.texture;
+        }
+
+        bool Widget::updateBatchGeometry()
+        {
+            const Matrix4F& worldTransform = getTransform();
+
+            if (!geometryDirty && !geometryAnimated &&
+                worldTransform == geometryTransform &&
+                opacity == geometryOpacity &&
+                isWorldHidden() == geometryHidden)
+                return false;
+
+            batchGeometry.clear();
+            geometryAnimated = false;
+
+            if (!isWorldHidden())
+                for (const scene::Component* component : components)
+                {
+                    scene::Component::BatchData batchData;
+                    if (component->isHidden() || !isBatched(*component, batchData)) continue;
+
+                    geometryAnimated = geometryAnimated || batchData.animated;
+
+                    auto geometry = std::find_if(batchGeometry.begin(), batchGeometry.end(),
+                                                 [&batchData](const BatchGeometry& other) noexcept {
+                                                     return other.texture == batchData.texture &&
+                                                         other.blendState == batchData.blendState;
+                                                 });
+
+                    if (geometry == batchGeometry.end())
+                    {
+                        BatchGeometry newGeometry;
+                        newGeometry.texture = batchData.texture;
+                        newGeometry.blendState = batchData.blendState;
+                        geometry = batchGeometry.insert(batchGeometry.end(), std::move(newGeometry));
+                    }
+
+                    // the transformation and the color are baked into the vertices
+                    const Matrix4F componentTransform = worldTransform * batchData.transform;
+                    const float color[] = {
+                        batchData.color.normR(),
+                        batchData.color.normG(),
+                        batchData.color.normB(),
+                        batchData.color.normA() * batchData.opacity * opacity
+                    };
+
+                    const auto firstVertex = static_cast<std::uint32_t>(geometry->vertices.size());
+
+                    for (std::size_t i = 0; i < batchData.vertexCount; ++i)
+                    {
+                        graphics::Vertex vertex = batchData.vertices[i];
+                        componentTransform.transformPoint(vertex.position);
+
+                        const float vertexColor[] = {
+                            vertex.color.normR() * color[0],
+                            vertex.color.normG() * color[1],
+                            vertex.color.normB() * color[2],
+                            vertex.color.normA() * color[3]
+                        };
+                        vertex.color = Color(vertexColor);
+
+                        geometry->vertices.push_back(vertex);
+                    }
+
+                    for (std::size_t i = 0; i < batchData.indexCount; ++i)
+                        geometry->indices.push_back(firstVertex + batchData.indices[i]);
+                }
+
+            geometryTransform = worldTransform;
+            geometryOpacity = opacity;
+            geometryHidden = isWorldHidden();
+            geometryDirty = false;
+
+            return true;
         }
     } // namespace gui
 } // namespace ouzel
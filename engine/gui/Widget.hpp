@@ -3,7 +3,12 @@
 #ifndef OUZEL_GUI_WIDGET_HPP
 #define OUZEL_GUI_WIDGET_HPP
 
+#include <cstdint>
+#include <vector>
 #include "scene/Actor.hpp"
+#include "scene/Component.hpp"
+#include "events/Event.hpp"
+#include "events/EventHandler.hpp"
 
 namespace ouzel
 {
@@ -15,21 +20,65 @@ namespace ouzel
         {
             friend Menu;
         public:
-            Widget() = default;
+            Widget();
+
+            void draw(scene::Camera* camera, bool wireframe) override;
 
             inline auto getMenu() const noexcept { return menu; }
 
+            void setPosition(const Vector2F& newPosition) override;
+            void setPosition(const Vector3F& newPosition) override;
+
             virtual void setEnabled(bool newEnabled);
             inline auto isEnabled() const noexcept { return enabled; }
 
             inline auto isSelected() const noexcept { return selected; }
 
+            // has to be called after the components are changed directly, so that a batched menu rebuilds the geometry
+            inline void invalidateGeometry() noexcept { geometryDirty = true; }
+
         protected:
             virtual void setSelected(bool newSelected);
 
+            void enter() override;
+            void leave() override;
+
+            // called by the event handler of the widget or, if the widget belongs to a menu, by the menu
+            virtual bool handleUI(const UIEvent& event);
+
+            // a menu in another menu gets the events of its own widgets from the outer menu
+            virtual bool isMenu() const noexcept { return false; }
+
+            // the handler is added to the dispatcher only if the widget is not in a menu
+            EventHandler eventHandler;
+
             Menu* menu = nullptr;
             bool enabled = true;
             bool selected = false;
+            bool geometryDirty = true;
+
+        private:
+            // world space geometry of the components that share a texture, blend state and shader
+            struct BatchGeometry final
+            {
+                const graphics::Texture* texture = nullptr;
+                const graphics::BlendState* blendState = nullptr;
+                std::vector<graphics::Vertex> vertices;
+                std::vector<std::uint32_t> indices;
+            };
+
+            bool isBatched(const scene::Component& component, scene::Component::BatchData& batchData) const;
+
+            // returns true if the geometry was rebuilt
+            bool updateBatchGeometry();
+
+            std::size_t menuIndex = 0; // position in the widget list of the menu
+
+            std::vector<BatchGeometry> batchGeometry;
+            Matrix4F geometryTransform;
+            float geometryOpacity = 1.0F;
+            bool geometryHidden = false;
+            bool geometryAnimated = false;
         };
     } // namespace gui
 } // namespace ouzel
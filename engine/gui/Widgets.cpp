@@ -4,12 +4,15 @@
 #  include <TargetConditionals.h>
 #endif
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <functional>
 #include "Widgets.hpp"
 #include "BMFont.hpp"
 #include "core/Engine.hpp"
 #include "events/EventHandler.hpp"
 #include "events/EventDispatcher.hpp"
+#include "graphics/Renderer.hpp"
 #include "math/Color.hpp"
 #include "scene/Layer.hpp"
 #include "scene/Camera.hpp"
@@ -18,11 +21,9 @@ namespace ouzel
 {
     namespace gui
     {
-        Button::Button():
-            eventHandler(EventHandler::PRIORITY_MAX + 1)
+        Button::Button()
         {
             eventHandler.uiHandler = std::bind(&Button::handleUI, this, std::placeholders::_1);
-            engine->getEventDispatcher().addEventHandler(eventHandler);
 
             pickable = true;
         }
@@ -38,14 +39,12 @@ namespace ouzel
                        Color initLabelSelectedColor,
                        Color initLabelPressedColor,
                        Color initLabelDisabledColor):
-            eventHandler(EventHandler::PRIORITY_MAX + 1),
             labelColor(initLabelColor),
             labelSelectedColor(initLabelSelectedColor),
             labelPressedColor(initLabelPressedColor),
             labelDisabledColor(initLabelDisabledColor)
         {
             eventHandler.uiHandler = std::bind(&Button::handleUI, this, std::placeholders::_1);
-            engine->getEventDispatcher().addEventHandler(eventHandler);
 
             if (!normalImage.empty())
             {
@@ -151,6 +150,8 @@ namespace ouzel
 
         void Button::updateSprite()
         {
+            geometryDirty = true;
+
             if (normalSprite) normalSprite->setHidden(true);
             if (selectedSprite) selectedSprite->setHidden(true);
             if (pressedSprite) pressedSprite->setHidden(true);
@@ -191,11 +192,9 @@ namespace ouzel
                            const std::string& selectedImage,
                            const std::string& pressedImage,
                            const std::string& disabledImage,
-                           const std::string& tickImage):
-            eventHandler(EventHandler::PRIORITY_MAX + 1)
+                           const std::string& tickImage)
         {
             eventHandler.uiHandler = std::bind(&CheckBox::handleUI, this, std::placeholders::_1);
-            engine->getEventDispatcher().addEventHandler(eventHandler);
 
             if (!normalImage.empty())
             {
@@ -312,6 +311,8 @@ namespace ouzel
 
         void CheckBox::updateSprite()
         {
+            geometryDirty = true;
+
             if (enabled)
             {
                 if (pressed && pointerOver && pressedSprite)
@@ -366,24 +367,136 @@ namespace ouzel
         {
             text = newText;
             labelDrawable->setText(text);
+            geometryDirty = true;
         }
 
         Menu::Menu():
-            eventHandler(EventHandler::PRIORITY_MAX + 1)
+            navigationHandler(EventHandler::PRIORITY_MAX + 1)
         {
-            eventHandler.keyboardHandler = std::bind(&Menu::handleKeyboard, this, std::placeholders::_1);
-            eventHandler.gamepadHandler = std::bind(&Menu::handleGamepad, this, std::placeholders::_1);
+            navigationHandler.keyboardHandler = std::bind(&Menu::handleKeyboard, this, std::placeholders::_1);
+            navigationHandler.gamepadHandler = std::bind(&Menu::handleGamepad, this, std::placeholders::_1);
             eventHandler.uiHandler = std::bind(&Menu::handleUI, this, std::placeholders::_1);
+
+            batchShader = engine->getCache().getShader(SHADER_TEXTURE);
+        }
+
+        void Menu::draw(scene::Camera* camera, bool wireframe)
+        {
+            Widget::draw(camera, wireframe);
+
+            if (!batched || wireframe) return;
+
+            for (Widget* widget : widgets)
+                if (widget->updateBatchGeometry())
+                    batchesDirty = true;
+
+            if (batchesDirty) updateBatches();
+
+            const Matrix4F& renderViewProjection = camera->getRenderViewProjection();
+            const float colorVector[] = {1.0F, 1.0F, 1.0F, 1.0F}; // the colors are in the vertices
+
+            for (const Batch& batch : batches)
+            {
+                if (batch.indices.empty()) continue;
+
+                std::vector<std::vector<float>> fragmentShaderConstants(1);
+                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+                std::vector<std::vector<float>> vertexShaderConstants(1);
+                vertexShaderConstants[0] = {std::begin(renderViewProjection.m), std::end(renderViewProjection.m)};
+
+                engine->getRenderer()->setPipelineState(batch.blendState->getResource(),
+                                                        batchShader->getResource(),
+                                                        graphics::CullMode::NoCull,
+                                                        graphics::FillMode::Solid);
+                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
+                                                          vertexShaderConstants);
+                engine->getRenderer()->setTextures({batch.texture->getResource()});
+                engine->getRenderer()->draw(batch.indexBuffer.getResource(),
+                                            static_cast<std::uint32_t>(batch.indices.size()),
+                                            sizeof(std::uint32_t),
+                                            batch.vertexBuffer.getResource(),
+                                            graphics::DrawMode::TriangleList,
+                                            0);
+            }
+        }
+
+        void Menu::setBatched(bool newBatched)
+        {
+            batched = newBatched;
+            batchesDirty = true;
+
+            // the menu itself has to be drawn even if it has no components
+            if (batched) cullDisabled = true;
+        }
+
+        void Menu::updateBatches()
+        {
+            for (Batch& batch : batches)
+            {
+                batch.vertices.clear();
+                batch.indices.clear();
+            }
+
+            // the widgets are merged in their order, so the batches are drawn in the order their textures first appear
+            for (const Widget* widget : widgets)
+                for (const BatchGeometry& geometry : widget->batchGeometry)
+                {
+                    auto batch = std::find_if(batches.begin(), batches.end(),
+                                              [&geometry](const Batch& other) noexcept {
+                                                  return other.texture == geometry.texture &&
+                                                      other.blendState == geometry.blendState;
+                                              });
+
+                    if (batch == batches.end())
+                    {
+                        Batch newBatch;
+                        newBatch.texture = geometry.texture;
+                        newBatch.blendState = geometry.blendState;
+                        newBatch.indexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                                                graphics::BufferType::Index,
+                                                                graphics::Flags::Dynamic);
+                        newBatch.vertexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                                                 graphics::BufferType::Vertex,
+                                                                 graphics::Flags::Dynamic);
+                        batch = batches.insert(batches.end(), std::move(newBatch));
+                    }
+
+                    const auto firstVertex = static_cast<std::uint32_t>(batch->vertices.size());
+                    batch->vertices.insert(batch->vertices.end(), geometry.vertices.begin(), geometry.vertices.end());
+
+                    for (std::uint32_t index : geometry.indices)
+                        batch->indices.push_back(firstVertex + index);
+                }
+
+            // the batches whose texture is no longer used are removed
+            batches.erase(std::remove_if(batches.begin(), batches.end(),
+                                         [](const Batch& batch) noexcept { return batch.indices.empty(); }),
+                          batches.end());
+
+            for (Batch& batch : batches)
+            {
+                batch.indexBuffer.setData(batch.indices.data(),
+                                          static_cast<std::uint32_t>(batch.indices.size() * sizeof(std::uint32_t)));
+                batch.vertexBuffer.setData(batch.vertices.data(),
+                                           static_cast<std::uint32_t>(batch.vertices.size() * sizeof(graphics::Vertex)));
+            }
+
+            batchesDirty = false;
         }
 
         void Menu::enter()
         {
-            engine->getEventDispatcher().addEventHandler(eventHandler);
+            Widget::enter();
+
+            engine->getEventDispatcher().addEventHandler(navigationHandler);
         }
 
         void Menu::leave()
         {
-            eventHandler.remove();
+            Widget::leave();
+
+            navigationHandler.remove();
         }
 
         void Menu::setEnabled(bool newEnabled)
@@ -395,12 +508,10 @@ namespace ouzel
                 if (!selectedWidget && !widgets.empty())
                     selectWidget(widgets.front());
             }
-            else
+            else if (selectedWidget)
             {
+                selectedWidget->setSelected(false);
                 selectedWidget = nullptr;
-
-                for (Widget* childWidget : widgets)
-                    childWidget->setSelected(false);
             }
         }
 
@@ -410,11 +521,19 @@ namespace ouzel
 
             if (widget)
             {
-                if (widget->menu)
+                if (widget->menu && widget->menu != this)
                     widget->menu->removeChild(widget);
 
+                // the menu routes the UI events to the widget
+                widget->eventHandler.remove();
+
                 widget->menu = this;
+                widget->menuIndex = widgets.size();
+                widget->geometryDirty = true;
+                widgetIndices[widget] = widget->menuIndex;
                 widgets.push_back(widget);
+                batchesDirty = true;
+                navigationDirty = true;
 
                 if (!selectedWidget)
                     selectWidget(widget);
@@ -423,18 +542,32 @@ namespace ouzel
 
         bool Menu::removeChild(const Actor* actor)
         {
-            auto i = std::find(widgets.begin(), widgets.end(), actor);
+            auto i = widgetIndices.find(actor);
 
-            if (i != widgets.end())
+            if (i != widgetIndices.end())
             {
-                Widget* widget = *i;
+                const std::size_t index = i->second;
+                Widget* widget = widgets[index];
+
+                if (selectedWidget == widget)
+                {
+                    widget->setSelected(false);
+                    selectedWidget = nullptr;
+                }
+
                 widget->menu = nullptr;
+                widgetIndices.erase(i);
 
-                widgets.erase(i);
-            }
+                widgets.erase(widgets.begin() + static_cast<std::ptrdiff_t>(index));
+                for (std::size_t n = index; n < widgets.size(); ++n)
+                {
+                    widgets[n]->menuIndex = n;
+                    widgetIndices[widgets[n]] = n;
+                }
 
-            if (selectedWidget == actor)
-                selectWidget(nullptr);
+                batchesDirty = true;
+                navigationDirty = true;
+            }
 
             if (!Actor::removeChild(actor))
                 return false;
@@ -446,68 +579,132 @@ namespace ouzel
         {
             if (!enabled) return;
 
+            if (selectedWidget)
+                selectedWidget->setSelected(false);
+
             selectedWidget = nullptr;
 
-            for (Widget* childWidget : widgets)
+            if (widget && widget->menu == this)
             {
-                if (childWidget == widget)
-                {
-                    selectedWidget = widget;
-                    childWidget->setSelected(true);
-                }
-                else
-                    childWidget->setSelected(false);
+                selectedWidget = widget;
+                widget->setSelected(true);
             }
         }
 
         void Menu::selectNextWidget()
         {
-            if (!enabled) return;
-
-            auto firstWidgetIterator = selectedWidget ?
-            std::find(widgets.begin(), widgets.end(), selectedWidget) :
-            widgets.end();
+            if (!enabled || widgets.empty()) return;
 
-            auto widgetIterator = firstWidgetIterator;
+            // starts from the first widget if none is selected
+            std::size_t index = selectedWidget ? selectedWidget->menuIndex : widgets.size() - 1;
 
-            do
+            for (std::size_t i = 0; i < widgets.size(); ++i)
             {
-                if (widgetIterator == widgets.end())
-                    widgetIterator = widgets.begin();
-                else
-                    ++widgetIterator;
+                index = (index + 1) % widgets.size();
 
-                if (widgetIterator != widgets.end() && (*widgetIterator)->isEnabled())
+                if (widgets[index]->isEnabled())
                 {
-                    selectWidget(*widgetIterator);
+                    selectWidget(widgets[index]);
                     break;
                 }
             }
-            while (widgetIterator != firstWidgetIterator);
         }
 
         void Menu::selectPreviousWidget()
         {
-            if (!enabled) return;
+            if (!enabled || widgets.empty()) return;
 
-            auto firstWidgetIterator = selectedWidget ?
-            std::find(widgets.begin(), widgets.end(), selectedWidget) :
-            widgets.end();
+            // starts from the last widget if none is selected
+            std::size_t index = selectedWidget ? selectedWidget->menuIndex : 0;
 
-            auto widgetIterator = firstWidgetIterator;
-
-            do
+            for (std::size_t i = 0; i < widgets.size(); ++i)
             {
-                if (widgetIterator == widgets.begin()) widgetIterator = widgets.end();
-                if (widgetIterator != widgets.begin()) --widgetIterator;
+                index = (index + widgets.size() - 1) % widgets.size();
 
-                if (widgetIterator != widgets.end() && (*widgetIterator)->isEnabled())
+                if (widgets[index]->isEnabled())
                 {
-                    selectWidget(*widgetIterator);
+                    selectWidget(widgets[index]);
                     break;
                 }
             }
-            while (widgetIterator != firstWidgetIterator);
+        }
+
+        void Menu::selectWidget(Direction direction)
+        {
+            if (!enabled) return;
+
+            if (selectedWidget)
+            {
+                if (navigationDirty) updateNavigation();
+
+                // the disabled widgets are skipped in the same direction
+                std::size_t index = selectedWidget->menuIndex;
+                for (std::size_t i = 0; i < widgets.size(); ++i)
+                {
+                    index = neighbors[index].widgets[static_cast<std::size_t>(direction)];
+                    if (index == Neighbors::NONE) break;
+
+                    if (widgets[index]->isEnabled())
+                    {
+                        selectWidget(widgets[index]);
+                        return;
+                    }
+                }
+            }
+
+            if (direction == Direction::Left || direction == Direction::Up)
+                selectPreviousWidget();
+            else
+                selectNextWidget();
+        }
+
+        void Menu::updateNavigation()
+        {
+            // the widgets are compared pairwise, but only when the layout changes
+            neighbors.assign(widgets.size(), Neighbors());
+
+            const Vector2F directions[] = {
+                Vector2F(-1.0F, 0.0F), // left
+                Vector2F(1.0F, 0.0F), // right
+                Vector2F(0.0F, 1.0F), // up
+                Vector2F(0.0F, -1.0F) // down
+            };
+
+            for (std::size_t i = 0; i < widgets.size(); ++i)
+            {
+                const Vector2F widgetPosition(widgets[i]->getPosition());
+                float bestScores[4] = {
+                    std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max()
+                };
+
+                for (std::size_t j = 0; j < widgets.size(); ++j)
+                {
+                    if (j == i) continue;
+
+                    const Vector2F offset = Vector2F(widgets[j]->getPosition()) - widgetPosition;
+
+                    for (std::size_t d = 0; d < 4; ++d)
+                    {
+                        const float distance = offset.dot(directions[d]);
+                        if (distance <= 0.0F) continue;
+
+                        // the widgets that are off the axis of the direction are penalized
+                        const float deviation = std::abs(offset.v[0] * directions[d].v[1] - offset.v[1] * directions[d].v[0]);
+                        const float score = distance + deviation * 2.0F;
+
+                        if (score < bestScores[d])
+                        {
+                            bestScores[d] = score;
+                            neighbors[i].widgets[d] = j;
+                        }
+                    }
+                }
+            }
+
+            navigationDirty = false;
         }
 
         bool Menu::handleKeyboard(const KeyboardEvent& event)
@@ -519,12 +716,16 @@ namespace ouzel
                 switch (event.key)
                 {
                     case input::Keyboard::Key::Left:
-                    case input::Keyboard::Key::Up:
-                        selectPreviousWidget();
+                        selectWidget(Direction::Left);
                         break;
                     case input::Keyboard::Key::Right:
+                        selectWidget(Direction::Right);
+                        break;
+                    case input::Keyboard::Key::Up:
+                        selectWidget(Direction::Up);
+                        break;
                     case input::Keyboard::Key::Down:
-                        selectNextWidget();
+                        selectWidget(Direction::Down);
                         break;
                     case input::Keyboard::Key::Enter:
                     case input::Keyboard::Key::Space:
@@ -554,25 +755,37 @@ namespace ouzel
 
             if (event.type == Event::Type::GamepadButtonChange)
             {
-                if (event.button == input::Gamepad::Button::DpadLeft ||
-                    event.button == input::Gamepad::Button::DpadUp)
+                if (event.button == input::Gamepad::Button::DpadLeft)
+                {
+                    if (!event.previousPressed && event.pressed) selectWidget(Direction::Left);
+                }
+                else if (event.button == input::Gamepad::Button::DpadRight)
                 {
-                    if (!event.previousPressed && event.pressed) selectPreviousWidget();
+                    if (!event.previousPressed && event.pressed) selectWidget(Direction::Right);
                 }
-                else if (event.button == input::Gamepad::Button::DpadRight ||
-                         event.button == input::Gamepad::Button::DpadDown)
+                else if (event.button == input::Gamepad::Button::DpadUp)
                 {
-                    if (!event.previousPressed && event.pressed) selectNextWidget();
+                    if (!event.previousPressed && event.pressed) selectWidget(Direction::Up);
                 }
-                else if (event.button == input::Gamepad::Button::LeftThumbLeft ||
-                         event.button == input::Gamepad::Button::LeftThumbUp)
+                else if (event.button == input::Gamepad::Button::DpadDown)
                 {
-                    if (event.previousValue < 0.6F && event.value > 0.6F) selectPreviousWidget();
+                    if (!event.previousPressed && event.pressed) selectWidget(Direction::Down);
                 }
-                else if (event.button == input::Gamepad::Button::LeftThumbRight ||
-                         event.button == input::Gamepad::Button::LeftThumbDown)
+                else if (event.button == input::Gamepad::Button::LeftThumbLeft)
                 {
-                    if (event.previousValue < 0.6F && event.value > 0.6F) selectNextWidget();
+                    if (event.previousValue < 0.6F && event.value > 0.6F) selectWidget(Direction::Left);
+                }
+                else if (event.button == input::Gamepad::Button::LeftThumbRight)
+                {
+                    if (event.previousValue < 0.6F && event.value > 0.6F) selectWidget(Direction::Right);
+                }
+                else if (event.button == input::Gamepad::Button::LeftThumbUp)
+                {
+                    if (event.previousValue < 0.6F && event.value > 0.6F) selectWidget(Direction::Up);
+                }
+                else if (event.button == input::Gamepad::Button::LeftThumbDown)
+                {
+                    if (event.previousValue < 0.6F && event.value > 0.6F) selectWidget(Direction::Down);
                 }
 #if !defined(__APPLE__) || (!TARGET_OS_IOS && !TARGET_OS_TV) // on iOS and tvOS menu items ar selected with a SELECT button
                 else if (event.button == input::Gamepad::Button::FaceBottom)
@@ -592,15 +805,26 @@ namespace ouzel
             return false;
         }
 
+        // the events of the widgets are routed by their menu instead of every widget having its own handler
         bool Menu::handleUI(const UIEvent& event)
         {
-            if (!enabled) return false;
+            auto i = widgetIndices.find(event.actor);
+            if (i == widgetIndices.end())
+            {
+                // the widgets of nested menus are routed through them
+                for (Widget* widget : widgets)
+                    if (widget->isMenu() && static_cast<Menu*>(widget)->handleUI(event))
+                        return true;
+
+                return false;
+            }
 
-            if (event.type == Event::Type::ActorEnter)
-                if (std::find(widgets.begin(), widgets.end(), event.actor) != widgets.end())
-                    selectWidget(static_cast<Widget*>(event.actor));
+            Widget* widget = widgets[i->second];
 
-            return false;
+            if (enabled && event.type == Event::Type::ActorEnter)
+                selectWidget(widget);
+
+            return widget->handleUI(event);
         }
 
         RadioButton::RadioButton()
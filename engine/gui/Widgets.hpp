@@ -4,6 +4,7 @@
 #define OUZEL_GUI_BUTTON_HPP
 
 #include <functional>
+#include <unordered_map>
 #include "gui/Widget.hpp"
 #include "scene/SpriteRenderer.hpp"
 #include "scene/TextRenderer.hpp"
@@ -42,7 +43,7 @@ namespace ouzel
         private:
             void setSelected(bool newSelected) override;
 
-            bool handleUI(const UIEvent& event);
+            bool handleUI(const UIEvent& event) override;
 
             void updateSprite();
 
@@ -52,8 +53,6 @@ namespace ouzel
             std::unique_ptr<scene::SpriteRenderer> disabledSprite;
             std::unique_ptr<scene::TextRenderer> labelDrawable;
 
-            EventHandler eventHandler;
-
             bool pointerOver = false;
             bool pressed = false;
 
@@ -83,7 +82,7 @@ namespace ouzel
             inline auto getDisabledSprite() const noexcept { return disabledSprite.get(); }
 
         private:
-            bool handleUI(const UIEvent& event);
+            bool handleUI(const UIEvent& event) override;
 
             void updateSprite();
 
@@ -93,8 +92,6 @@ namespace ouzel
             std::unique_ptr<scene::SpriteRenderer> disabledSprite;
             std::unique_ptr<scene::SpriteRenderer> tickSprite;
 
-            EventHandler eventHandler;
-
             bool pointerOver = false;
             bool pressed = false;
             bool checked = false;
@@ -139,11 +136,27 @@ namespace ouzel
 
         class Menu: public Widget
         {
+            friend Widget;
         public:
+            enum class Direction
+            {
+                Left,
+                Right,
+                Up,
+                Down
+            };
+
             Menu();
 
+            void draw(scene::Camera* camera, bool wireframe) override;
+
             void setEnabled(bool newEnabled) override;
 
+            // a batched menu draws the sprites and the labels of all its widgets with one draw call per texture
+            // and only rebuilds the geometry of the widgets that changed, the widgets are not culled separately
+            void setBatched(bool newBatched);
+            inline auto isBatched() const noexcept { return batched; }
+
             bool removeChild(const Actor* actor) override;
 
             void addWidget(Widget* widget);
@@ -152,18 +165,55 @@ namespace ouzel
             void selectNextWidget();
             void selectPreviousWidget();
 
+            // selects the closest enabled widget in the direction from the selected one,
+            // falls back to the previous (left and up) or the next (right and down) widget
+            void selectWidget(Direction direction);
+
         protected:
             void enter() override;
             void leave() override;
 
             bool handleKeyboard(const KeyboardEvent& event);
             bool handleGamepad(const GamepadEvent& event);
-            bool handleUI(const UIEvent& event);
+            bool handleUI(const UIEvent& event) override;
+            bool isMenu() const noexcept override { return true; }
 
             std::vector<Widget*> widgets;
+            std::unordered_map<const Actor*, std::size_t> widgetIndices;
             Widget* selectedWidget = nullptr;
 
-            EventHandler eventHandler;
+            // handles the keyboard and the gamepad even if the menu is in another menu
+            EventHandler navigationHandler;
+
+        private:
+            void updateBatches();
+            void updateNavigation();
+
+            // indices of the closest widgets in every direction, for directional navigation
+            struct Neighbors final
+            {
+                static constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+                std::size_t widgets[4] = {NONE, NONE, NONE, NONE};
+            };
+
+            std::vector<Neighbors> neighbors;
+            bool navigationDirty = true;
+
+            struct Batch final
+            {
+                const graphics::Texture* texture = nullptr;
+                const graphics::BlendState* blendState = nullptr;
+                std::vector<graphics::Vertex> vertices;
+                std::vector<std::uint32_t> indices;
+                graphics::Buffer indexBuffer;
+                graphics::Buffer vertexBuffer;
+            };
+
+            bool batched = false;
+            bool batchesDirty = true;
+            const graphics::Shader* batchShader = nullptr;
+            std::vector<Batch> batches;
         };
 
         class RadioButton: public Widget
@@ -14,7 +14,7 @@ namespace ouzel
             deviceConnectEvent.type = InputSystem::Event::Type::DeviceConnect;
             deviceConnectEvent.deviceId = id;
             deviceConnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceConnectEvent);
+            inputSystem.postEvent(deviceConnectEvent);
         }
 
         GamepadDevice::~GamepadDevice()
@@ -23,10 +23,10 @@ namespace ouzel
             deviceDisconnectEvent.type = InputSystem::Event::Type::DeviceDisconnect;
             deviceDisconnectEvent.deviceId = id;
             deviceDisconnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceDisconnectEvent);
+            inputSystem.postEvent(deviceDisconnectEvent);
         }
 
-        std::future<bool> GamepadDevice::handleButtonValueChange(Gamepad::Button button, bool pressed, float value)
+        void GamepadDevice::handleButtonValueChange(Gamepad::Button button, bool pressed, float value)
         {
             InputSystem::Event event(InputSystem::Event::Type::GamepadButtonChange);
             event.deviceId = id;
@@ -34,7 +34,7 @@ namespace ouzel
             event.pressed = pressed;
             event.value = value;
 
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
     } // namespace input
 } // namespace ouzel
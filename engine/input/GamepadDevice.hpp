@@ -3,7 +3,6 @@
 #ifndef OUZEL_INPUT_GAMEPADDEVICE_HPP
 #define OUZEL_INPUT_GAMEPADDEVICE_HPP
 
-#include <future>
 #include "input/InputDevice.hpp"
 #include "input/Gamepad.hpp"
 
@@ -17,7 +16,7 @@ namespace ouzel
             GamepadDevice(InputSystem& initInputSystem, DeviceId initId);
             ~GamepadDevice() override;
 
-            std::future<bool> handleButtonValueChange(Gamepad::Button button, bool pressed, float value);
+            void handleButtonValueChange(Gamepad::Button button, bool pressed, float value);
         };
     } // namespace input
 } // namespace ouzel
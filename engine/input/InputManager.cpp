@@ -4,6 +4,7 @@
 #  include <TargetConditionals.h>
 #endif
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include "InputManager.hpp"
 #include "Gamepad.hpp"
@@ -35,52 +36,147 @@ namespace ouzel
     namespace input
     {
         InputManager::InputManager():
+            eventSlots(createEventSlots()),
 #if TARGET_OS_IOS
-            inputSystem(std::make_unique<InputSystemIOS>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemIOS>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #elif TARGET_OS_TV
-            inputSystem(std::make_unique<InputSystemTVOS>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemTVOS>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #elif TARGET_OS_MAC
-            inputSystem(std::make_unique<InputSystemMacOS>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemMacOS>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #elif defined(__ANDROID__)
-            inputSystem(std::make_unique<InputSystemAndroid>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemAndroid>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #elif defined(__linux__)
-            inputSystem(std::make_unique<InputSystemLinux>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemLinux>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #elif defined(_WIN32)
-            inputSystem(std::make_unique<InputSystemWin>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemWin>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #elif defined(__EMSCRIPTEN__)
-            inputSystem(std::make_unique<InputSystemEm>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystemEm>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #else
-            inputSystem(std::make_unique<InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(std::make_unique<InputSystem>(std::bind(&InputManager::eventCallback, this, std::placeholders::_1, std::placeholders::_2)))
 #endif
         {
         }
 
+        std::unique_ptr<InputManager::EventSlot[]> InputManager::createEventSlots()
+        {
+            std::unique_ptr<EventSlot[]> slots(new EventSlot[EVENT_QUEUE_SIZE]);
+
+            for (std::size_t i = 0; i < EVENT_QUEUE_SIZE; ++i)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+
+            return slots;
+        }
+
         void InputManager::update()
         {
-            std::pair<std::promise<bool>, InputSystem::Event> p;
+            QueuedEvent queuedEvent;
 
-            for (;;)
+            while (tryPopEvent(queuedEvent))
+                eventBatch.push_back(std::move(queuedEvent));
+
+            if (overflowing)
+            {
+                std::lock_guard<std::mutex> lock(overflowMutex);
+
+                // events that made it into the ring before it got full precede the overflow
+                while (tryPopEvent(queuedEvent))
+                    eventBatch.push_back(std::move(queuedEvent));
+
+                std::move(overflowEvents.begin(), overflowEvents.end(), std::back_inserter(eventBatch));
+                overflowEvents.clear();
+                overflowing = false;
+            }
+
+            for (std::size_t i = 0; i < eventBatch.size(); ++i)
+            {
+                QueuedEvent& current = eventBatch[i];
+
+                if (coalesceMoveEvents && !current.promise && i + 1 < eventBatch.size())
+                {
+                    const InputSystem::Event& next = eventBatch[i + 1].event;
+
+                    if (current.event.type == next.type &&
+                        current.event.deviceId == next.deviceId &&
+                        (current.event.type == InputSystem::Event::Type::MouseMove ||
+                         (current.event.type == InputSystem::Event::Type::TouchMove &&
+                          current.event.touchId == next.touchId)))
+                        continue; // superseded by the next move
+                }
+
+                const bool handled = handleEvent(current.event);
+                if (current.promise) current.promise->set_value(handled);
+            }
+
+            eventBatch.clear();
+        }
+
+        std::future<bool> InputManager::eventCallback(const InputSystem::Event& event, bool needsResult)
+        {
+            QueuedEvent queuedEvent;
+            queuedEvent.event = event;
+
+            std::future<bool> result;
+
+            if (needsResult)
             {
-                std::unique_lock<std::mutex> lock(eventQueueMutex);
-                if (eventQueue.empty()) break;
+                queuedEvent.promise = std::make_unique<std::promise<bool>>();
+                result = queuedEvent.promise->get_future();
+            }
+
+            pushEvent(queuedEvent);
 
-                p = std::move(eventQueue.front());
-                eventQueue.pop();
-                lock.unlock();
+            return result;
+        }
+
+        void InputManager::pushEvent(QueuedEvent& queuedEvent)
+        {
+            if (!overflowing && tryPushEvent(queuedEvent))
+                return;
+
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            overflowing = true;
+            overflowEvents.push_back(std::move(queuedEvent));
+        }
 
-                p.first.set_value(handleEvent(p.second));
+        bool InputManager::tryPushEvent(QueuedEvent& queuedEvent) noexcept
+        {
+            std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                EventSlot& slot = eventSlots[position & (EVENT_QUEUE_SIZE - 1)];
+                const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+                if (difference == 0)
+                {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.queuedEvent = std::move(queuedEvent);
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0) // the ring is full
+                    return false;
+                else
+                    position = enqueuePosition.load(std::memory_order_relaxed);
             }
         }
 
-        std::future<bool> InputManager::eventCallback(const InputSystem::Event& event)
+        bool InputManager::tryPopEvent(QueuedEvent& queuedEvent) noexcept
         {
-            std::pair<std::promise<bool>, InputSystem::Event> p(std::promise<bool>(), event);
-            std::future<bool> f = p.first.get_future();
+            EventSlot& slot = eventSlots[dequeuePosition & (EVENT_QUEUE_SIZE - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+            if (sequence != dequeuePosition + 1) // not published yet
+                return false;
 
-            std::lock_guard<std::mutex> lock(eventQueueMutex);
-            eventQueue.push(std::move(p));
+            queuedEvent = std::move(slot.queuedEvent);
+            slot.sequence.store(dequeuePosition + EVENT_QUEUE_SIZE, std::memory_order_release);
+            ++dequeuePosition;
 
-            return f;
+            return true;
         }
 
         bool InputManager::handleEvent(const InputSystem::Event& event)
@@ -3,9 +3,10 @@
 #ifndef OUZEL_INPUT_INPUTMANAGER_HPP
 #define OUZEL_INPUT_INPUTMANAGER_HPP
 
+#include <atomic>
+#include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <vector>
 #include <unordered_map>
 #include "input/InputSystem.hpp"
@@ -45,12 +46,45 @@ namespace ouzel
             void showVirtualKeyboard();
             void hideVirtualKeyboard();
 
+            // merge consecutive mouse and touch move events of the same device into the last one
+            inline auto isCoalescingMoveEvents() const noexcept { return coalesceMoveEvents; }
+            inline void setCoalesceMoveEvents(bool coalesce) noexcept { coalesceMoveEvents = coalesce; }
+
         private:
-            std::future<bool> eventCallback(const InputSystem::Event& event);
+            struct QueuedEvent final
+            {
+                InputSystem::Event event;
+                std::unique_ptr<std::promise<bool>> promise; // only set for events that need a result
+            };
+
+            struct EventSlot final
+            {
+                std::atomic<std::size_t> sequence;
+                QueuedEvent queuedEvent;
+            };
+
+            static constexpr std::size_t EVENT_QUEUE_SIZE = 4096; // must be a power of two
+
+            static std::unique_ptr<EventSlot[]> createEventSlots();
+
+            std::future<bool> eventCallback(const InputSystem::Event& event, bool needsResult);
+            void pushEvent(QueuedEvent& queuedEvent);
+            bool tryPushEvent(QueuedEvent& queuedEvent) noexcept;
+            bool tryPopEvent(QueuedEvent& queuedEvent) noexcept;
             bool handleEvent(const InputSystem::Event& event);
 
-            std::mutex eventQueueMutex;
-            std::queue<std::pair<std::promise<bool>, InputSystem::Event>> eventQueue;
+            // bounded multi-producer single-consumer ring of events
+            std::unique_ptr<EventSlot[]> eventSlots;
+            std::atomic<std::size_t> enqueuePosition{0};
+            std::size_t dequeuePosition = 0;
+
+            // used only when the ring is full, until the next update drains it
+            std::mutex overflowMutex;
+            std::vector<QueuedEvent> overflowEvents;
+            std::atomic_bool overflowing{false};
+
+            std::vector<QueuedEvent> eventBatch;
+            bool coalesceMoveEvents = false;
 
             std::unique_ptr<InputSystem> inputSystem;
             Keyboard* keyboard = nullptr;
@@ -8,19 +8,54 @@ namespace ouzel
 {
     namespace input
     {
-        InputSystem::InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystem::InputSystem(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             callback(initCallback)
         {
         }
 
         void InputSystem::addCommand(const Command& command)
         {
-            engine->executeOnMainThread(std::bind(&InputSystem::executeCommand, this, command));
+            // commands are dropped while the engine is not running, same as executeOnMainThread does
+            if (!engine->isActive()) return;
+
+            std::unique_lock<std::mutex> lock(commandQueueMutex);
+            commandQueue.push_back(command);
+
+            // only the first command of a batch schedules the execution on the main thread
+            if (executeScheduled) return;
+            executeScheduled = true;
+            lock.unlock();
+
+            if (!engine->executeOnMainThread(std::bind(&InputSystem::executeCommands, this)))
+            {
+                // the execution was dropped, so the next command has to schedule it again
+                lock.lock();
+                commandQueue.clear();
+                executeScheduled = false;
+            }
+        }
+
+        void InputSystem::executeCommands()
+        {
+            std::unique_lock<std::mutex> lock(commandQueueMutex);
+            std::swap(commandQueue, executingCommands);
+            executeScheduled = false;
+            lock.unlock();
+
+            for (const Command& command : executingCommands)
+                executeCommand(command);
+
+            executingCommands.clear();
         }
 
         std::future<bool> InputSystem::sendEvent(const Event& event)
         {
-            return callback(event);
+            return callback(event, true);
+        }
+
+        void InputSystem::postEvent(const Event& event)
+        {
+            callback(event, false);
         }
 
         void InputSystem::addInputDevice(InputDevice& inputDevice)
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <future>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <vector>
@@ -126,9 +127,10 @@ namespace ouzel
                 float force = 1.0F;
             };
 
-            explicit InputSystem(const std::function<std::future<bool>(const Event&)>& initCallback);
+            explicit InputSystem(const std::function<std::future<bool>(const Event&, bool)>& initCallback);
             virtual ~InputSystem() = default;
 
+            // commands are batched and executed on the main thread
             void addCommand(const Command& command);
             virtual void executeCommand(const Command&) {}
 
@@ -152,13 +154,23 @@ namespace ouzel
             }
 
         protected:
+            // sends an event and returns whether it was handled
             std::future<bool> sendEvent(const Event& event);
+            // sends an event whose result is not needed, without allocating a promise
+            void postEvent(const Event& event);
             void addInputDevice(InputDevice& inputDevice);
             void removeInputDevice(const InputDevice& inputDevice);
             InputDevice* getInputDevice(DeviceId id);
 
         private:
-            std::function<std::future<bool>(const Event&)> callback;
+            void executeCommands();
+
+            std::function<std::future<bool>(const Event&, bool)> callback;
+
+            std::mutex commandQueueMutex;
+            std::vector<Command> commandQueue;
+            std::vector<Command> executingCommands;
+            bool executeScheduled = false; // guarded by commandQueueMutex
             std::unordered_map<DeviceId, InputDevice*> inputDevices;
 
             std::uintptr_t lastResourceId = 0;
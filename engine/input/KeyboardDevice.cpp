@@ -14,7 +14,7 @@ namespace ouzel
             deviceConnectEvent.type = InputSystem::Event::Type::DeviceConnect;
             deviceConnectEvent.deviceId = id;
             deviceConnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceConnectEvent);
+            inputSystem.postEvent(deviceConnectEvent);
         }
 
         KeyboardDevice::~KeyboardDevice()
@@ -23,7 +23,7 @@ namespace ouzel
             deviceDisconnectEvent.type = InputSystem::Event::Type::DeviceDisconnect;
             deviceDisconnectEvent.deviceId = id;
             deviceDisconnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceDisconnectEvent);
+            inputSystem.postEvent(deviceDisconnectEvent);
         }
 
         std::future<bool> KeyboardDevice::handleKeyPress(Keyboard::Key key)
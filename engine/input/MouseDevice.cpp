@@ -14,7 +14,7 @@ namespace ouzel
             deviceConnectEvent.type = InputSystem::Event::Type::DeviceConnect;
             deviceConnectEvent.deviceId = id;
             deviceConnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceConnectEvent);
+            inputSystem.postEvent(deviceConnectEvent);
         }
 
         MouseDevice::~MouseDevice()
@@ -23,58 +23,58 @@ namespace ouzel
             deviceDisconnectEvent.type = InputSystem::Event::Type::DeviceDisconnect;
             deviceDisconnectEvent.deviceId = id;
             deviceDisconnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceDisconnectEvent);
+            inputSystem.postEvent(deviceDisconnectEvent);
         }
 
-        std::future<bool> MouseDevice::handleButtonPress(Mouse::Button button, const Vector2F& position)
+        void MouseDevice::handleButtonPress(Mouse::Button button, const Vector2F& position)
         {
             InputSystem::Event event(InputSystem::Event::Type::MousePress);
             event.deviceId = id;
             event.mouseButton = button;
             event.position = position;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> MouseDevice::handleButtonRelease(Mouse::Button button, const Vector2F& position)
+        void MouseDevice::handleButtonRelease(Mouse::Button button, const Vector2F& position)
         {
             InputSystem::Event event(InputSystem::Event::Type::MouseRelease);
             event.deviceId = id;
             event.mouseButton = button;
             event.position = position;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> MouseDevice::handleMove(const Vector2F& position)
+        void MouseDevice::handleMove(const Vector2F& position)
         {
             InputSystem::Event event(InputSystem::Event::Type::MouseMove);
             event.deviceId = id;
             event.position = position;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> MouseDevice::handleRelativeMove(const Vector2F& position)
+        void MouseDevice::handleRelativeMove(const Vector2F& position)
         {
             InputSystem::Event event(InputSystem::Event::Type::MouseRelativeMove);
             event.deviceId = id;
             event.position = position;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> MouseDevice::handleScroll(const Vector2F& scroll, const Vector2F& position)
+        void MouseDevice::handleScroll(const Vector2F& scroll, const Vector2F& position)
         {
             InputSystem::Event event(InputSystem::Event::Type::MouseScroll);
             event.deviceId = id;
             event.position = position;
             event.scroll = scroll;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> MouseDevice::handleCursorLockChange(bool locked)
+        void MouseDevice::handleCursorLockChange(bool locked)
         {
             InputSystem::Event event(InputSystem::Event::Type::MouseLockChanged);
             event.deviceId = id;
             event.locked = locked;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
     } // namespace input
 } // namespace ouzel
@@ -3,7 +3,6 @@
 #ifndef OUZEL_INPUT_MOUSEDEVICE_HPP
 #define OUZEL_INPUT_MOUSEDEVICE_HPP
 
-#include <future>
 #include "input/InputDevice.hpp"
 #include "input/Mouse.hpp"
 
@@ -17,12 +16,12 @@ namespace ouzel
             MouseDevice(InputSystem& initInputSystem, DeviceId initId);
             ~MouseDevice() override;
 
-            std::future<bool> handleButtonPress(Mouse::Button button, const Vector2F& position);
-            std::future<bool> handleButtonRelease(Mouse::Button button, const Vector2F& position);
-            std::future<bool> handleMove(const Vector2F& position);
-            std::future<bool> handleRelativeMove(const Vector2F& position);
-            std::future<bool> handleScroll(const Vector2F& scroll, const Vector2F& position);
-            std::future<bool> handleCursorLockChange(bool locked);
+            void handleButtonPress(Mouse::Button button, const Vector2F& position);
+            void handleButtonRelease(Mouse::Button button, const Vector2F& position);
+            void handleMove(const Vector2F& position);
+            void handleRelativeMove(const Vector2F& position);
+            void handleScroll(const Vector2F& scroll, const Vector2F& position);
+            void handleCursorLockChange(bool locked);
         };
     } // namespace input
 } // namespace ouzel
@@ -15,7 +15,7 @@ namespace ouzel
             deviceConnectEvent.deviceId = id;
             deviceConnectEvent.deviceType = type;
             deviceConnectEvent.screen = screen;
-            inputSystem.sendEvent(deviceConnectEvent);
+            inputSystem.postEvent(deviceConnectEvent);
         }
 
         TouchpadDevice::~TouchpadDevice()
@@ -24,47 +24,47 @@ namespace ouzel
             deviceDisconnectEvent.type = InputSystem::Event::Type::DeviceDisconnect;
             deviceDisconnectEvent.deviceId = id;
             deviceDisconnectEvent.deviceType = type;
-            inputSystem.sendEvent(deviceDisconnectEvent);
+            inputSystem.postEvent(deviceDisconnectEvent);
         }
 
-        std::future<bool> TouchpadDevice::handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force)
+        void TouchpadDevice::handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force)
         {
             InputSystem::Event event(InputSystem::Event::Type::TouchBegin);
             event.deviceId = id;
             event.touchId = touchId;
             event.position = position;
             event.force = force;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> TouchpadDevice::handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force)
+        void TouchpadDevice::handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force)
         {
             InputSystem::Event event(InputSystem::Event::Type::TouchEnd);
             event.deviceId = id;
             event.touchId = touchId;
             event.position = position;
             event.force = force;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> TouchpadDevice::handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force)
+        void TouchpadDevice::handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force)
         {
             InputSystem::Event event(InputSystem::Event::Type::TouchMove);
             event.deviceId = id;
             event.touchId = touchId;
             event.position = position;
             event.force = force;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
 
-        std::future<bool> TouchpadDevice::handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force)
+        void TouchpadDevice::handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force)
         {
             InputSystem::Event event(InputSystem::Event::Type::TouchCancel);
             event.deviceId = id;
             event.touchId = touchId;
             event.position = position;
             event.force = force;
-            return inputSystem.sendEvent(event);
+            inputSystem.postEvent(event);
         }
     } // namespace input
 } // namespace ouzel
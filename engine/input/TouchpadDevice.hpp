@@ -3,7 +3,6 @@
 #ifndef OUZEL_INPUT_TOUCHPADDEVICE_HPP
 #define OUZEL_INPUT_TOUCHPADDEVICE_HPP
 
-#include <future>
 #include "input/InputDevice.hpp"
 #include "math/Vector.hpp"
 
@@ -17,10 +16,10 @@ namespace ouzel
             TouchpadDevice(InputSystem& initInputSystem, DeviceId initId, bool screen);
             ~TouchpadDevice() override;
 
-            std::future<bool> handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
-            std::future<bool> handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
-            std::future<bool> handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
-            std::future<bool> handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
+            void handleTouchBegin(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
+            void handleTouchEnd(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
+            void handleTouchMove(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
+            void handleTouchCancel(std::uint64_t touchId, const Vector2F& position, float force = 1.0F);
         };
     } // namespace input
 } // namespace ouzel
@@ -12,7 +12,7 @@ namespace ouzel
 {
     namespace input
     {
-        InputSystemAndroid::InputSystemAndroid(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystemAndroid::InputSystemAndroid(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
             mouseDevice(std::make_unique<MouseDevice>(*this, getNextDeviceId())),
@@ -15,7 +15,7 @@ namespace ouzel
         class InputSystemAndroid final: public InputSystem
         {
         public:
-            explicit InputSystemAndroid(const std::function<std::future<bool>(const Event&)>& initCallback);
+            explicit InputSystemAndroid(const std::function<std::future<bool>(const Event&, bool)>& initCallback);
             ~InputSystemAndroid() override;
 
             void executeCommand(const Command& command) final;
@@ -300,7 +300,7 @@ namespace ouzel
 {
     namespace input
     {
-        InputSystemEm::InputSystemEm(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystemEm::InputSystemEm(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
             mouseDevice(std::make_unique<MouseDeviceEm>(*this, getNextDeviceId())),
@@ -19,7 +19,7 @@ namespace ouzel
         class InputSystemEm final: public InputSystem
         {
         public:
-            InputSystemEm(const std::function<std::future<bool>(const Event&)>& initCallback);
+            InputSystemEm(const std::function<std::future<bool>(const Event&, bool)>& initCallback);
 
             void executeCommand(const Command& command) final;
 
@@ -25,7 +25,7 @@ namespace ouzel
         class InputSystemIOS final: public InputSystem
         {
         public:
-            InputSystemIOS(const std::function<std::future<bool>(const Event&)>& initCallback);
+            InputSystemIOS(const std::function<std::future<bool>(const Event&, bool)>& initCallback);
             ~InputSystemIOS() override;
 
             void executeCommand(const Command& command) final;
@@ -38,7 +38,7 @@ namespace ouzel
 {
     namespace input
     {
-        InputSystemIOS::InputSystemIOS(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystemIOS::InputSystemIOS(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
             touchpadDevice(std::make_unique<TouchpadDevice>(*this, getNextDeviceId(), true))
@@ -119,7 +119,7 @@ namespace ouzel
 
         void InputSystemIOS::handleGamepadDiscoveryCompleted()
         {
-            sendEvent(Event(Event::Type::DeviceDiscoveryComplete));
+            postEvent(Event(Event::Type::DeviceDiscoveryComplete));
         }
 
         void InputSystemIOS::handleGamepadConnected(GCControllerPtr controller)
@@ -226,13 +226,15 @@ namespace ouzel
         EventDevice::EventDevice(InputSystemLinux& inputSystem, const std::string& initFilename):
             filename(initFilename)
         {
-            fd = open(filename.c_str(), O_RDONLY);
+            fd = open(filename.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
 
             if (fd == -1)
                 throw std::system_error(errno, std::system_category(), "Failed to open device file");
 
             if (ioctl(fd, EVIOCGRAB, 1) == -1)
                 engine->log(Log::Level::Warning) << "Failed to grab device";
+            else
+                grabbed = true;
 
             char deviceName[256];
             if (ioctl(fd, EVIOCGNAME(sizeof(deviceName) - 1), deviceName) == -1)
@@ -252,7 +254,11 @@ namespace ouzel
                 ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) == -1 ||
                 ioctl(fd, EVIOCGBIT(EV_REL, sizeof(relBits)), relBits) == -1 ||
                 ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) == -1)
-                throw std::system_error(errno, std::system_category(), "Failed to get device event bits");
+            {
+                // not an event device (e.g. a pipe), it is still watched for removal but produces no input
+                engine->log(Log::Level::Warning) << "Failed to get event bits of " << filename << ", ignoring its input";
+                return;
+            }
 
             if (isBitSet(eventBits, EV_KEY) && (
                     isBitSet(keyBits, KEY_1) ||
@@ -400,28 +406,40 @@ namespace ouzel
 
         EventDevice::~EventDevice()
         {
-            if (fd != -1)
-            {
-                if (ioctl(fd, EVIOCGRAB, 0) == -1)
-                    engine->log(Log::Level::Warning) << "Failed to release device";
-
-                close(fd);
-            }
+            if (grabbed && ioctl(fd, EVIOCGRAB, 0) == -1)
+                engine->log(Log::Level::Warning) << "Failed to release device";
         }
 
         void EventDevice::update()
         {
-            input_event events[32];
-            ssize_t bytesRead = read(fd, events, sizeof(events));
+            constexpr std::size_t MAX_EVENTS = 64;
+            input_event events[MAX_EVENTS];
 
-            if (bytesRead == -1)
-                throw std::system_error(errno, std::system_category(), "Failed to read from " + filename);
+            // the device is non-blocking, so read until all pending events are consumed
+            for (;;)
+            {
+                const ssize_t bytesRead = read(fd, events, sizeof(events));
 
-            const int eventCount = bytesRead / sizeof(input_event);
+                if (bytesRead == -1)
+                {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    if (errno == EINTR) continue;
+                    throw std::system_error(errno, std::system_category(), "Failed to read from " + filename);
+                }
+
+                const std::size_t eventCount = static_cast<std::size_t>(bytesRead) / sizeof(input_event);
 
-            for (int eventNum = 0; eventNum < eventCount; ++eventNum)
+                handleEvents(events, eventCount);
+
+                if (eventCount < MAX_EVENTS) break;
+            }
+        }
+
+        void EventDevice::handleEvents(const input_event* events, std::size_t eventCount)
+        {
+            for (std::size_t eventNum = 0; eventNum < eventCount; ++eventNum)
             {
-                input_event& event = events[eventNum];
+                const input_event& event = events[eventNum];
 
                 if (keyboardDevice)
                 {
@@ -10,6 +10,9 @@
 #include <unordered_map>
 #include <vector>
 #include "input/Gamepad.hpp"
+#include "storage/FileDescriptor.hpp"
+
+struct input_event;
 
 namespace ouzel
 {
@@ -34,14 +37,17 @@ namespace ouzel
 
             void update();
 
-            inline auto getFd() const noexcept { return fd; }
+            inline int getFd() const noexcept { return fd; }
+            inline auto& getFilename() const noexcept { return filename; }
 
         private:
+            void handleEvents(const input_event* events, std::size_t eventCount);
             void handleAxisChange(std::int32_t oldValue, std::int32_t newValue,
                                   std::int32_t min, std::int32_t range,
                                   Gamepad::Button negativeButton, Gamepad::Button positiveButton);
 
-            int fd = -1;
+            storage::FileDescriptor fd;
+            bool grabbed = false;
             std::string filename;
             std::string name;
 
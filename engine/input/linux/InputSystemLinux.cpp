@@ -8,6 +8,8 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
 #include <linux/joystick.h>
 #if OUZEL_SUPPORTS_X11
 #  include <X11/cursorfont.h>
@@ -21,15 +23,25 @@ namespace ouzel
 {
     namespace input
     {
-        InputSystemLinux::InputSystemLinux(const std::function<std::future<bool>(const Event&)>& initCallback):
+        namespace
+        {
+            inline bool isEventDeviceName(const char* name) noexcept
+            {
+                return strncmp("event", name, 5) == 0;
+            }
+        }
+
+        InputSystemLinux::InputSystemLinux(const std::function<std::future<bool>(const Event&, bool)>& initCallback,
+                                           const std::string& initDeviceDirectory):
 #if OUZEL_SUPPORTS_X11
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDeviceLinux>(*this, getNextDeviceId())),
             mouseDevice(std::make_unique<MouseDeviceLinux>(*this, getNextDeviceId())),
-            touchpadDevice(std::make_unique<TouchpadDevice>(*this, getNextDeviceId(), true))
+            touchpadDevice(std::make_unique<TouchpadDevice>(*this, getNextDeviceId(), true)),
 #else
-            InputSystem(initCallback)
+            InputSystem(initCallback),
 #endif
+            deviceDirectory(initDeviceDirectory)
         {
 #if OUZEL_SUPPORTS_X11
             EngineLinux* engineLinux = static_cast<EngineLinux*>(engine);
@@ -47,35 +59,34 @@ namespace ouzel
                 XFreePixmap(display, pixmap);
             }
 #endif
-            DIR* dir = opendir("/dev/input");
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
 
-            if (!dir)
-                throw std::system_error(errno, std::system_category(), "Failed to open directory");
+            if (epollFd == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to create epoll instance");
 
-            dirent ent;
-            dirent* p;
+            // watch the device directory instead of rescanning it for hot-plugged devices
+            notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 
-            while (readdir_r(dir, &ent, &p) == 0 && p)
-            {
-                if (strncmp("event", ent.d_name, 5) == 0)
-                {
-                    try
-                    {
-                        std::string filename = std::string("/dev/input/") + ent.d_name;
-                        auto eventDevice = std::make_unique<EventDevice>(*this, filename);
-                        eventDevices.insert(std::make_pair(eventDevice->getFd(), std::move(eventDevice)));
-                    }
-                    catch (const std::exception&)
-                    {
-                    }
-                }
-            }
+            if (notifyFd == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to initialize inotify");
 
-            closedir(dir);
+            if (inotify_add_watch(notifyFd, deviceDirectory.c_str(), IN_CREATE | IN_ATTRIB | IN_DELETE) == -1)
+                engine->log(Log::Level::Warning) << "Failed to watch " << deviceDirectory;
+
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = notifyFd;
+
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, notifyFd, &event) == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to add inotify to epoll");
+
+            discoverDevices();
         }
 
         InputSystemLinux::~InputSystemLinux()
         {
+            eventDevices.clear();
+
 #if OUZEL_SUPPORTS_X11
             EngineLinux* engineLinux = static_cast<EngineLinux*>(engine);
             if (emptyCursor != None) XFreeCursor(engineLinux->getDisplay(), emptyCursor);
@@ -88,6 +99,8 @@ namespace ouzel
             {
                 case Command::Type::StartDeviceDiscovery:
                     discovering = true;
+                    // pick up devices that were plugged in while not discovering
+                    discoverDevices();
                     break;
                 case Command::Type::StopDeviceDiscovery:
                     discovering = false;
@@ -184,73 +197,126 @@ namespace ouzel
 
         void InputSystemLinux::update()
         {
-            fd_set rfds;
-            struct timeval tv;
-            tv.tv_sec = 0;
-            tv.tv_usec = 0;
+            constexpr int MAX_EVENTS = 32;
+            epoll_event events[MAX_EVENTS];
+
+            int eventCount;
+            while ((eventCount = epoll_wait(epollFd, events, MAX_EVENTS, 0)) == -1)
+                if (errno != EINTR)
+                    throw std::system_error(errno, std::system_category(), "Failed to wait for events");
+
+            for (int i = 0; i < eventCount; ++i)
+            {
+                const int fd = events[i].data.fd;
+
+                if (fd == notifyFd)
+                {
+                    handleDirectoryChanges();
+                    continue;
+                }
+
+                // the device could have been removed by an earlier event in this batch
+                auto deviceIterator = eventDevices.find(fd);
+                if (deviceIterator == eventDevices.end()) continue;
+
+                if (events[i].events & (EPOLLERR | EPOLLHUP))
+                {
+                    removeEventDevice(fd);
+                    continue;
+                }
+
+                try
+                {
+                    deviceIterator->second->update();
+                }
+                catch (const std::exception&)
+                {
+                    removeEventDevice(fd);
+                }
+            }
+        }
+
+        void InputSystemLinux::discoverDevices()
+        {
+            DIR* dir = opendir(deviceDirectory.c_str());
+
+            if (!dir)
+                throw std::system_error(errno, std::system_category(), "Failed to open directory");
 
-            FD_ZERO(&rfds);
+            while (const dirent* ent = readdir(dir))
+                if (isEventDeviceName(ent->d_name))
+                    addEventDevice(deviceDirectory + '/' + ent->d_name);
 
-            int maxFd = 0;
+            closedir(dir);
+        }
 
+        void InputSystemLinux::addEventDevice(const std::string& filename)
+        {
             for (const auto& i : eventDevices)
+                if (i.second->getFilename() == filename)
+                    return;
+
+            try
             {
-                FD_SET(i.first, &rfds);
-                if (i.first > maxFd) maxFd = i.first;
+                auto eventDevice = std::make_unique<EventDevice>(*this, filename);
+
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.fd = eventDevice->getFd();
+
+                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, eventDevice->getFd(), &event) == -1)
+                    throw std::system_error(errno, std::system_category(), "Failed to add device to epoll");
+
+                eventDevices.insert(std::make_pair(eventDevice->getFd(), std::move(eventDevice)));
+            }
+            catch (const std::exception& e)
+            {
+                engine->log(Log::Level::Warning) << "Skipped " << filename << ": " << e.what();
             }
+        }
 
-            int retval;
-            if ((retval = select(maxFd + 1, &rfds, nullptr, nullptr, &tv)) == -1)
-                throw std::system_error(errno, std::system_category(), "Select failed");
+        void InputSystemLinux::removeEventDevice(int fd)
+        {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            eventDevices.erase(fd);
+        }
 
-            if (retval > 0)
+        void InputSystemLinux::handleDirectoryChanges()
+        {
+            alignas(inotify_event) char buffer[4096];
+
+            for (;;)
             {
-                for (auto i = eventDevices.begin(); i != eventDevices.end();)
+                const ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+
+                if (length == -1)
                 {
-                    if (FD_ISSET(i->first, &rfds))
-                    {
-                        try
-                        {
-                            i->second->update();
-                            ++i;
-                        }
-                        catch (const std::exception&)
-                        {
-                            i = eventDevices.erase(i);
-                        }
-                    }
-                    else
-                        ++i;
+                    if (errno == EINTR) continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    throw std::system_error(errno, std::system_category(), "Failed to read inotify events");
                 }
-            }
 
-            if (discovering)
-            {
-                DIR* dir = opendir("/dev/input");
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
 
-                if (!dir)
-                    throw std::system_error(errno, std::system_category(), "Failed to open directory");
+                    if (!event->len || !isEventDeviceName(event->name)) continue;
 
-                dirent ent;
-                dirent* p;
+                    const std::string filename = deviceDirectory + '/' + event->name;
 
-                while (readdir_r(dir, &ent, &p) == 0 && p)
-                {
-                    if (strncmp("event", ent.d_name, 5) == 0)
+                    if (event->mask & IN_DELETE)
                     {
-                        try
-                        {
-                            std::string filename = std::string("/dev/input/") + ent.d_name;
-                            auto eventDevice = std::make_unique<EventDevice>(*this, filename);
-                            eventDevices.insert(std::make_pair(eventDevice->getFd(), std::move(eventDevice)));
-                        }
-                        catch (const std::exception&)
-                        {
-                        }
+                        for (const auto& i : eventDevices)
+                            if (i.second->getFilename() == filename)
+                            {
+                                removeEventDevice(i.first);
+                                break;
+                            }
                     }
+                    else if (discovering) // created or permissions changed so it can be opened now
+                        addEventDevice(filename);
                 }
-
-                closedir(dir);
             }
         }
 
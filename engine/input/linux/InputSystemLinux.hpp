@@ -4,6 +4,7 @@
 #define OUZEL_INPUT_INPUTSYSTEMLINUX_HPP
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include "core/Setup.h"
 #if OUZEL_SUPPORTS_X11
@@ -14,6 +15,7 @@
 #include "input/linux/EventDevice.hpp"
 #include "input/linux/KeyboardDeviceLinux.hpp"
 #include "input/linux/MouseDeviceLinux.hpp"
+#include "storage/FileDescriptor.hpp"
 
 namespace ouzel
 {
@@ -24,9 +26,15 @@ namespace ouzel
         class InputSystemLinux final: public InputSystem
         {
         public:
-            explicit InputSystemLinux(const std::function<std::future<bool>(const Event&)>& initCallback);
+            explicit InputSystemLinux(const std::function<std::future<bool>(const Event&, bool)>& initCallback,
+                                      const std::string& initDeviceDirectory = "/dev/input");
             ~InputSystemLinux() override;
 
+            InputSystemLinux(const InputSystemLinux&) = delete;
+            InputSystemLinux& operator=(const InputSystemLinux&) = delete;
+            InputSystemLinux(InputSystemLinux&&) = delete;
+            InputSystemLinux& operator=(InputSystemLinux&&) = delete;
+
             void executeCommand(const Command& command) final;
 
             inline auto getKeyboardDevice() const noexcept { return keyboardDevice.get(); }
@@ -45,6 +53,10 @@ namespace ouzel
 #if OUZEL_SUPPORTS_X11
             void updateCursor() const;
 #endif
+            void discoverDevices();
+            void addEventDevice(const std::string& filename);
+            void removeEventDevice(int fd);
+            void handleDirectoryChanges();
 
             bool discovering = false;
 
@@ -53,6 +65,10 @@ namespace ouzel
             std::unique_ptr<MouseDeviceLinux> mouseDevice;
             std::unique_ptr<TouchpadDevice> touchpadDevice;
 
+            std::string deviceDirectory;
+            storage::FileDescriptor epollFd;
+            storage::FileDescriptor notifyFd;
+
             std::unordered_map<int, std::unique_ptr<EventDevice>> eventDevices;
             std::vector<std::unique_ptr<CursorLinux>> cursors;
 
@@ -37,7 +37,7 @@ namespace ouzel
         class InputSystemMacOS final: public InputSystem
         {
         public:
-            explicit InputSystemMacOS(const std::function<std::future<bool>(const Event&)>& initCallback);
+            explicit InputSystemMacOS(const std::function<std::future<bool>(const Event&, bool)>& initCallback);
             ~InputSystemMacOS() override;
 
             void executeCommand(const Command& command) final;
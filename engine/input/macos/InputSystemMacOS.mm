@@ -136,7 +136,7 @@ namespace ouzel
             return errorCategory;
         }
 
-        InputSystemMacOS::InputSystemMacOS(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystemMacOS::InputSystemMacOS(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId())),
             mouseDevice(std::make_unique<MouseDeviceMacOS>(*this, getNextDeviceId())),
@@ -331,7 +331,7 @@ namespace ouzel
 
         void InputSystemMacOS::handleGamepadDiscoveryCompleted()
         {
-            sendEvent(Event(Event::Type::DeviceDiscoveryComplete));
+            postEvent(Event(Event::Type::DeviceDiscoveryComplete));
         }
 
         void InputSystemMacOS::handleGamepadConnected(GCControllerPtr controller)
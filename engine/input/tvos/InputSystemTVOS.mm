@@ -38,7 +38,7 @@ namespace ouzel
 {
     namespace input
     {
-        InputSystemTVOS::InputSystemTVOS(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystemTVOS::InputSystemTVOS(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDevice>(*this, getNextDeviceId()))
         {
@@ -127,7 +127,7 @@ namespace ouzel
 
         void InputSystemTVOS::handleGamepadDiscoveryCompleted()
         {
-            sendEvent(Event(Event::Type::DeviceDiscoveryComplete));
+            postEvent(Event(Event::Type::DeviceDiscoveryComplete));
         }
 
         void InputSystemTVOS::handleGamepadConnected(GCControllerPtr controller)
@@ -92,7 +92,7 @@ namespace ouzel
             return errorCategory;
         }
 
-        InputSystemWin::InputSystemWin(const std::function<std::future<bool>(const Event&)>& initCallback):
+        InputSystemWin::InputSystemWin(const std::function<std::future<bool>(const Event&, bool)>& initCallback):
             InputSystem(initCallback),
             keyboardDevice(std::make_unique<KeyboardDeviceWin>(*this, getNextDeviceId())),
             mouseDevice(std::make_unique<MouseDeviceWin>(*this, getNextDeviceId())),
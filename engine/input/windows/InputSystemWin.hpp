@@ -38,7 +38,7 @@ namespace ouzel
         class InputSystemWin final: public InputSystem
         {
         public:
-            explicit InputSystemWin(const std::function<std::future<bool>(const Event&)>& initCallback);
+            explicit InputSystemWin(const std::function<std::future<bool>(const Event&, bool)>& initCallback);
             ~InputSystemWin() override;
 
             void executeCommand(const Command& command) final;
@@ -0,0 +1,504 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include "Batch.hpp"
+#include "MathUtils.hpp"
+
+namespace ouzel
+{
+    static_assert(sizeof(Vector3F) == 3 * sizeof(float), "Vector3F must be tightly packed");
+    static_assert(sizeof(QuaternionF) == 4 * sizeof(float), "QuaternionF must be tightly packed");
+
+    namespace
+    {
+        // Eberly's polynomial approximation of slerp, within about 3e-5 of the exact result for unit quaternions
+        constexpr float slerpMu = 1.85298109240830F;
+        constexpr float slerpU[8] = {
+            1.0F / (1.0F * 3.0F), 1.0F / (2.0F * 5.0F), 1.0F / (3.0F * 7.0F), 1.0F / (4.0F * 9.0F),
+            1.0F / (5.0F * 11.0F), 1.0F / (6.0F * 13.0F), 1.0F / (7.0F * 15.0F), slerpMu / (8.0F * 17.0F)
+        };
+        constexpr float slerpV[8] = {
+            1.0F / 3.0F, 2.0F / 5.0F, 3.0F / 7.0F, 4.0F / 9.0F,
+            5.0F / 11.0F, 6.0F / 13.0F, 7.0F / 15.0F, slerpMu * 8.0F / 17.0F
+        };
+
+        void slerpPolynomial(const QuaternionF& from, const QuaternionF& to, float t, QuaternionF& result) noexcept
+        {
+            float cosTheta = from.v[0] * to.v[0] + from.v[1] * to.v[1] + from.v[2] * to.v[2] + from.v[3] * to.v[3];
+            const float sign = cosTheta < 0.0F ? -1.0F : 1.0F;
+            const float cosThetaMinusOne = cosTheta * sign - 1.0F;
+
+            const float d = 1.0F - t;
+            float scaleFrom = 1.0F;
+            float scaleTo = 1.0F;
+            for (std::size_t i = 8; i-- > 0;)
+            {
+                scaleFrom = 1.0F + (slerpU[i] * d * d - slerpV[i]) * cosThetaMinusOne * scaleFrom;
+                scaleTo = 1.0F + (slerpU[i] * t * t - slerpV[i]) * cosThetaMinusOne * scaleTo;
+            }
+            scaleFrom *= d;
+            scaleTo *= t * sign;
+
+            result = QuaternionF(from.v[0] * scaleFrom + to.v[0] * scaleTo,
+                                 from.v[1] * scaleFrom + to.v[1] * scaleTo,
+                                 from.v[2] * scaleFrom + to.v[2] * scaleTo,
+                                 from.v[3] * scaleFrom + to.v[3] * scaleTo);
+        }
+
+        void multiplyScalar(const Matrix4F& matrix1, const Matrix4F& matrix2, Matrix4F& result) noexcept
+        {
+            float product[16];
+            for (std::size_t column = 0; column < 4; ++column)
+                for (std::size_t row = 0; row < 4; ++row)
+                    product[column * 4 + row] = matrix1.m[row] * matrix2.m[column * 4] +
+                        matrix1.m[4 + row] * matrix2.m[column * 4 + 1] +
+                        matrix1.m[8 + row] * matrix2.m[column * 4 + 2] +
+                        matrix1.m[12 + row] * matrix2.m[column * 4 + 3];
+
+            std::copy(std::begin(product), std::end(product), result.m);
+        }
+
+#if defined(__ARM_NEON__)
+        inline void multiplySimd(const float* matrix1, const float* matrix2, float* result) noexcept
+        {
+            const float32x4_t column0 = vld1q_f32(&matrix1[0]);
+            const float32x4_t column1 = vld1q_f32(&matrix1[4]);
+            const float32x4_t column2 = vld1q_f32(&matrix1[8]);
+            const float32x4_t column3 = vld1q_f32(&matrix1[12]);
+
+            float32x4_t product[4];
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                const float32x4_t c = vld1q_f32(&matrix2[i * 4]);
+                float32x4_t p = vmulq_lane_f32(column0, vget_low_f32(c), 0);
+                p = vmlaq_lane_f32(p, column1, vget_low_f32(c), 1);
+                p = vmlaq_lane_f32(p, column2, vget_high_f32(c), 0);
+                product[i] = vmlaq_lane_f32(p, column3, vget_high_f32(c), 1);
+            }
+
+            for (std::size_t i = 0; i < 4; ++i)
+                vst1q_f32(&result[i * 4], product[i]);
+        }
+#elif defined(__SSE__)
+        inline void multiplySimd(const float* matrix1, const float* matrix2, float* result) noexcept
+        {
+            const __m128 column0 = _mm_load_ps(&matrix1[0]);
+            const __m128 column1 = _mm_load_ps(&matrix1[4]);
+            const __m128 column2 = _mm_load_ps(&matrix1[8]);
+            const __m128 column3 = _mm_load_ps(&matrix1[12]);
+
+            __m128 product[4];
+            for (std::size_t i = 0; i < 4; ++i)
+                product[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(matrix2[i * 4])),
+                                                   _mm_mul_ps(column1, _mm_set1_ps(matrix2[i * 4 + 1]))),
+                                        _mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(matrix2[i * 4 + 2])),
+                                                   _mm_mul_ps(column3, _mm_set1_ps(matrix2[i * 4 + 3]))));
+
+            for (std::size_t i = 0; i < 4; ++i)
+                _mm_store_ps(&result[i * 4], product[i]);
+        }
+
+        // splits 4 packed 3-component vectors into the x, y and z components
+        inline void loadVectors(const float* data, __m128& x, __m128& y, __m128& z) noexcept
+        {
+            const __m128 a = _mm_loadu_ps(&data[0]); // x0 y0 z0 x1
+            const __m128 b = _mm_loadu_ps(&data[4]); // y1 z1 x2 y2
+            const __m128 c = _mm_loadu_ps(&data[8]); // z2 x3 y3 z3
+
+            x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)),
+                               _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+            y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                               _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                               _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        // packs the x, y and z components back into 4 3-component vectors
+        inline void storeVectors(float* data, const __m128 x, const __m128 y, const __m128 z) noexcept
+        {
+            const __m128 xyLow = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+            const __m128 xyHigh = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+
+            _mm_storeu_ps(&data[0], _mm_shuffle_ps(xyLow, _mm_shuffle_ps(z, xyLow, _MM_SHUFFLE(2, 2, 0, 0)),
+                                                   _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(&data[4], _mm_shuffle_ps(_mm_shuffle_ps(xyLow, z, _MM_SHUFFLE(1, 1, 3, 3)), xyHigh,
+                                                   _MM_SHUFFLE(1, 0, 2, 0)));
+            _mm_storeu_ps(&data[8], _mm_shuffle_ps(_mm_shuffle_ps(z, xyHigh, _MM_SHUFFLE(2, 2, 2, 2)),
+                                                   _mm_shuffle_ps(xyHigh, z, _MM_SHUFFLE(3, 3, 3, 3)),
+                                                   _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+#endif
+
+        template <bool point>
+        void transformScalar(const Matrix4F& matrix, const Vector3F* vectors,
+                             Vector3F* result, std::size_t count) noexcept
+        {
+            const float* m = matrix.m;
+            const float w = point ? 1.0F : 0.0F;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const float x = vectors[i].v[0];
+                const float y = vectors[i].v[1];
+                const float z = vectors[i].v[2];
+
+                result[i].v[0] = x * m[0] + y * m[4] + z * m[8] + w * m[12];
+                result[i].v[1] = x * m[1] + y * m[5] + z * m[9] + w * m[13];
+                result[i].v[2] = x * m[2] + y * m[6] + z * m[10] + w * m[14];
+            }
+        }
+
+        template <bool point>
+        void transform(const Matrix4F& matrix, const Vector3F* vectors,
+                       Vector3F* result, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+
+            if (isSimdAvailable)
+            {
+                const float* m = matrix.m;
+
+                // 4 vectors at a time, with the components in separate registers
+#if defined(__ARM_NEON__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    const float32x4x3_t v = vld3q_f32(vectors[i].v);
+
+                    float32x4x3_t r;
+                    for (std::size_t row = 0; row < 3; ++row)
+                    {
+                        float32x4_t s = point ? vdupq_n_f32(m[12 + row]) : vdupq_n_f32(0.0F);
+                        s = vmlaq_n_f32(s, v.val[0], m[row]);
+                        s = vmlaq_n_f32(s, v.val[1], m[4 + row]);
+                        r.val[row] = vmlaq_n_f32(s, v.val[2], m[8 + row]);
+                    }
+
+                    vst3q_f32(result[i].v, r);
+                }
+#elif defined(__SSE__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128 x;
+                    __m128 y;
+                    __m128 z;
+                    loadVectors(vectors[i].v, x, y, z);
+
+                    __m128 r[3];
+                    for (std::size_t row = 0; row < 3; ++row)
+                    {
+                        const __m128 s = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m[row])),
+                                                    _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m[4 + row])),
+                                                               _mm_mul_ps(z, _mm_set1_ps(m[8 + row]))));
+                        r[row] = point ? _mm_add_ps(s, _mm_set1_ps(m[12 + row])) : s;
+                    }
+
+                    storeVectors(result[i].v, r[0], r[1], r[2]);
+                }
+#endif
+            }
+
+            transformScalar<point>(matrix, vectors + i, result + i, count - i);
+        }
+    }
+
+    void transformPoints(const Matrix4F& matrix, const Vector3F* points,
+                         Vector3F* result, std::size_t count) noexcept
+    {
+        transform<true>(matrix, points, result, count);
+    }
+
+    void transformVectors(const Matrix4F& matrix, const Vector3F* vectors,
+                          Vector3F* result, std::size_t count) noexcept
+    {
+        transform<false>(matrix, vectors, result, count);
+    }
+
+    void transformVectors(const Matrix4F& matrix, const Vector4F* vectors,
+                          Vector4F* result, std::size_t count) noexcept
+    {
+        const float* m = matrix.m;
+
+        if (isSimdAvailable)
+        {
+#if defined(__ARM_NEON__)
+            const float32x4_t column0 = vld1q_f32(&m[0]);
+            const float32x4_t column1 = vld1q_f32(&m[4]);
+            const float32x4_t column2 = vld1q_f32(&m[8]);
+            const float32x4_t column3 = vld1q_f32(&m[12]);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const float32x4_t v = vld1q_f32(vectors[i].v);
+                float32x4_t s = vmulq_lane_f32(column0, vget_low_f32(v), 0);
+                s = vmlaq_lane_f32(s, column1, vget_low_f32(v), 1);
+                s = vmlaq_lane_f32(s, column2, vget_high_f32(v), 0);
+                vst1q_f32(result[i].v, vmlaq_lane_f32(s, column3, vget_high_f32(v), 1));
+            }
+            return;
+#elif defined(__SSE__)
+            const __m128 column0 = _mm_load_ps(&m[0]);
+            const __m128 column1 = _mm_load_ps(&m[4]);
+            const __m128 column2 = _mm_load_ps(&m[8]);
+            const __m128 column3 = _mm_load_ps(&m[12]);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const __m128 s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(vectors[i].v[0])),
+                                                       _mm_mul_ps(column1, _mm_set1_ps(vectors[i].v[1]))),
+                                            _mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(vectors[i].v[2])),
+                                                       _mm_mul_ps(column3, _mm_set1_ps(vectors[i].v[3]))));
+                _mm_store_ps(result[i].v, s);
+            }
+            return;
+#endif
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Vector4F v = vectors[i];
+            result[i].v[0] = v.v[0] * m[0] + v.v[1] * m[4] + v.v[2] * m[8] + v.v[3] * m[12];
+            result[i].v[1] = v.v[0] * m[1] + v.v[1] * m[5] + v.v[2] * m[9] + v.v[3] * m[13];
+            result[i].v[2] = v.v[0] * m[2] + v.v[1] * m[6] + v.v[2] * m[10] + v.v[3] * m[14];
+            result[i].v[3] = v.v[0] * m[3] + v.v[1] * m[7] + v.v[2] * m[11] + v.v[3] * m[15];
+        }
+    }
+
+    void multiplyMatrices(const Matrix4F* matrices1, const Matrix4F* matrices2,
+                          Matrix4F* result, std::size_t count) noexcept
+    {
+        if (isSimdAvailable)
+        {
+#if defined(__ARM_NEON__) || defined(__SSE__)
+            for (std::size_t i = 0; i < count; ++i)
+                multiplySimd(matrices1[i].m, matrices2[i].m, result[i].m);
+            return;
+#endif
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            multiplyScalar(matrices1[i], matrices2[i], result[i]);
+    }
+
+    void multiplyMatrices(const Matrix4F& matrix, const Matrix4F* matrices,
+                          Matrix4F* result, std::size_t count) noexcept
+    {
+        if (isSimdAvailable)
+        {
+#if defined(__ARM_NEON__) || defined(__SSE__)
+            for (std::size_t i = 0; i < count; ++i)
+                multiplySimd(matrix.m, matrices[i].m, result[i].m);
+            return;
+#endif
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            multiplyScalar(matrix, matrices[i], result[i]);
+    }
+
+    void invertMatrices(const Matrix4F* matrices, Matrix4F* result, std::size_t count) noexcept
+    {
+#if defined(__SSE__) && !defined(__ARM_NEON__)
+        // Cramer's rule, based on Intel's "Streaming SIMD Extensions - Inverse of 4x4 Matrix";
+        // the inverse of the transposed matrix is the transposed inverse, so it works for the column-major order too
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float* source = matrices[i].m;
+
+            __m128 temp = _mm_setzero_ps();
+            __m128 row0;
+            __m128 row1 = _mm_setzero_ps();
+            __m128 row2;
+            __m128 row3 = _mm_setzero_ps();
+
+            temp = _mm_loadh_pi(_mm_loadl_pi(temp, reinterpret_cast<const __m64*>(source)), reinterpret_cast<const __m64*>(source + 4));
+            row1 = _mm_loadh_pi(_mm_loadl_pi(row1, reinterpret_cast<const __m64*>(source + 8)), reinterpret_cast<const __m64*>(source + 12));
+            row0 = _mm_shuffle_ps(temp, row1, 0x88);
+            row1 = _mm_shuffle_ps(row1, temp, 0xDD);
+            temp = _mm_loadh_pi(_mm_loadl_pi(temp, reinterpret_cast<const __m64*>(source + 2)), reinterpret_cast<const __m64*>(source + 6));
+            row3 = _mm_loadh_pi(_mm_loadl_pi(row3, reinterpret_cast<const __m64*>(source + 10)), reinterpret_cast<const __m64*>(source + 14));
+            row2 = _mm_shuffle_ps(temp, row3, 0x88);
+            row3 = _mm_shuffle_ps(row3, temp, 0xDD);
+
+            temp = _mm_mul_ps(row2, row3);
+            temp = _mm_shuffle_ps(temp, temp, 0xB1);
+            __m128 minor0 = _mm_mul_ps(row1, temp);
+            __m128 minor1 = _mm_mul_ps(row0, temp);
+            temp = _mm_shuffle_ps(temp, temp, 0x4E);
+            minor0 = _mm_sub_ps(_mm_mul_ps(row1, temp), minor0);
+            minor1 = _mm_sub_ps(_mm_mul_ps(row0, temp), minor1);
+            minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+            temp = _mm_mul_ps(row1, row2);
+            temp = _mm_shuffle_ps(temp, temp, 0xB1);
+            minor0 = _mm_add_ps(_mm_mul_ps(row3, temp), minor0);
+            __m128 minor3 = _mm_mul_ps(row0, temp);
+            temp = _mm_shuffle_ps(temp, temp, 0x4E);
+            minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, temp));
+            minor3 = _mm_sub_ps(_mm_mul_ps(row0, temp), minor3);
+            minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+            temp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+            temp = _mm_shuffle_ps(temp, temp, 0xB1);
+            row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+            minor0 = _mm_add_ps(_mm_mul_ps(row2, temp), minor0);
+            __m128 minor2 = _mm_mul_ps(row0, temp);
+            temp = _mm_shuffle_ps(temp, temp, 0x4E);
+            minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, temp));
+            minor2 = _mm_sub_ps(_mm_mul_ps(row0, temp), minor2);
+            minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+            temp = _mm_mul_ps(row0, row1);
+            temp = _mm_shuffle_ps(temp, temp, 0xB1);
+            minor2 = _mm_add_ps(_mm_mul_ps(row3, temp), minor2);
+            minor3 = _mm_sub_ps(_mm_mul_ps(row2, temp), minor3);
+            temp = _mm_shuffle_ps(temp, temp, 0x4E);
+            minor2 = _mm_sub_ps(_mm_mul_ps(row3, temp), minor2);
+            minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, temp));
+
+            temp = _mm_mul_ps(row0, row3);
+            temp = _mm_shuffle_ps(temp, temp, 0xB1);
+            minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, temp));
+            minor2 = _mm_add_ps(_mm_mul_ps(row1, temp), minor2);
+            temp = _mm_shuffle_ps(temp, temp, 0x4E);
+            minor1 = _mm_add_ps(_mm_mul_ps(row2, temp), minor1);
+            minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, temp));
+
+            temp = _mm_mul_ps(row0, row2);
+            temp = _mm_shuffle_ps(temp, temp, 0xB1);
+            minor1 = _mm_add_ps(_mm_mul_ps(row3, temp), minor1);
+            minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, temp));
+            temp = _mm_shuffle_ps(temp, temp, 0x4E);
+            minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, temp));
+            minor3 = _mm_add_ps(_mm_mul_ps(row1, temp), minor3);
+
+            __m128 determinant = _mm_mul_ps(row0, minor0);
+            determinant = _mm_add_ps(_mm_shuffle_ps(determinant, determinant, 0x4E), determinant);
+            determinant = _mm_add_ss(_mm_shuffle_ps(determinant, determinant, 0xB1), determinant);
+
+            // close to zero, can't invert
+            if (std::fabs(_mm_cvtss_f32(determinant)) <= std::numeric_limits<float>::min())
+            {
+                if (&result[i] != &matrices[i]) result[i] = matrices[i];
+                continue;
+            }
+
+            determinant = _mm_div_ps(_mm_set1_ps(1.0F), _mm_shuffle_ps(determinant, determinant, 0x00));
+
+            _mm_store_ps(&result[i].m[0], _mm_mul_ps(determinant, minor0));
+            _mm_store_ps(&result[i].m[4], _mm_mul_ps(determinant, minor1));
+            _mm_store_ps(&result[i].m[8], _mm_mul_ps(determinant, minor2));
+            _mm_store_ps(&result[i].m[12], _mm_mul_ps(determinant, minor3));
+        }
+#else
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            result[i] = matrices[i];
+            result[i].invert();
+        }
+#endif
+    }
+
+    void slerpQuaternions(const QuaternionF* from, const QuaternionF* to, float t,
+                          QuaternionF* result, std::size_t count) noexcept
+    {
+        if (!isSimdAvailable)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                result[i].slerp(from[i], to[i], t);
+            return;
+        }
+
+        std::size_t i = 0;
+
+        // 4 quaternions at a time, with the components in separate registers
+#if defined(__ARM_NEON__)
+        const float d = 1.0F - t;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4x4_t q1 = vld4q_f32(from[i].v);
+            float32x4x4_t q2 = vld4q_f32(to[i].v);
+
+            float32x4_t cosTheta = vmulq_f32(q1.val[0], q2.val[0]);
+            cosTheta = vmlaq_f32(cosTheta, q1.val[1], q2.val[1]);
+            cosTheta = vmlaq_f32(cosTheta, q1.val[2], q2.val[2]);
+            cosTheta = vmlaq_f32(cosTheta, q1.val[3], q2.val[3]);
+
+            // flip the target quaternions that are on the other hemisphere
+            const uint32x4_t signMask = vandq_u32(vreinterpretq_u32_f32(cosTheta), vdupq_n_u32(0x80000000U));
+            for (std::size_t c = 0; c < 4; ++c)
+                q2.val[c] = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(q2.val[c]), signMask));
+            const float32x4_t cosThetaMinusOne = vsubq_f32(vabsq_f32(cosTheta), vdupq_n_f32(1.0F));
+
+            float32x4_t scaleFrom = vdupq_n_f32(1.0F);
+            float32x4_t scaleTo = vdupq_n_f32(1.0F);
+            for (std::size_t n = 8; n-- > 0;)
+            {
+                scaleFrom = vmlaq_f32(vdupq_n_f32(1.0F), vmulq_n_f32(cosThetaMinusOne, slerpU[n] * d * d - slerpV[n]), scaleFrom);
+                scaleTo = vmlaq_f32(vdupq_n_f32(1.0F), vmulq_n_f32(cosThetaMinusOne, slerpU[n] * t * t - slerpV[n]), scaleTo);
+            }
+            scaleFrom = vmulq_n_f32(scaleFrom, d);
+            scaleTo = vmulq_n_f32(scaleTo, t);
+
+            float32x4x4_t r;
+            for (std::size_t c = 0; c < 4; ++c)
+                r.val[c] = vmlaq_f32(vmulq_f32(q1.val[c], scaleFrom), q2.val[c], scaleTo);
+
+            vst4q_f32(result[i].v, r);
+        }
+#elif defined(__SSE__)
+        const float d = 1.0F - t;
+        const __m128 one = _mm_set1_ps(1.0F);
+        const __m128 signBit = _mm_set1_ps(-0.0F);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 q1[4] = {
+                _mm_loadu_ps(from[i].v), _mm_loadu_ps(from[i + 1].v),
+                _mm_loadu_ps(from[i + 2].v), _mm_loadu_ps(from[i + 3].v)
+            };
+            __m128 q2[4] = {
+                _mm_loadu_ps(to[i].v), _mm_loadu_ps(to[i + 1].v),
+                _mm_loadu_ps(to[i + 2].v), _mm_loadu_ps(to[i + 3].v)
+            };
+            _MM_TRANSPOSE4_PS(q1[0], q1[1], q1[2], q1[3]);
+            _MM_TRANSPOSE4_PS(q2[0], q2[1], q2[2], q2[3]);
+
+            const __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q1[0], q2[0]), _mm_mul_ps(q1[1], q2[1])),
+                                               _mm_add_ps(_mm_mul_ps(q1[2], q2[2]), _mm_mul_ps(q1[3], q2[3])));
+
+            // flip the target quaternions that are on the other hemisphere
+            const __m128 sign = _mm_and_ps(cosTheta, signBit);
+            for (std::size_t c = 0; c < 4; ++c)
+                q2[c] = _mm_xor_ps(q2[c], sign);
+            const __m128 cosThetaMinusOne = _mm_sub_ps(_mm_andnot_ps(signBit, cosTheta), one);
+
+            __m128 scaleFrom = one;
+            __m128 scaleTo = one;
+            for (std::size_t n = 8; n-- > 0;)
+            {
+                scaleFrom = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(cosThetaMinusOne, _mm_set1_ps(slerpU[n] * d * d - slerpV[n])), scaleFrom));
+                scaleTo = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(cosThetaMinusOne, _mm_set1_ps(slerpU[n] * t * t - slerpV[n])), scaleTo));
+            }
+            scaleFrom = _mm_mul_ps(scaleFrom, _mm_set1_ps(d));
+            scaleTo = _mm_mul_ps(scaleTo, _mm_set1_ps(t));
+
+            __m128 r[4];
+            for (std::size_t c = 0; c < 4; ++c)
+                r[c] = _mm_add_ps(_mm_mul_ps(q1[c], scaleFrom), _mm_mul_ps(q2[c], scaleTo));
+            _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+
+            for (std::size_t c = 0; c < 4; ++c)
+                _mm_storeu_ps(result[i + c].v, r[c]);
+        }
+#endif
+
+        for (; i < count; ++i)
+            slerpPolynomial(from[i], to[i], t, result[i]);
+    }
+}
@@ -0,0 +1,45 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_MATH_BATCH_HPP
+#define OUZEL_MATH_BATCH_HPP
+
+#include <cstddef>
+#include "math/Matrix.hpp"
+#include "math/Quaternion.hpp"
+#include "math/Vector.hpp"
+
+namespace ouzel
+{
+    // Operations on arrays of points, vectors, matrices and quaternions,
+    // the SIMD paths are picked at build time and enabled by isSimdAvailable at runtime.
+    // The results may point to the same arrays as the inputs.
+
+    // result[i] = matrix * (points[i], 1)
+    void transformPoints(const Matrix4F& matrix, const Vector3F* points,
+                         Vector3F* result, std::size_t count) noexcept;
+
+    // result[i] = matrix * (vectors[i], 0)
+    void transformVectors(const Matrix4F& matrix, const Vector3F* vectors,
+                          Vector3F* result, std::size_t count) noexcept;
+
+    // result[i] = matrix * vectors[i]
+    void transformVectors(const Matrix4F& matrix, const Vector4F* vectors,
+                          Vector4F* result, std::size_t count) noexcept;
+
+    // result[i] = matrices1[i] * matrices2[i]
+    void multiplyMatrices(const Matrix4F* matrices1, const Matrix4F* matrices2,
+                          Matrix4F* result, std::size_t count) noexcept;
+
+    // result[i] = matrix * matrices[i], e.g. a parent transform applied to its children
+    void multiplyMatrices(const Matrix4F& matrix, const Matrix4F* matrices,
+                          Matrix4F* result, std::size_t count) noexcept;
+
+    // matrices that can't be inverted are copied unchanged, like in Matrix::invert
+    void invertMatrices(const Matrix4F* matrices, Matrix4F* result, std::size_t count) noexcept;
+
+    // spherical interpolation along the shortest path between unit quaternions
+    void slerpQuaternions(const QuaternionF* from, const QuaternionF* to, float t,
+                          QuaternionF* result, std::size_t count) noexcept;
+}
+
+#endif // OUZEL_MATH_BATCH_HPP
@@ -52,10 +52,10 @@ namespace ouzel
 
         constexpr Quaternion& operator*=(const Quaternion& q) noexcept
         {
-            constexpr T tempX = v[0] * q.v[3] + v[1] * q.v[2] - v[2] * q.v[1] + v[3] * q.v[0];
-            constexpr T tempY = -v[0] * q.v[2] + v[1] * q.v[3] + v[2] * q.v[0] + v[3] * q.v[1];
-            constexpr T tempZ = v[0] * q.v[1] - v[1] * q.v[0] + v[2] * q.v[3] + v[3] * q.v[2];
-            constexpr T tempW = -v[0] * q.v[0] - v[1] * q.v[1] - v[2] * q.v[2] + v[3] * q.v[3];
+            const T tempX = v[0] * q.v[3] + v[1] * q.v[2] - v[2] * q.v[1] + v[3] * q.v[0];
+            const T tempY = -v[0] * q.v[2] + v[1] * q.v[3] + v[2] * q.v[0] + v[3] * q.v[1];
+            const T tempZ = v[0] * q.v[1] - v[1] * q.v[0] + v[2] * q.v[3] + v[3] * q.v[2];
+            const T tempW = -v[0] * q.v[0] - v[1] * q.v[1] - v[2] * q.v[2] + v[3] * q.v[3];
 
             v[0] = tempX;
             v[1] = tempY;
@@ -169,7 +169,7 @@ namespace ouzel
 
         constexpr void invert() noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]; // norm squared
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]; // norm squared
             if (squared <= std::numeric_limits<T>::min())
                 return;
 
@@ -183,16 +183,16 @@ namespace ouzel
 
         inline auto getNorm() const noexcept
         {
-            constexpr T n = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T n = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (n == T(1)) // already normalized
-                return 1;
+                return T(1);
 
             return std::sqrt(n);
         }
 
         void normalize() noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (squared == T(1)) // already normalized
                 return;
 
@@ -209,7 +209,7 @@ namespace ouzel
 
         Quaternion normalized() const noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (squared == T(1)) // already normalized
                 return *this;
 
@@ -336,6 +336,32 @@ namespace ouzel
             *this = (q1 * (T(1) - t)) + (q2 * t);
             return *this;
         }
+
+        Quaternion& slerp(const Quaternion& q1, const Quaternion& q2, T t) noexcept
+        {
+            T cosTheta = q1.v[0] * q2.v[0] + q1.v[1] * q2.v[1] + q1.v[2] * q2.v[2] + q1.v[3] * q2.v[3];
+
+            // interpolate along the shortest path
+            const T sign = cosTheta < T(0) ? T(-1) : T(1);
+            cosTheta *= sign;
+
+            T scale1 = T(1) - t;
+            T scale2 = t;
+
+            // use linear interpolation for very close quaternions to avoid the division by zero
+            if (cosTheta < T(1) - std::numeric_limits<T>::epsilon())
+            {
+                const T theta = std::acos(cosTheta);
+                const T sinTheta = std::sin(theta);
+                scale1 = std::sin(scale1 * theta) / sinTheta;
+                scale2 = std::sin(scale2 * theta) / sinTheta;
+            }
+
+            scale2 *= sign;
+
+            *this = (q1 * scale1) + (q2 * scale2);
+            return *this;
+        }
     };
 
     using QuaternionF = Quaternion<float>;
@@ -3,6 +3,7 @@
 #ifndef OUZEL_HPP
 #define OUZEL_HPP
 
+#include "assets/AtlasPacker.hpp"
 #include "assets/Bundle.hpp"
 #include "assets/Cache.hpp"
 #include "assets/Loader.hpp"
@@ -14,6 +15,7 @@
 #include "assets/ObjLoader.hpp"
 #include "assets/ParticleSystemLoader.hpp"
 #include "assets/SpriteLoader.hpp"
+#include "assets/TextureLoader.hpp"
 #include "assets/TtfLoader.hpp"
 #include "assets/VorbisLoader.hpp"
 #include "assets/WaveLoader.hpp"
@@ -40,6 +42,9 @@
 #include "audio/WavePlayer.hpp"
 #include "core/Setup.h"
 #include "core/Engine.hpp"
+#include "core/FrameTimeHistogram.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
 #include "core/Timer.hpp"
 #include "core/Window.hpp"
 #include "events/Event.hpp"
@@ -69,6 +74,7 @@
 #include "graphics/SamplerAddressMode.hpp"
 #include "graphics/SamplerFilter.hpp"
 #include "graphics/Shader.hpp"
+#include "graphics/StagingAllocator.hpp"
 #include "graphics/StencilOperation.hpp"
 #include "graphics/Texture.hpp"
 #include "graphics/TextureType.hpp"
@@ -86,6 +92,7 @@
 #include "input/Mouse.hpp"
 #include "input/Touchpad.hpp"
 #include "localization/Localization.hpp"
+#include "math/Batch.hpp"
 #include "math/Box.hpp"
 #include "math/Color.hpp"
 #include "math/Constants.hpp"
@@ -115,10 +122,12 @@
 #include "scene/ShapeRenderer.hpp"
 #include "scene/SpriteRenderer.hpp"
 #include "scene/SkinnedMeshRenderer.hpp"
+#include "scene/StaticMeshBatch.hpp"
 #include "scene/StaticMeshRenderer.hpp"
 #include "scene/TextRenderer.hpp"
 #include "storage/Archive.hpp"
 #include "storage/FileSystem.hpp"
+#include "storage/MappedFile.hpp"
 #include "storage/Path.hpp"
 #include "utils/Ini.hpp"
 #include "utils/Json.hpp"
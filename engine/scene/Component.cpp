@@ -20,6 +20,11 @@ namespace ouzel
         {
         }
 
+        bool Component::getBatchData(BatchData&) const
+        {
+            return false;
+        }
+
         bool Component::pointOn(const Vector2F& position) const
         {
             return boundingBox.containsPoint(Vector3F(position));
@@ -9,7 +9,10 @@
 #include "math/Matrix.hpp"
 #include "math/Color.hpp"
 #include "math/Rect.hpp"
+#include "graphics/BlendState.hpp"
+#include "graphics/Shader.hpp"
 #include "graphics/Texture.hpp"
+#include "graphics/Vertex.hpp"
 
 namespace ouzel
 {
@@ -31,6 +34,26 @@ namespace ouzel
             Component(Component&&) = delete;
             Component& operator=(Component&&) = delete;
 
+            // geometry of a component that can be merged with the geometry of other components
+            // that use the same texture, blend state and shader
+            struct BatchData final
+            {
+                const graphics::Texture* texture = nullptr;
+                const graphics::BlendState* blendState = nullptr;
+                const graphics::Shader* shader = nullptr;
+                Matrix4F transform = Matrix4F::identity(); // relative to the actor
+                Color color = Color::white();
+                float opacity = 1.0F;
+                const std::uint16_t* indices = nullptr;
+                std::size_t indexCount = 0;
+                const graphics::Vertex* vertices = nullptr;
+                std::size_t vertexCount = 0;
+                bool animated = false; // the geometry can change every frame
+            };
+
+            // returns false if the component can't be batched and has to be drawn on its own
+            virtual bool getBatchData(BatchData& batchData) const;
+
             virtual void draw(const Matrix4F& transformMatrix,
                               float opacity,
                               const Matrix4F& renderViewProjection,
@@ -39,8 +39,12 @@ namespace ouzel
                 engine->getRenderer()->setDepthStencilState(camera->getDepthStencilState() ? camera->getDepthStencilState()->getResource() : 0,
                                                             camera->getStencilReferenceValue());
 
+                meshBatcher.begin(camera);
+
                 for (Actor* actor : drawQueue)
                     actor->draw(camera, camera->getWireframe());
+
+                meshBatcher.end(camera->getRenderViewProjection(), camera->getWireframe());
             }
         }
 
@@ -65,6 +69,8 @@ namespace ouzel
 
             if (i != cameras.end())
                 cameras.erase(i);
+
+            meshBatcher.removeCamera(camera);
         }
 
         void Layer::addLight(Light* light)
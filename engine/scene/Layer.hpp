@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include "scene/Actor.hpp"
+#include "scene/StaticMeshBatch.hpp"
 #include "math/Vector.hpp"
 
 namespace ouzel
@@ -33,6 +34,8 @@ namespace ouzel
 
             inline auto& getCameras() const noexcept { return cameras; }
 
+            inline auto& getMeshBatcher() noexcept { return meshBatcher; }
+
             std::pair<Actor*, Vector3F> pickActor(const Vector2F& position, bool renderTargets = false) const;
             std::vector<std::pair<Actor*, Vector3F>> pickActors(const Vector2F& position, bool renderTargets = false) const;
             std::vector<Actor*> pickActors(const std::vector<Vector2F>& edges, bool renderTargets = false) const;
@@ -59,6 +62,8 @@ namespace ouzel
             std::vector<Light*> lights;
 
             Order order = 0;
+
+            StaticMeshBatcher meshBatcher;
         };
     } // namespace scene
 } // namespace ouzel
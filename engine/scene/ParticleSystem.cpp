@@ -12,6 +12,7 @@
 #include "Camera.hpp"
 #include "Layer.hpp"
 #include "utils/Utils.hpp"
+#include "math/Batch.hpp"
 #include "math/MathUtils.hpp"
 
 namespace ouzel
@@ -223,12 +224,14 @@ namespace ouzel
                     {
                         const Matrix4F& inverseTransform = actor->getInverseTransform();
 
+                        positions.resize(particleCount);
                         for (std::uint32_t i = 0; i < particleCount; ++i)
-                        {
-                            auto position = Vector3F(particles[i].position);
-                            inverseTransform.transformPoint(position);
+                            positions[i] = Vector3F(particles[i].position);
+
+                        transformPoints(inverseTransform, positions.data(), positions.data(), positions.size());
+
+                        for (const Vector3F& position : positions)
                             boundingBox.insertPoint(position);
-                        }
                     }
                 }
                 else if (particleSystemData.positionType == ParticleSystemData::PositionType::Grouped)
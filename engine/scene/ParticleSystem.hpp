@@ -195,6 +195,7 @@ namespace ouzel
             };
 
             std::vector<Particle> particles;
+            std::vector<Vector3F> positions; // scratch buffer for the bounding box calculation
 
             std::unique_ptr<graphics::Buffer> indexBuffer;
             std::unique_ptr<graphics::Buffer> vertexBuffer;
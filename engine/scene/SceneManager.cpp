@@ -5,6 +5,7 @@
 #include "SceneManager.hpp"
 #include "Scene.hpp"
 #include "Actor.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -59,6 +60,8 @@ namespace ouzel
 
         void SceneManager::draw()
         {
+            Profiler::Zone zone(engine->getProfiler(), "SceneManager::draw");
+
             while (scenes.size() > 1)
                 removeScene(scenes.front());
 
@@ -1,7 +1,9 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
 #include "ShapeRenderer.hpp"
 #include "Camera.hpp"
 #include "core/Engine.hpp"
@@ -12,6 +14,43 @@ namespace ouzel
 {
     namespace scene
     {
+        namespace
+        {
+            // uploads only the range of bytes that differs from the current contents of the buffer
+            void updateBuffer(graphics::Buffer& buffer, const void* data, std::size_t size,
+                              std::vector<std::uint8_t>& contents)
+            {
+                const auto bytes = static_cast<const std::uint8_t*>(data);
+
+                const std::size_t common = std::min(size, contents.size());
+                const auto first = static_cast<std::size_t>(std::mismatch(bytes, bytes + common, contents.begin()).first - bytes);
+                std::size_t last = size;
+
+                if (size <= contents.size())
+                    while (last > first && bytes[last - 1] == contents[last - 1]) --last;
+
+                if (first == last) return;
+
+                if (size > contents.size())
+                {
+                    // grow the buffer geometrically to avoid reallocating it every time something is added
+                    if (size > buffer.getSize())
+                    {
+                        contents.resize(std::max(size, static_cast<std::size_t>(buffer.getSize()) * 2));
+                        last = contents.size();
+                    }
+                    else // the buffer can be larger than the contents after it was used for streaming
+                        contents.resize(size);
+                }
+
+                std::copy(bytes + first, bytes + size, contents.begin() + static_cast<std::ptrdiff_t>(first));
+
+                buffer.setData(static_cast<std::uint32_t>(first),
+                               contents.data() + first,
+                               static_cast<std::uint32_t>(last - first));
+            }
+        }
+
         ShapeRenderer::ShapeRenderer():
             shader(engine->getCache().getShader(SHADER_COLOR)),
             blendState(engine->getCache().getBlendState(BLEND_ALPHA)),
@@ -36,8 +75,14 @@ namespace ouzel
 
             if (dirty)
             {
-                if (!indices.empty()) indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
-                if (!vertices.empty()) vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+                if (!indices.empty() && !vertices.empty())
+                {
+                    if (streaming)
+                        uploadStream();
+                    else
+                        uploadChanges();
+                }
+
                 dirty = false;
             }
 
@@ -63,8 +108,64 @@ namespace ouzel
                                             sizeof(std::uint16_t),
                                             vertexBuffer.getResource(),
                                             drawCommand.mode,
-                                            drawCommand.startIndex);
+                                            indexBase + drawCommand.startIndex);
+            }
+        }
+
+        void ShapeRenderer::setStreaming(bool newStreaming)
+        {
+            if (streaming == newStreaming) return;
+
+            streaming = newStreaming;
+
+            // the contents of the buffers are rewritten in the new mode
+            uploadedIndexData.clear();
+            uploadedVertexData.clear();
+            streamIndexOffset = 0;
+            streamVertexOffset = 0;
+            dirty = true;
+        }
+
+        void ShapeRenderer::uploadChanges()
+        {
+            updateBuffer(indexBuffer, indices.data(), getVectorSize(indices), uploadedIndexData);
+            updateBuffer(vertexBuffer, vertices.data(), getVectorSize(vertices), uploadedVertexData);
+            indexBase = 0;
+        }
+
+        void ShapeRenderer::uploadStream()
+        {
+            const auto indexCount = static_cast<std::uint32_t>(indices.size());
+            const auto vertexCount = static_cast<std::uint32_t>(vertices.size());
+
+            // the ring holds a few frames worth of shapes, vertices are limited by the 16-bit indices
+            constexpr std::uint32_t ringFrames = 3;
+            constexpr std::uint32_t maxVertexCount = std::numeric_limits<std::uint16_t>::max() + 1;
+
+            if (streamIndexOffset + indexCount > streamIndexCapacity ||
+                streamVertexOffset + vertexCount > streamVertexCapacity)
+            {
+                streamIndexOffset = 0;
+                streamVertexOffset = 0;
+                streamIndexCapacity = std::max(streamIndexCapacity, indexCount * ringFrames);
+                streamVertexCapacity = std::min(std::max(streamVertexCapacity, vertexCount * ringFrames), maxVertexCount);
             }
+
+            // indices are relative to the start of the vertex buffer
+            streamIndices.resize(indexCount);
+            for (std::uint32_t i = 0; i < indexCount; ++i)
+                streamIndices[i] = static_cast<std::uint16_t>(indices[i] + streamVertexOffset);
+
+            indexBuffer.setData(streamIndexOffset * static_cast<std::uint32_t>(sizeof(std::uint16_t)),
+                                streamIndices.data(),
+                                static_cast<std::uint32_t>(getVectorSize(streamIndices)));
+            vertexBuffer.setData(streamVertexOffset * static_cast<std::uint32_t>(sizeof(graphics::Vertex)),
+                                 vertices.data(),
+                                 static_cast<std::uint32_t>(getVectorSize(vertices)));
+
+            indexBase = streamIndexOffset;
+            streamIndexOffset += indexCount;
+            streamVertexOffset += vertexCount;
         }
 
         void ShapeRenderer::clear()
@@ -66,7 +66,15 @@ namespace ouzel
                 blendState = newBlendState;
             }
 
+            // in streaming mode every change is written to a new part of the buffers (wrapping around at the end),
+            // so that the data used by the previous frames is not overwritten, otherwise only the changed bytes are uploaded
+            inline auto isStreaming() const noexcept { return streaming; }
+            void setStreaming(bool newStreaming);
+
         private:
+            void uploadChanges();
+            void uploadStream();
+
             struct DrawCommand final
             {
                 graphics::DrawMode mode;
@@ -84,6 +92,17 @@ namespace ouzel
             std::vector<std::uint16_t> indices;
             std::vector<graphics::Vertex> vertices;
             bool dirty = false;
+
+            std::vector<std::uint8_t> uploadedIndexData; // contents of the index buffer
+            std::vector<std::uint8_t> uploadedVertexData; // contents of the vertex buffer
+            std::uint32_t indexBase = 0; // start of the current indices in the index buffer
+
+            bool streaming = false;
+            std::vector<std::uint16_t> streamIndices;
+            std::uint32_t streamIndexOffset = 0;
+            std::uint32_t streamVertexOffset = 0;
+            std::uint32_t streamIndexCapacity = 0;
+            std::uint32_t streamVertexCapacity = 0;
         };
     } // namespace scene
 } // namespace ouzel
@@ -1,26 +1,372 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include "SkinnedMeshRenderer.hpp"
 #include "core/Engine.hpp"
+#include "math/Batch.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Utils.hpp"
 
 namespace ouzel
 {
     namespace scene
     {
+        SkinnedMeshData::SkinnedMeshData(const Box3F& initBoundingBox,
+                                         const std::vector<std::uint32_t>& indices,
+                                         std::vector<graphics::Vertex> initVertices,
+                                         std::vector<BoneWeights> initBoneWeights,
+                                         std::vector<Bone> initBones,
+                                         std::vector<Part> initParts,
+                                         std::map<std::string, Animation> initAnimations):
+            boundingBox(initBoundingBox),
+            vertices(std::move(initVertices)),
+            boneWeights(std::move(initBoneWeights)),
+            bones(std::move(initBones)),
+            parts(std::move(initParts)),
+            animations(std::move(initAnimations))
+        {
+            inverseBindMatrices.reserve(bones.size());
+            baseTransforms.reserve(bones.size());
+
+            for (const Bone& bone : bones)
+            {
+                inverseBindMatrices.push_back(bone.inverseBindMatrix);
+                baseTransforms.push_back(bone.baseTransform);
+            }
+
+            indexCount = static_cast<std::uint32_t>(indices.size());
+
+            indexSize = sizeof(std::uint16_t);
+
+            for (const auto index : indices)
+                if (index > std::numeric_limits<std::uint16_t>::max())
+                {
+                    indexSize = sizeof(std::uint32_t);
+                    break;
+                }
+
+            if (indexSize == sizeof(std::uint16_t))
+            {
+                std::vector<std::uint16_t> convertedIndices;
+                convertedIndices.reserve(indices.size());
+
+                for (const auto index : indices)
+                    convertedIndices.push_back(static_cast<std::uint16_t>(index));
+
+                indexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                               graphics::BufferType::Index, 0,
+                                               convertedIndices.data(),
+                                               static_cast<std::uint32_t>(getVectorSize(convertedIndices)));
+            }
+            else if (indexSize == sizeof(std::uint32_t))
+                indexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                               graphics::BufferType::Index, 0,
+                                               indices.data(),
+                                               static_cast<std::uint32_t>(getVectorSize(indices)));
+
+            vertexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                            graphics::BufferType::Vertex, 0,
+                                            vertices.data(),
+                                            static_cast<std::uint32_t>(getVectorSize(vertices)));
+        }
+
         SkinnedMeshRenderer::SkinnedMeshRenderer()
         {
-            whitePixelTexture = engine->getCache().getTexture(TEXTURE_WHITE_PIXEL);
+            updateHandler.updateHandler = [this](const UpdateEvent& event) {
+                update(event.delta);
+                return false;
+            };
         }
 
-        SkinnedMeshRenderer::SkinnedMeshRenderer(const SkinnedMeshData& meshData)
+        SkinnedMeshRenderer::SkinnedMeshRenderer(const SkinnedMeshData& initMeshData):
+            SkinnedMeshRenderer()
         {
-            init(meshData);
+            init(initMeshData);
+        }
+
+        void SkinnedMeshRenderer::init(const SkinnedMeshData& newMeshData)
+        {
+            meshData = &newMeshData;
+            boundingBox = newMeshData.boundingBox;
+
+            animation = nullptr;
+            animationName.clear();
+            currentTime = 0.0F;
+            channelKeys.clear();
+
+            const auto boneCount = newMeshData.bones.size();
+            positions.resize(boneCount);
+            rotations.resize(boneCount);
+            scales.resize(boneCount);
+            localTransforms.resize(boneCount);
+            modelTransforms.resize(boneCount);
+            skinMatrices.resize(boneCount);
+            resetPose();
+
+            // meshes without bones are drawn from the shared vertex buffer
+            if (boneCount > 0)
+                vertexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                                graphics::BufferType::Vertex,
+                                                graphics::Flags::Dynamic,
+                                                newMeshData.vertices.data(),
+                                                static_cast<std::uint32_t>(getVectorSize(newMeshData.vertices)));
+            else
+                vertexBuffer = graphics::Buffer();
+
+            verticesDirty = false;
+        }
+
+        void SkinnedMeshRenderer::update(float delta)
+        {
+            if (!animation) return;
+
+            currentTime += delta;
+
+            if (currentTime >= animation->duration)
+            {
+                if (repeat && animation->duration > 0.0F)
+                {
+                    currentTime = std::fmod(currentTime, animation->duration);
+
+                    auto resetEvent = std::make_unique<AnimationEvent>();
+                    resetEvent->type = Event::Type::AnimationReset;
+                    resetEvent->component = this;
+                    resetEvent->name = animationName;
+                    engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                }
+                else
+                {
+                    currentTime = animation->duration;
+                    playing = false;
+                    updateHandler.remove();
+
+                    auto finishEvent = std::make_unique<AnimationEvent>();
+                    finishEvent->type = Event::Type::AnimationFinish;
+                    finishEvent->component = this;
+                    finishEvent->name = animationName;
+                    engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                }
+            }
+
+            poseDirty = true;
+        }
+
+        void SkinnedMeshRenderer::play()
+        {
+            if (!playing)
+            {
+                engine->getEventDispatcher().addEventHandler(updateHandler);
+                playing = true;
+            }
+        }
+
+        void SkinnedMeshRenderer::stop(bool resetAnimation)
+        {
+            if (playing)
+            {
+                playing = false;
+                updateHandler.remove();
+            }
+
+            if (resetAnimation) reset();
+        }
+
+        void SkinnedMeshRenderer::reset()
+        {
+            currentTime = 0.0F;
+            poseDirty = true;
+        }
+
+        bool SkinnedMeshRenderer::hasAnimation(const std::string& name) const
+        {
+            return meshData && meshData->animations.find(name) != meshData->animations.end();
+        }
+
+        void SkinnedMeshRenderer::setAnimation(const std::string& newAnimation, bool newRepeat)
+        {
+            if (!meshData) return;
+
+            auto i = meshData->animations.find(newAnimation);
+            if (i == meshData->animations.end())
+                throw std::runtime_error("Invalid animation " + newAnimation);
+
+            animation = &i->second;
+            animationName = newAnimation;
+            repeat = newRepeat;
+            currentTime = 0.0F;
+            channelKeys.assign(animation->channels.size(), 0);
+
+            // the bones that the new animation doesn't animate go back to the rest pose
+            resetPose();
         }
 
-        void SkinnedMeshRenderer::init(const SkinnedMeshData& meshData)
+        void SkinnedMeshRenderer::setAnimationTime(float time)
         {
-            boundingBox = meshData.boundingBox;
-            material = meshData.material;
+            currentTime = animation ? clamp(time, 0.0F, animation->duration) : 0.0F;
+            poseDirty = true;
+        }
+
+        const std::vector<Matrix4F>& SkinnedMeshRenderer::getSkinMatrices()
+        {
+            if (poseDirty) updatePose();
+            return skinMatrices;
+        }
+
+        void SkinnedMeshRenderer::resetPose()
+        {
+            for (std::size_t i = 0; i < meshData->bones.size(); ++i)
+            {
+                positions[i] = meshData->bones[i].position;
+                rotations[i] = meshData->bones[i].rotation;
+                scales[i] = meshData->bones[i].scale;
+            }
+
+            poseDirty = true;
+        }
+
+        void SkinnedMeshRenderer::updatePose()
+        {
+            poseDirty = false;
+            verticesDirty = true;
+
+            if (animation)
+                for (std::size_t c = 0; c < animation->channels.size(); ++c)
+                {
+                    const SkinnedMeshData::Channel& channel = animation->channels[c];
+                    const auto keyCount = channel.times.size();
+                    if (keyCount == 0) continue;
+
+                    // the time only moves forward while playing, so the key is found by continuing
+                    // from the last one, it is searched from the beginning only after a jump back
+                    std::size_t& key = channelKeys[c];
+                    if (key >= keyCount || channel.times[key] > currentTime) key = 0;
+                    while (key + 1 < keyCount && channel.times[key + 1] <= currentTime) ++key;
+
+                    const bool interpolate = key + 1 < keyCount &&
+                        currentTime > channel.times[key] &&
+                        channel.interpolation == SkinnedMeshData::Channel::Interpolation::Linear;
+                    const float t = interpolate ?
+                        (currentTime - channel.times[key]) / (channel.times[key + 1] - channel.times[key]) : 0.0F;
+
+                    switch (channel.path)
+                    {
+                        case SkinnedMeshData::Channel::Path::Translation:
+                        case SkinnedMeshData::Channel::Path::Scale:
+                        {
+                            const float* from = &channel.values[key * 3];
+                            Vector3F value(from[0], from[1], from[2]);
+
+                            if (interpolate)
+                            {
+                                const float* to = from + 3;
+                                value = Vector3F(lerp(from[0], to[0], t),
+                                                 lerp(from[1], to[1], t),
+                                                 lerp(from[2], to[2], t));
+                            }
+
+                            if (channel.path == SkinnedMeshData::Channel::Path::Translation)
+                                positions[channel.bone] = value;
+                            else
+                                scales[channel.bone] = value;
+                            break;
+                        }
+                        case SkinnedMeshData::Channel::Path::Rotation:
+                        {
+                            const float* from = &channel.values[key * 4];
+                            const QuaternionF fromRotation(from[0], from[1], from[2], from[3]);
+
+                            if (interpolate)
+                            {
+                                const float* to = from + 4;
+                                rotations[channel.bone].slerp(fromRotation, QuaternionF(to[0], to[1], to[2], to[3]), t);
+                            }
+                            else
+                                rotations[channel.bone] = fromRotation;
+                            break;
+                        }
+                    }
+                }
+
+            const auto boneCount = meshData->bones.size();
+
+            for (std::size_t i = 0; i < boneCount; ++i)
+                SkinnedMeshData::composeTransform(positions[i], rotations[i], scales[i], localTransforms[i]);
+
+            multiplyMatrices(meshData->baseTransforms.data(), localTransforms.data(),
+                             localTransforms.data(), boneCount);
+
+            // the parents are always before their children, so the hierarchy is evaluated in one pass
+            for (std::size_t i = 0; i < boneCount; ++i)
+            {
+                const auto parent = meshData->bones[i].parent;
+                if (parent == SkinnedMeshData::NO_PARENT)
+                    modelTransforms[i] = localTransforms[i];
+                else
+                    modelTransforms[parent].multiply(localTransforms[i], modelTransforms[i]);
+            }
+
+            multiplyMatrices(modelTransforms.data(), meshData->inverseBindMatrices.data(),
+                             skinMatrices.data(), boneCount);
+        }
+
+        void SkinnedMeshRenderer::updateVertices()
+        {
+            verticesDirty = false;
+
+            const auto vertexCount = meshData->vertices.size();
+            auto vertices = static_cast<graphics::Vertex*>(vertexBuffer.stageData(0, static_cast<std::uint32_t>(vertexCount * sizeof(graphics::Vertex))));
+            if (!vertices) return;
+
+            // the skinned vertices are written straight to the memory that is uploaded to the vertex buffer
+            const auto skin = [this, vertices](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    const graphics::Vertex& vertex = meshData->vertices[i];
+                    const SkinnedMeshData::BoneWeights& boneWeights = meshData->boneWeights[i];
+                    graphics::Vertex& result = vertices[i];
+
+                    result = vertex;
+
+                    // vertices that are not skinned (all the weights are zero) keep the bind pose
+                    if (boneWeights.weights[0] == 0.0F && boneWeights.weights[1] == 0.0F &&
+                        boneWeights.weights[2] == 0.0F && boneWeights.weights[3] == 0.0F)
+                        continue;
+
+                    // blend the upper 3x4 part of the matrices
+                    float m[12] = {0.0F};
+                    for (std::size_t b = 0; b < SkinnedMeshData::MAX_BONE_INFLUENCES; ++b)
+                    {
+                        const float weight = boneWeights.weights[b];
+                        if (weight == 0.0F) continue;
+
+                        const Matrix4F& skinMatrix = skinMatrices[boneWeights.bones[b]];
+                        for (std::size_t column = 0; column < 4; ++column)
+                        {
+                            m[column * 3 + 0] += skinMatrix.m[column * 4 + 0] * weight;
+                            m[column * 3 + 1] += skinMatrix.m[column * 4 + 1] * weight;
+                            m[column * 3 + 2] += skinMatrix.m[column * 4 + 2] * weight;
+                        }
+                    }
+
+                    const Vector3F& p = vertex.position;
+                    result.position = Vector3F(m[0] * p.v[0] + m[3] * p.v[1] + m[6] * p.v[2] + m[9],
+                                               m[1] * p.v[0] + m[4] * p.v[1] + m[7] * p.v[2] + m[10],
+                                               m[2] * p.v[0] + m[5] * p.v[1] + m[8] * p.v[2] + m[11]);
+
+                    const Vector3F& n = vertex.normal;
+                    result.normal = Vector3F(m[0] * n.v[0] + m[3] * n.v[1] + m[6] * n.v[2],
+                                             m[1] * n.v[0] + m[4] * n.v[1] + m[7] * n.v[2],
+                                             m[2] * n.v[0] + m[5] * n.v[1] + m[8] * n.v[2]);
+                    result.normal.normalize();
+                }
+            };
+
+            if (vertexCount >= PARALLEL_SKINNING_VERTEX_COUNT)
+                engine->getJobSystem().parallelFor(0, vertexCount, 0, skin);
+            else
+                skin(0, vertexCount);
         }
 
         void SkinnedMeshRenderer::draw(const Matrix4F& transformMatrix,
@@ -32,6 +378,56 @@ namespace ouzel
                             opacity,
                             renderViewProjection,
                             wireframe);
+
+            if (!meshData) return;
+
+            // the pose and the vertices are updated only for the visible meshes
+            if (!meshData->bones.empty())
+            {
+                if (poseDirty) updatePose();
+                if (verticesDirty) updateVertices();
+            }
+
+            const graphics::Buffer& drawVertexBuffer = meshData->bones.empty() ? meshData->vertexBuffer : vertexBuffer;
+
+            const Matrix4F modelViewProj = renderViewProjection * transformMatrix;
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+
+            for (const SkinnedMeshData::Part& part : meshData->parts)
+            {
+                const graphics::Material* partMaterial = material ? material : part.material;
+                if (!partMaterial) continue;
+
+                const float colorVector[] = {
+                    partMaterial->diffuseColor.normR(),
+                    partMaterial->diffuseColor.normG(),
+                    partMaterial->diffuseColor.normB(),
+                    partMaterial->diffuseColor.normA() * opacity * partMaterial->opacity
+                };
+
+                std::vector<std::vector<float>> fragmentShaderConstants(1);
+                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+                std::vector<std::uintptr_t> textures;
+                for (const std::shared_ptr<graphics::Texture>& texture : partMaterial->textures)
+                    textures.push_back(texture ? texture->getResource() : 0);
+
+                engine->getRenderer()->setPipelineState(partMaterial->blendState->getResource(),
+                                                        partMaterial->shader->getResource(),
+                                                        partMaterial->cullMode,
+                                                        wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
+                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
+                                                          vertexShaderConstants);
+                engine->getRenderer()->setTextures(textures);
+                engine->getRenderer()->draw(meshData->indexBuffer.getResource(),
+                                            part.indexCount,
+                                            meshData->indexSize,
+                                            drawVertexBuffer.getResource(),
+                                            graphics::DrawMode::TriangleList,
+                                            part.startIndex);
+            }
         }
     } // namespace scene
 } // namespace ouzel
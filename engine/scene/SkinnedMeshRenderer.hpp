@@ -3,9 +3,15 @@
 #ifndef OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 #define OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 
+#include <limits>
+#include <map>
+#include <string>
 #include <vector>
 #include "scene/Component.hpp"
+#include "events/EventHandler.hpp"
+#include "graphics/Buffer.hpp"
 #include "graphics/Material.hpp"
+#include "graphics/Vertex.hpp"
 
 namespace ouzel
 {
@@ -14,44 +20,171 @@ namespace ouzel
         class SkinnedMeshData final
         {
         public:
+            static constexpr std::uint32_t NO_PARENT = std::numeric_limits<std::uint32_t>::max();
+            static constexpr std::uint32_t MAX_BONE_INFLUENCES = 4;
+
+            static void composeTransform(const Vector3F& position,
+                                         const QuaternionF& rotation,
+                                         const Vector3F& scale,
+                                         Matrix4F& result) noexcept
+            {
+                result.setRotation(rotation);
+
+                for (std::size_t column = 0; column < 3; ++column)
+                    for (std::size_t row = 0; row < 3; ++row)
+                        result.m[column * 4 + row] *= scale.v[column];
+
+                result.m[12] = position.v[0];
+                result.m[13] = position.v[1];
+                result.m[14] = position.v[2];
+            }
+
             struct Bone final
             {
-                Bone* parent = nullptr;
+                Matrix4F getLocalTransform() const noexcept
+                {
+                    Matrix4F result;
+                    composeTransform(position, rotation, scale, result);
+                    return result;
+                }
+
+                std::uint32_t parent = NO_PARENT; // the parent is always before the child
                 Vector3F position;
-                QuaternionF rotation;
+                QuaternionF rotation = QuaternionF::identity();
+                Vector3F scale = Vector3F(1.0F, 1.0F, 1.0F);
+                Matrix4F inverseBindMatrix = Matrix4F::identity();
+                Matrix4F baseTransform = Matrix4F::identity(); // transform of the ancestors that are not bones, used by the root bones
+            };
+
+            struct BoneWeights final
+            {
+                std::uint16_t bones[MAX_BONE_INFLUENCES] = {0, 0, 0, 0};
+                float weights[MAX_BONE_INFLUENCES] = {0.0F, 0.0F, 0.0F, 0.0F}; // all weights are zero for the vertices that are not skinned
+            };
+
+            struct Part final
+            {
+                std::uint32_t startIndex = 0;
+                std::uint32_t indexCount = 0;
+                const graphics::Material* material = nullptr;
+            };
+
+            struct Channel final
+            {
+                enum class Path
+                {
+                    Translation,
+                    Rotation,
+                    Scale
+                };
+
+                enum class Interpolation
+                {
+                    Step,
+                    Linear
+                };
+
+                std::uint32_t bone = 0;
+                Path path = Path::Translation;
+                Interpolation interpolation = Interpolation::Linear;
+                std::vector<float> times;
+                std::vector<float> values; // three components per key for translations and scales, four for rotations
+            };
+
+            struct Animation final
+            {
+                float duration = 0.0F;
+                std::vector<Channel> channels;
             };
 
             SkinnedMeshData() = default;
             SkinnedMeshData(const Box3F& initBoundingBox,
-                            const std::shared_ptr<graphics::Material>& initMaterial):
-                boundingBox(initBoundingBox),
-                material(initMaterial)
-            {
-            }
+                            const std::vector<std::uint32_t>& indices,
+                            std::vector<graphics::Vertex> initVertices,
+                            std::vector<BoneWeights> initBoneWeights,
+                            std::vector<Bone> initBones,
+                            std::vector<Part> initParts,
+                            std::map<std::string, Animation> initAnimations);
 
             Box3F boundingBox;
-            std::shared_ptr<graphics::Material> material;
+            std::vector<graphics::Vertex> vertices; // bind pose
+            std::vector<BoneWeights> boneWeights; // one for every vertex
+            std::vector<Bone> bones;
+            std::vector<Matrix4F> inverseBindMatrices; // copies of the bone matrices in flat arrays for the pose evaluation
+            std::vector<Matrix4F> baseTransforms;
+            std::vector<Part> parts;
+            std::map<std::string, Animation> animations;
+            std::uint32_t indexCount = 0;
+            std::uint32_t indexSize = 0;
+            graphics::Buffer indexBuffer;
+            graphics::Buffer vertexBuffer;
         };
 
         class SkinnedMeshRenderer: public Component
         {
         public:
+            // meshes with at least this many vertices are skinned on the worker threads of the job system
+            static constexpr std::size_t PARALLEL_SKINNING_VERTEX_COUNT = 4096;
+
             SkinnedMeshRenderer();
-            explicit SkinnedMeshRenderer(const SkinnedMeshData& meshData);
+            explicit SkinnedMeshRenderer(const SkinnedMeshData& initMeshData);
+
+            void init(const SkinnedMeshData& newMeshData);
 
-            void init(const SkinnedMeshData& meshData);
+            void update(float delta);
 
             void draw(const Matrix4F& transformMatrix,
                       float opacity,
                       const Matrix4F& renderViewProjection,
                       bool wireframe) override;
 
-            inline auto& getMaterial() const noexcept { return material; }
-            inline void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+            // overrides the materials of all the parts if set
+            inline auto getMaterial() const noexcept { return material; }
+            inline void setMaterial(const graphics::Material* newMaterial) { material = newMaterial; }
+
+            void play();
+            void stop(bool resetAnimation = true);
+            void reset();
+            inline auto isPlaying() const noexcept { return playing; }
+
+            inline auto& getAnimationName() const noexcept { return animationName; }
+            bool hasAnimation(const std::string& name) const;
+            void setAnimation(const std::string& newAnimation, bool repeat = true);
+            inline auto getAnimationTime() const noexcept { return currentTime; }
+            void setAnimationTime(float time);
+
+            // bone transforms multiplied by the inverse bind matrices, in the order of the bones,
+            // can be passed to a skinning vertex shader
+            const std::vector<Matrix4F>& getSkinMatrices();
 
         private:
-            std::shared_ptr<graphics::Material> material;
-            std::shared_ptr<graphics::Texture> whitePixelTexture;
+            void resetPose();
+            void updatePose();
+            void updateVertices();
+
+            const SkinnedMeshData* meshData = nullptr;
+            const graphics::Material* material = nullptr;
+
+            const SkinnedMeshData::Animation* animation = nullptr;
+            std::string animationName;
+            bool repeat = true;
+            bool playing = false;
+            float currentTime = 0.0F;
+
+            // pose of the bones in flat arrays
+            std::vector<std::size_t> channelKeys; // the last used key of every channel of the animation
+            std::vector<Vector3F> positions;
+            std::vector<QuaternionF> rotations;
+            std::vector<Vector3F> scales;
+            std::vector<Matrix4F> localTransforms;
+            std::vector<Matrix4F> modelTransforms;
+            std::vector<Matrix4F> skinMatrices;
+            bool poseDirty = true;
+            bool verticesDirty = true;
+
+            graphics::Buffer vertexBuffer; // skinned vertices
+
+            EventHandler updateHandler;
         };
     } // namespace scene
 } // namespace ouzel
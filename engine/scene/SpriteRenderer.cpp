@@ -21,10 +21,10 @@ namespace ouzel
                                  const Size2F& sourceSize,
                                  const Vector2F& sourceOffset,
                                  const Vector2F& pivot):
-            name(frameName)
+            name(frameName),
+            indexData{0, 1, 2, 1, 3, 2}
         {
-            const std::vector<std::uint16_t> indices = {0, 1, 2, 1, 3, 2};
-            indexCount = static_cast<std::uint32_t>(indices.size());
+            indexCount = static_cast<std::uint32_t>(indexData.size());
 
             Vector2F textCoords[4];
             const Vector2F finalOffset(-sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
@@ -57,7 +57,7 @@ namespace ouzel
                 textCoords[3] = Vector2F(rightBottom.v[0], rightBottom.v[1]);
             }
 
-            const std::vector<graphics::Vertex> vertices{
+            vertexData = {
                 graphics::Vertex(Vector3F{finalOffset.v[0], finalOffset.v[1], 0.0F}, Color::white(),
                                  textCoords[0], Vector3F{0.0F, 0.0F, -1.0F}),
                 graphics::Vertex(Vector3F{finalOffset.v[0] + frameRectangle.size.v[0], finalOffset.v[1], 0.0F}, Color::white(),
@@ -73,19 +73,21 @@ namespace ouzel
 
             indexBuffer = std::make_unique<graphics::Buffer>(*engine->getRenderer(),
                                                              graphics::BufferType::Index, 0,
-                                                             indices.data(),
-                                                             static_cast<std::uint32_t>(getVectorSize(indices)));
+                                                             indexData.data(),
+                                                             static_cast<std::uint32_t>(getVectorSize(indexData)));
 
             vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getRenderer(),
                                                               graphics::BufferType::Vertex,0,
-                                                              vertices.data(),
-                                                              static_cast<std::uint32_t>(getVectorSize(vertices)));
+                                                              vertexData.data(),
+                                                              static_cast<std::uint32_t>(getVectorSize(vertexData)));
         }
 
         SpriteData::Frame::Frame(const std::string& frameName,
                                  const std::vector<std::uint16_t>& indices,
                                  const std::vector<graphics::Vertex>& vertices):
-            name(frameName)
+            name(frameName),
+            indexData(indices),
+            vertexData(vertices)
         {
             indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -110,7 +112,9 @@ namespace ouzel
                                  const Size2F& sourceSize,
                                  const Vector2F& sourceOffset,
                                  const Vector2F& pivot):
-            name(frameName)
+            name(frameName),
+            indexData(indices),
+            vertexData(vertices)
         {
             indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -329,14 +333,10 @@ namespace ouzel
                             renderViewProjection,
                             wireframe);
 
-            if (currentAnimation != animationQueue.end() &&
-                currentAnimation->animation->frameInterval > 0.0F &&
-                !currentAnimation->animation->frames.empty() &&
-                material)
-            {
-                auto currentFrame = static_cast<std::size_t>(currentTime / currentAnimation->animation->frameInterval);
-                if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+            const SpriteData::Frame* frame = getCurrentFrame();
 
+            if (frame && material)
+            {
                 const Matrix4F modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
                 const float colorVector[] = {
                     material->diffuseColor.normR(),
@@ -364,17 +364,53 @@ namespace ouzel
                                                           vertexShaderConstants);
                 engine->getRenderer()->setTextures(textures);
 
-                const SpriteData::Frame& frame = currentAnimation->animation->frames[currentFrame];
-
-                engine->getRenderer()->draw(frame.getIndexBuffer()->getResource(),
-                                            frame.getIndexCount(),
+                engine->getRenderer()->draw(frame->getIndexBuffer()->getResource(),
+                                            frame->getIndexCount(),
                                             sizeof(std::uint16_t),
-                                            frame.getVertexBuffer()->getResource(),
+                                            frame->getVertexBuffer()->getResource(),
                                             graphics::DrawMode::TriangleList,
                                             0);
             }
         }
 
+        bool SpriteRenderer::getBatchData(BatchData& batchData) const
+        {
+            const SpriteData::Frame* frame = getCurrentFrame();
+
+            if (!frame || !material) return false;
+
+            // only the first texture layer is batched
+            for (std::uint32_t i = 1; i < graphics::Material::TEXTURE_LAYERS; ++i)
+                if (material->textures[i]) return false;
+
+            batchData.texture = material->textures[0].get();
+            batchData.blendState = material->blendState;
+            batchData.shader = material->shader;
+            batchData.transform = offsetMatrix;
+            batchData.color = material->diffuseColor;
+            batchData.opacity = material->opacity;
+            batchData.indices = frame->getIndexData().data();
+            batchData.indexCount = frame->getIndexData().size();
+            batchData.vertices = frame->getVertexData().data();
+            batchData.vertexCount = frame->getVertexData().size();
+            batchData.animated = playing;
+
+            return true;
+        }
+
+        const SpriteData::Frame* SpriteRenderer::getCurrentFrame() const
+        {
+            if (currentAnimation == animationQueue.end() ||
+                currentAnimation->animation->frameInterval <= 0.0F ||
+                currentAnimation->animation->frames.empty())
+                return nullptr;
+
+            auto currentFrame = static_cast<std::size_t>(currentTime / currentAnimation->animation->frameInterval);
+            if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+
+            return &currentAnimation->animation->frames[currentFrame];
+        }
+
         void SpriteRenderer::setOffset(const Vector2F& newOffset)
         {
             offset = newOffset;
@@ -57,12 +57,18 @@ namespace ouzel
                 inline auto& getIndexBuffer() const noexcept { return indexBuffer; }
                 inline auto& getVertexBuffer() const noexcept { return vertexBuffer; }
 
+                // copies of the buffer contents for batching
+                inline auto& getIndexData() const noexcept { return indexData; }
+                inline auto& getVertexData() const noexcept { return vertexData; }
+
             private:
                 std::string name;
                 Box2F boundingBox;
                 std::uint32_t indexCount = 0;
                 std::shared_ptr<graphics::Buffer> indexBuffer;
                 std::shared_ptr<graphics::Buffer> vertexBuffer;
+                std::vector<std::uint16_t> indexData;
+                std::vector<graphics::Vertex> vertexData;
             };
 
             struct Animation final
@@ -101,6 +107,8 @@ namespace ouzel
                       const Matrix4F& renderViewProjection,
                       bool wireframe) override;
 
+            bool getBatchData(BatchData& batchData) const override;
+
             inline auto& getMaterial() const noexcept { return material; }
             inline void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
 
@@ -123,6 +131,7 @@ namespace ouzel
 
         private:
             void updateBoundingBox();
+            const SpriteData::Frame* getCurrentFrame() const;
 
             std::shared_ptr<graphics::Material> material;
             std::map<std::string, SpriteData::Animation> animations;
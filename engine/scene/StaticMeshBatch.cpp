@@ -0,0 +1,358 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <limits>
+#include "StaticMeshBatch.hpp"
+#include "StaticMeshRenderer.hpp"
+#include "core/Engine.hpp"
+#include "math/Batch.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        StaticMeshBatch::StaticMeshBatch(const StaticMeshData& initMeshData,
+                                         const graphics::Material& initMaterial,
+                                         const graphics::Shader* initInstancedShader):
+            meshData(initMeshData),
+            material(initMaterial),
+            instancedShader(initInstancedShader)
+        {
+            if (instancedShader) return;
+
+            positions.reserve(meshData.vertices.size());
+            normals.reserve(meshData.vertices.size());
+
+            for (const graphics::Vertex& vertex : meshData.vertices)
+            {
+                positions.push_back(vertex.position);
+                normals.push_back(vertex.normal);
+            }
+        }
+
+        void StaticMeshBatch::addInstance(const void* owner, const Matrix4F& transform, float opacity)
+        {
+            auto i = slots.find(owner);
+
+            if (i == slots.end())
+            {
+                std::size_t slot;
+                if (!freeSlots.empty())
+                {
+                    slot = freeSlots.top();
+                    freeSlots.pop();
+                }
+                else
+                {
+                    slot = instances.size();
+                    instances.emplace_back();
+                }
+
+                i = slots.insert(std::make_pair(owner, slot)).first;
+
+                Instance& instance = instances[slot];
+                instance.owner = owner;
+                instance.transform = transform;
+                instance.opacity = opacity;
+                dirtySlots.push_back(slot);
+            }
+            else
+            {
+                Instance& instance = instances[i->second];
+
+                // the same owner can be drawn only once per frame
+                if (instance.added) return;
+
+                if (instance.transform != transform || instance.opacity != opacity)
+                {
+                    instance.transform = transform;
+                    instance.opacity = opacity;
+                    dirtySlots.push_back(i->second);
+                }
+            }
+
+            instances[i->second].added = true;
+            ++instanceCount;
+        }
+
+        void StaticMeshBatch::reserve(std::size_t slotCount)
+        {
+            if (slotCount <= capacity) return;
+
+            capacity = std::max<std::size_t>(capacity * 2, std::max<std::size_t>(slotCount, 16));
+            uploadAll = true;
+
+            if (instancedShader)
+            {
+                instanceData.resize(capacity);
+                instanceBuffer = graphics::Buffer(*engine->getRenderer(),
+                                                  graphics::BufferType::Vertex,
+                                                  graphics::Flags::Dynamic,
+                                                  static_cast<std::uint32_t>(getVectorSize(instanceData)));
+                return;
+            }
+
+            const auto vertexCount = meshData.vertices.size();
+            vertices.resize(capacity * vertexCount);
+
+            // the indices of every slot point to its own vertices
+            if (capacity * vertexCount > std::numeric_limits<std::uint16_t>::max())
+            {
+                std::vector<std::uint32_t> indices;
+                indices.reserve(capacity * meshData.indices.size());
+                for (std::size_t slot = 0; slot < capacity; ++slot)
+                    for (const auto index : meshData.indices)
+                        indices.push_back(static_cast<std::uint32_t>(slot * vertexCount + index));
+
+                indexSize = sizeof(std::uint32_t);
+                indexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                               graphics::BufferType::Index, 0,
+                                               indices.data(),
+                                               static_cast<std::uint32_t>(getVectorSize(indices)));
+            }
+            else
+            {
+                std::vector<std::uint16_t> indices;
+                indices.reserve(capacity * meshData.indices.size());
+                for (std::size_t slot = 0; slot < capacity; ++slot)
+                    for (const auto index : meshData.indices)
+                        indices.push_back(static_cast<std::uint16_t>(slot * vertexCount + index));
+
+                indexSize = sizeof(std::uint16_t);
+                indexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                               graphics::BufferType::Index, 0,
+                                               indices.data(),
+                                               static_cast<std::uint32_t>(getVectorSize(indices)));
+            }
+
+            vertexBuffer = graphics::Buffer(*engine->getRenderer(),
+                                            graphics::BufferType::Vertex,
+                                            graphics::Flags::Dynamic,
+                                            static_cast<std::uint32_t>(getVectorSize(vertices)));
+        }
+
+        void StaticMeshBatch::uploadInstances()
+        {
+            // the free slots get a zero transform, so their triangles are not rasterized
+            for (const auto slot : dirtySlots)
+            {
+                const Instance& instance = instances[slot];
+                instanceData[slot] = instance.owner ?
+                    graphics::Instance(instance.transform, instance.opacity) :
+                    graphics::Instance(Matrix4F(), 0.0F);
+            }
+
+            if (uploadAll)
+                instanceBuffer.setData(0, instanceData.data(), static_cast<std::uint32_t>(getVectorSize(instanceData)));
+            else if (!dirtySlots.empty())
+            {
+                const auto first = dirtySlots.front();
+                const auto last = dirtySlots.back() + 1;
+                instanceBuffer.setData(static_cast<std::uint32_t>(first * sizeof(graphics::Instance)),
+                                       instanceData.data() + first,
+                                       static_cast<std::uint32_t>((last - first) * sizeof(graphics::Instance)));
+            }
+        }
+
+        void StaticMeshBatch::uploadVertices()
+        {
+            const auto vertexCount = meshData.vertices.size();
+
+            if (!dirtySlots.empty())
+            {
+                const auto writeSlots = [this, vertexCount](std::size_t begin, std::size_t end) {
+                    std::vector<Vector3F> positionBuffer(vertexCount);
+                    std::vector<Vector3F> normalBuffer(vertexCount);
+
+                    for (std::size_t i = begin; i < end; ++i)
+                        writeSlot(dirtySlots[i], positionBuffer, normalBuffer);
+                };
+
+                if (dirtySlots.size() * vertexCount >= PARALLEL_VERTEX_COUNT)
+                    engine->getJobSystem().parallelFor(0, dirtySlots.size(), 0, writeSlots);
+                else
+                    writeSlots(0, dirtySlots.size());
+            }
+
+            // upload only the range of the slots that changed
+            if (uploadAll)
+                vertexBuffer.setData(0, vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+            else if (!dirtySlots.empty())
+            {
+                const auto first = dirtySlots.front() * vertexCount;
+                const auto last = (dirtySlots.back() + 1) * vertexCount;
+                vertexBuffer.setData(static_cast<std::uint32_t>(first * sizeof(graphics::Vertex)),
+                                     vertices.data() + first,
+                                     static_cast<std::uint32_t>((last - first) * sizeof(graphics::Vertex)));
+            }
+        }
+
+        void StaticMeshBatch::writeSlot(std::size_t slot,
+                                        std::vector<Vector3F>& positionBuffer,
+                                        std::vector<Vector3F>& normalBuffer)
+        {
+            const Instance& instance = instances[slot];
+            const auto vertexCount = meshData.vertices.size();
+            graphics::Vertex* slotVertices = vertices.data() + slot * vertexCount;
+
+            // the vertices of the free slots are collapsed into a point, so their triangles are not rasterized
+            if (!instance.owner)
+            {
+                for (std::size_t i = 0; i < vertexCount; ++i)
+                    slotVertices[i].position = Vector3F();
+                return;
+            }
+
+            transformPoints(instance.transform, positions.data(), positionBuffer.data(), vertexCount);
+            transformVectors(instance.transform, normals.data(), normalBuffer.data(), vertexCount);
+
+            for (std::size_t i = 0; i < vertexCount; ++i)
+            {
+                graphics::Vertex& vertex = slotVertices[i];
+                vertex = meshData.vertices[i];
+                vertex.position = positionBuffer[i];
+                vertex.normal = normalBuffer[i];
+                vertex.normal.normalize();
+                vertex.color.v[3] = static_cast<std::uint8_t>(vertex.color.v[3] * instance.opacity);
+            }
+        }
+
+        void StaticMeshBatch::draw(const Matrix4F& renderViewProjection, bool wireframe)
+        {
+            // free the slots of the instances that were not drawn in this frame
+            for (std::size_t slot = 0; slot < instances.size(); ++slot)
+            {
+                Instance& instance = instances[slot];
+
+                if (instance.owner && !instance.added)
+                {
+                    slots.erase(instance.owner);
+                    instance.owner = nullptr;
+                    freeSlots.push(slot);
+                    dirtySlots.push_back(slot);
+                }
+
+                instance.added = false;
+            }
+
+            const auto drawnInstanceCount = instanceCount;
+            instanceCount = 0;
+
+            reserve(instances.size());
+
+            std::sort(dirtySlots.begin(), dirtySlots.end());
+            dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+
+            if (instancedShader)
+                uploadInstances();
+            else
+                uploadVertices();
+
+            uploadAll = false;
+            dirtySlots.clear();
+
+            if (drawnInstanceCount == 0) return;
+
+            const float colorVector[] = {
+                material.diffuseColor.normR(),
+                material.diffuseColor.normG(),
+                material.diffuseColor.normB(),
+                material.diffuseColor.normA() * material.opacity
+            };
+
+            std::vector<std::vector<float>> fragmentShaderConstants(1);
+            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+            // the instance transforms or the CPU transformed vertices are in the world space
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = {std::begin(renderViewProjection.m), std::end(renderViewProjection.m)};
+
+            std::vector<std::uintptr_t> textures;
+            for (const std::shared_ptr<graphics::Texture>& texture : material.textures)
+                textures.push_back(texture ? texture->getResource() : 0);
+
+            engine->getRenderer()->setPipelineState(material.blendState->getResource(),
+                                                    instancedShader ? instancedShader->getResource() : material.shader->getResource(),
+                                                    material.cullMode,
+                                                    wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
+            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
+                                                      vertexShaderConstants);
+            engine->getRenderer()->setTextures(textures);
+
+            if (instancedShader)
+                engine->getRenderer()->drawInstanced(meshData.indexBuffer.getResource(),
+                                                     meshData.indexCount,
+                                                     meshData.indexSize,
+                                                     meshData.vertexBuffer.getResource(),
+                                                     instanceBuffer.getResource(),
+                                                     static_cast<std::uint32_t>(instances.size()),
+                                                     graphics::DrawMode::TriangleList,
+                                                     0);
+            else
+                engine->getRenderer()->draw(indexBuffer.getResource(),
+                                            static_cast<std::uint32_t>(instances.size() * meshData.indices.size()),
+                                            indexSize,
+                                            vertexBuffer.getResource(),
+                                            graphics::DrawMode::TriangleList,
+                                            0);
+        }
+
+        void StaticMeshBatcher::begin(const Camera* camera)
+        {
+            currentCamera = camera;
+            textureShader = engine->getCache().getShader(SHADER_TEXTURE);
+            instancedShader = engine->getCache().getShader(SHADER_TEXTURE_INSTANCED);
+        }
+
+        bool StaticMeshBatcher::addInstance(const StaticMeshData& meshData,
+                                            const graphics::Material& material,
+                                            const void* owner,
+                                            const Matrix4F& transform,
+                                            float opacity)
+        {
+            // the instanced shader replaces only the default texture shader, the other shaders need the CPU copies
+            const graphics::Shader* shader = (instancedShader && material.shader == textureShader) ? instancedShader : nullptr;
+            if (!shader && meshData.vertices.empty()) return false;
+
+            auto& batch = batches[Key(currentCamera, &meshData, &material, shader)];
+            if (!batch) batch = std::make_unique<StaticMeshBatch>(meshData, material, shader);
+
+            batch->addInstance(owner, transform, opacity);
+            return true;
+        }
+        void StaticMeshBatcher::end(const Matrix4F& renderViewProjection, bool wireframe)
+        {
+            for (auto i = batches.begin(); i != batches.end();)
+            {
+                if (std::get<0>(i->first) != currentCamera)
+                {
+                    ++i;
+                    continue;
+                }
+
+                if (i->second->getInstanceCount() == 0)
+                {
+                    i = batches.erase(i);
+                    continue;
+                }
+
+                i->second->draw(renderViewProjection, wireframe);
+                ++i;
+            }
+
+            currentCamera = nullptr;
+        }
+
+        void StaticMeshBatcher::removeCamera(const Camera* camera)
+        {
+            for (auto i = batches.begin(); i != batches.end();)
+            {
+                if (std::get<0>(i->first) == camera)
+                    i = batches.erase(i);
+                else
+                    ++i;
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,117 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_STATICMESHBATCH_HPP
+#define OUZEL_SCENE_STATICMESHBATCH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "graphics/Buffer.hpp"
+#include "graphics/Material.hpp"
+#include "graphics/Shader.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Matrix.hpp"
+#include "math/Vector.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Camera;
+        class StaticMeshData;
+
+        // Draws all the instances of a static mesh that share a material with one draw call. Every instance owns
+        // a slot that is rewritten only when the transform or the opacity of its instance changes, or when the
+        // instance appears or disappears. With an instanced shader the slots are the per-instance stream of an
+        // instanced draw of the mesh buffers, otherwise the slots hold the vertices of the instances transformed
+        // to the world space on the CPU
+        class StaticMeshBatch final
+        {
+        public:
+            // batches with at least this many vertices to transform are split across the job system
+            static constexpr std::size_t PARALLEL_VERTEX_COUNT = 4096;
+
+            StaticMeshBatch(const StaticMeshData& initMeshData,
+                            const graphics::Material& initMaterial,
+                            const graphics::Shader* initInstancedShader);
+
+            void addInstance(const void* owner, const Matrix4F& transform, float opacity);
+
+            // draws the instances that were added since the last call and frees the slots of the missing ones
+            void draw(const Matrix4F& renderViewProjection, bool wireframe);
+
+            inline auto getInstanceCount() const noexcept { return instanceCount; }
+            inline auto getSlotCount() const noexcept { return instances.size(); }
+
+        private:
+            struct Instance final
+            {
+                const void* owner = nullptr; // null for the free slots
+                Matrix4F transform;
+                float opacity = 1.0F;
+                bool added = false; // added during the current frame
+            };
+
+            void reserve(std::size_t slotCount);
+            void uploadInstances();
+            void uploadVertices();
+            void writeSlot(std::size_t slot, std::vector<Vector3F>& positionBuffer, std::vector<Vector3F>& normalBuffer);
+
+            const StaticMeshData& meshData;
+            const graphics::Material& material;
+            const graphics::Shader* instancedShader = nullptr; // null for the CPU path
+
+            std::vector<Vector3F> positions; // positions and normals of the mesh in separate arrays for the batched transforms
+            std::vector<Vector3F> normals;
+
+            std::vector<Instance> instances;
+            std::unordered_map<const void*, std::size_t> slots;
+            std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t>> freeSlots; // the lowest free slot is reused first
+            std::vector<std::size_t> dirtySlots;
+            std::size_t instanceCount = 0;
+            std::size_t capacity = 0;
+            bool uploadAll = false;
+
+            std::vector<graphics::Instance> instanceData; // per-instance stream of all the slots
+            graphics::Buffer instanceBuffer;
+
+            std::vector<graphics::Vertex> vertices; // world space vertices of all the slots
+            std::uint32_t indexSize = 0;
+            graphics::Buffer indexBuffer;
+            graphics::Buffer vertexBuffer;
+        };
+
+        // Groups the instanced static meshes of a layer by camera, mesh, material and shader
+        class StaticMeshBatcher final
+        {
+        public:
+            void begin(const Camera* camera);
+            // returns false if the mesh can't be batched and has to be drawn on its own
+            bool addInstance(const StaticMeshData& meshData,
+                             const graphics::Material& material,
+                             const void* owner,
+                             const Matrix4F& transform,
+                             float opacity);
+            // draws the batches of the current camera, the batches that had no instances are deleted
+            void end(const Matrix4F& renderViewProjection, bool wireframe);
+
+            // deletes the batches of a camera that is no longer drawn
+            void removeCamera(const Camera* camera);
+
+        private:
+            using Key = std::tuple<const Camera*, const StaticMeshData*, const graphics::Material*, const graphics::Shader*>;
+
+            const Camera* currentCamera = nullptr;
+            const graphics::Shader* textureShader = nullptr;
+            const graphics::Shader* instancedShader = nullptr;
+            std::map<Key, std::unique_ptr<StaticMeshBatch>> batches;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_STATICMESHBATCH_HPP
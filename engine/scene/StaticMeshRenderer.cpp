@@ -2,6 +2,7 @@
 
 #include <limits>
 #include "StaticMeshRenderer.hpp"
+#include "Layer.hpp"
 #include "core/Engine.hpp"
 #include "utils/Utils.hpp"
 
@@ -10,11 +11,13 @@ namespace ouzel
     namespace scene
     {
         StaticMeshData::StaticMeshData(const Box3F& initBoundingBox,
-                                       const std::vector<std::uint32_t> indices,
-                                       const std::vector<graphics::Vertex>& vertices,
+                                       std::vector<std::uint32_t> initIndices,
+                                       std::vector<graphics::Vertex> initVertices,
                                        const graphics::Material* initMaterial):
             boundingBox(initBoundingBox),
-            material(initMaterial)
+            material(initMaterial),
+            indices(std::move(initIndices)),
+            vertices(std::move(initVertices))
         {
             indexCount = static_cast<std::uint32_t>(indices.size());
 
@@ -50,21 +53,29 @@ namespace ouzel
                                             graphics::BufferType::Vertex, 0,
                                             vertices.data(),
                                             static_cast<std::uint32_t>(getVectorSize(vertices)));
+
+            // the devices that draw instanced read the instances straight from the buffers above
+            if (engine->getRenderer()->getDevice()->isInstancingSupported())
+            {
+                indices = std::vector<std::uint32_t>();
+                vertices = std::vector<graphics::Vertex>();
+            }
         }
 
-        StaticMeshRenderer::StaticMeshRenderer(const StaticMeshData& meshData)
+        StaticMeshRenderer::StaticMeshRenderer(const StaticMeshData& initMeshData)
         {
-            init(meshData);
+            init(initMeshData);
         }
 
-        void StaticMeshRenderer::init(const StaticMeshData& meshData)
+        void StaticMeshRenderer::init(const StaticMeshData& newMeshData)
         {
-            boundingBox = meshData.boundingBox;
-            material = meshData.material;
-            indexCount = meshData.indexCount;
-            indexSize = meshData.indexSize;
-            indexBuffer = &meshData.indexBuffer;
-            vertexBuffer = &meshData.vertexBuffer;
+            meshData = &newMeshData;
+            boundingBox = newMeshData.boundingBox;
+            material = newMeshData.material;
+            indexCount = newMeshData.indexCount;
+            indexSize = newMeshData.indexSize;
+            indexBuffer = &newMeshData.indexBuffer;
+            vertexBuffer = &newMeshData.vertexBuffer;
         }
 
         void StaticMeshRenderer::draw(const Matrix4F& transformMatrix,
@@ -77,6 +88,10 @@ namespace ouzel
                             renderViewProjection,
                             wireframe);
 
+            if (instanced && layer && meshData && material &&
+                layer->getMeshBatcher().addInstance(*meshData, *material, this, transformMatrix, opacity))
+                return;
+
             const Matrix4F modelViewProj = renderViewProjection * transformMatrix;
             const float colorVector[] = {
                 material->diffuseColor.normR(),
@@ -18,12 +18,14 @@ namespace ouzel
         public:
             StaticMeshData() = default;
             StaticMeshData(const Box3F& initBoundingBox,
-                           const std::vector<std::uint32_t> indices,
-                           const std::vector<graphics::Vertex>& vertices,
+                           std::vector<std::uint32_t> initIndices,
+                           std::vector<graphics::Vertex> initVertices,
                            const graphics::Material* initMaterial);
 
             Box3F boundingBox;
             const graphics::Material* material = nullptr;
+            std::vector<std::uint32_t> indices; // CPU copies of the geometry, kept only for the devices that can't draw instanced
+            std::vector<graphics::Vertex> vertices;
             std::uint32_t indexCount = 0;
             std::uint32_t indexSize = 0;
             graphics::Buffer indexBuffer;
@@ -34,9 +36,9 @@ namespace ouzel
         {
         public:
             StaticMeshRenderer() = default;
-            explicit StaticMeshRenderer(const StaticMeshData& meshData);
+            explicit StaticMeshRenderer(const StaticMeshData& initMeshData);
 
-            void init(const StaticMeshData& meshData);
+            void init(const StaticMeshData& newMeshData);
 
             void draw(const Matrix4F& transformMatrix,
                       float opacity,
@@ -49,8 +51,15 @@ namespace ouzel
                 material = newMaterial;
             }
 
+            // instanced meshes are drawn by the layer together with the other instances of the same mesh and material,
+            // on the devices that draw instanced only the meshes with the default texture shader are batched
+            inline auto isInstanced() const noexcept { return instanced; }
+            inline void setInstanced(bool newInstanced) { instanced = newInstanced; }
+
         private:
+            const StaticMeshData* meshData = nullptr;
             const graphics::Material* material = nullptr;
+            bool instanced = false;
             std::uint32_t indexCount = 0;
             std::uint32_t indexSize = 0;
             const graphics::Buffer* indexBuffer = nullptr;
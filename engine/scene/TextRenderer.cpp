@@ -1,10 +1,12 @@
 // Copyright 2015-2020 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "TextRenderer.hpp"
 #include "core/Engine.hpp"
 #include "graphics/Renderer.hpp"
 #include "scene/Camera.hpp"
 #include "assets/Cache.hpp"
+#include "utils/Utf8.hpp"
 #include "utils/Utils.hpp"
 
 namespace ouzel
@@ -69,12 +71,24 @@ namespace ouzel
 
             if (needsMeshUpdate)
             {
-                indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
-                vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
+                // the buffers are reused, only the indices that were added and the vertices that changed are uploaded
+                if (indices.size() > uploadedIndexCount)
+                    indexBuffer.setData(static_cast<std::uint32_t>(uploadedIndexCount * sizeof(std::uint16_t)),
+                                        indices.data() + uploadedIndexCount,
+                                        static_cast<std::uint32_t>((indices.size() - uploadedIndexCount) * sizeof(std::uint16_t)));
 
+                if (vertices.size() > dirtyVertexBegin)
+                    vertexBuffer.setData(static_cast<std::uint32_t>(dirtyVertexBegin * sizeof(graphics::Vertex)),
+                                         vertices.data() + dirtyVertexBegin,
+                                         static_cast<std::uint32_t>((vertices.size() - dirtyVertexBegin) * sizeof(graphics::Vertex)));
+
+                uploadedIndexCount = indices.size();
+                dirtyVertexBegin = vertices.size();
                 needsMeshUpdate = false;
             }
 
+            if (indexCount == 0) return;
+
             const Matrix4F modelViewProj = renderViewProjection * transformMatrix;
             const float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
 
@@ -92,15 +106,33 @@ namespace ouzel
                                                       vertexShaderConstants);
             engine->getRenderer()->setTextures({wireframe ? whitePixelTexture->getResource() : texture->getResource()});
             engine->getRenderer()->draw(indexBuffer.getResource(),
-                                        static_cast<std::uint32_t>(indices.size()),
+                                        static_cast<std::uint32_t>(indexCount),
                                         sizeof(std::uint16_t),
                                         vertexBuffer.getResource(),
                                         graphics::DrawMode::TriangleList,
                                         0);
         }
 
+        bool TextRenderer::getBatchData(BatchData& batchData) const
+        {
+            if (!texture) return false;
+
+            batchData.texture = texture.get();
+            batchData.blendState = blendState;
+            batchData.shader = shader;
+            batchData.color = color;
+            batchData.indices = indices.data();
+            batchData.indexCount = indexCount;
+            batchData.vertices = vertices.data();
+            batchData.vertexCount = vertices.size();
+
+            return true;
+        }
+
         void TextRenderer::setText(const std::string& newText)
         {
+            if (newText == text) return;
+
             text = newText;
 
             updateText();
@@ -113,6 +145,19 @@ namespace ouzel
 
         void TextRenderer::updateText()
         {
+            if (font && font->isGlyphLayoutSupported())
+            {
+                updateLayout();
+                return;
+            }
+
+            layoutFont = nullptr;
+            characters.clear();
+            glyphLayouts.clear();
+            layoutVertices.clear();
+            lineWidths.clear();
+            lineStarts.clear();
+
             boundingBox.reset();
 
             if (font)
@@ -129,6 +174,157 @@ namespace ouzel
                 vertices.clear();
                 texture.reset();
             }
+
+            indexCount = indices.size();
+            uploadedIndexCount = 0;
+            dirtyVertexBegin = 0;
+        }
+
+        void TextRenderer::updateLayout()
+        {
+            std::u32string newCharacters = utf8::toUtf32(text);
+
+            std::size_t start = 0;
+
+            if (layoutFont == font)
+            {
+                // the characters before the first edited one keep their layout, except the one right before it,
+                // because its kerning depends on the next character
+                const std::size_t length = std::min(characters.size(), newCharacters.size());
+                while (start < length && characters[start] == newCharacters[start]) ++start;
+                if (start > 0) --start;
+            }
+            else
+            {
+                layoutFont = font;
+                texture = font->getTexture();
+
+                glyphLayouts.clear();
+                layoutVertices.clear();
+                lineWidths.clear();
+                lineStarts.clear();
+                indices.clear();
+                uploadedIndexCount = 0;
+            }
+
+            const std::size_t previousLineCount = lineWidths.size();
+            const float lineHeight = font->getLineHeight();
+
+            float penX = 0.0F;
+            std::size_t line = 0;
+            std::size_t firstVertex = 0;
+
+            if (start < glyphLayouts.size())
+            {
+                penX = glyphLayouts[start].x;
+                line = glyphLayouts[start].line;
+                firstVertex = glyphLayouts[start].firstVertex;
+            }
+
+            characters = std::move(newCharacters);
+            glyphLayouts.resize(start);
+            layoutVertices.resize(firstVertex);
+            lineWidths.resize(line);
+            lineStarts.resize(line + 1);
+
+            for (std::size_t i = start; i < characters.size(); ++i)
+            {
+                const char32_t character = characters[i];
+
+                GlyphLayout glyphLayout;
+                glyphLayout.x = penX;
+                glyphLayout.line = line;
+                glyphLayout.firstVertex = layoutVertices.size();
+                glyphLayouts.push_back(glyphLayout);
+
+                gui::Font::Glyph glyph;
+                if (font->getGlyph(character, glyph))
+                {
+                    const float left = penX + glyph.offset.v[0];
+                    const float top = -static_cast<float>(line) * lineHeight - glyph.offset.v[1];
+
+                    layoutVertices.emplace_back(Vector3F{left, top - glyph.size.v[1], 0.0F},
+                                                Color::white(), Vector2F{glyph.leftTop.v[0], glyph.rightBottom.v[1]}, Vector3F{0.0F, 0.0F, -1.0F});
+                    layoutVertices.emplace_back(Vector3F{left + glyph.size.v[0], top - glyph.size.v[1], 0.0F},
+                                                Color::white(), Vector2F{glyph.rightBottom.v[0], glyph.rightBottom.v[1]}, Vector3F{0.0F, 0.0F, -1.0F});
+                    layoutVertices.emplace_back(Vector3F{left, top, 0.0F},
+                                                Color::white(), Vector2F{glyph.leftTop.v[0], glyph.leftTop.v[1]}, Vector3F{0.0F, 0.0F, -1.0F});
+                    layoutVertices.emplace_back(Vector3F{left + glyph.size.v[0], top, 0.0F},
+                                                Color::white(), Vector2F{glyph.rightBottom.v[0], glyph.leftTop.v[1]}, Vector3F{0.0F, 0.0F, -1.0F});
+
+                    if (i + 1 < characters.size())
+                        penX += font->getKerning(character, characters[i + 1]);
+
+                    penX += glyph.advance;
+                }
+
+                if (character == '\n' || // line feed
+                    i + 1 == characters.size()) // end of string
+                {
+                    lineWidths.push_back(penX);
+                    penX = 0.0F;
+                    ++line;
+
+                    if (i + 1 < characters.size())
+                        lineStarts.push_back(i + 1);
+                }
+            }
+
+            // the anchor offsets depend on the line widths and the text height,
+            // so only the lines that were laid out again have to be moved, unless the line count changed
+            std::size_t finalizeStart = 0;
+            if (lineWidths.size() == previousLineCount &&
+                fontSize == layoutFontSize &&
+                textAnchor == layoutTextAnchor)
+                finalizeStart = (start < glyphLayouts.size()) ? lineStarts[glyphLayouts[start].line] : glyphLayouts.size();
+
+            const float textHeight = static_cast<float>(lineWidths.size()) * lineHeight;
+
+            vertices.resize(layoutVertices.size());
+            std::size_t dirtyVertex = firstVertex;
+
+            for (std::size_t i = finalizeStart; i < glyphLayouts.size(); ++i)
+            {
+                const GlyphLayout& glyphLayout = glyphLayouts[i];
+                const std::size_t endVertex = (i + 1 < glyphLayouts.size()) ? glyphLayouts[i + 1].firstVertex : layoutVertices.size();
+                const float lineOffset = lineWidths[glyphLayout.line] * textAnchor.v[0];
+
+                for (std::size_t v = glyphLayout.firstVertex; v < endVertex; ++v)
+                {
+                    graphics::Vertex vertex = layoutVertices[v];
+                    vertex.position.v[0] = (vertex.position.v[0] - lineOffset) * fontSize;
+                    vertex.position.v[1] = (vertex.position.v[1] + textHeight * (1.0F - textAnchor.v[1])) * fontSize;
+
+                    if (v >= firstVertex || vertex.position != vertices[v].position)
+                    {
+                        vertices[v] = vertex;
+                        dirtyVertex = std::min(dirtyVertex, v);
+                    }
+                }
+            }
+
+            const std::size_t quadCount = layoutVertices.size() / 4;
+            for (std::size_t quad = indices.size() / 6; quad < quadCount; ++quad)
+            {
+                const auto startIndex = static_cast<std::uint16_t>(quad * 4);
+                indices.push_back(startIndex + 0);
+                indices.push_back(startIndex + 1);
+                indices.push_back(startIndex + 2);
+
+                indices.push_back(startIndex + 1);
+                indices.push_back(startIndex + 3);
+                indices.push_back(startIndex + 2);
+            }
+
+            indexCount = quadCount * 6;
+            dirtyVertexBegin = std::min(dirtyVertexBegin, dirtyVertex);
+            layoutFontSize = fontSize;
+            layoutTextAnchor = textAnchor;
+            needsMeshUpdate = true;
+
+            boundingBox.reset();
+            for (const graphics::Vertex& vertex : vertices)
+                boundingBox.insertPoint(vertex.position);
         }
     } // namespace scene
 } // namespace ouzel
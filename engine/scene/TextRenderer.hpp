@@ -30,6 +30,8 @@ namespace ouzel
                       const Matrix4F& renderViewProjection,
                       bool wireframe) override;
 
+            bool getBatchData(BatchData& batchData) const override;
+
             void setFont(const std::string& fontFile);
 
             inline auto getFontSize() const noexcept { return fontSize; }
@@ -58,6 +60,15 @@ namespace ouzel
 
         private:
             void updateText();
+            void updateLayout();
+
+            // layout of a character before anchoring and scaling
+            struct GlyphLayout final
+            {
+                float x = 0.0F; // pen position
+                std::size_t line = 0;
+                std::size_t firstVertex = 0;
+            };
 
             const graphics::Shader* shader = nullptr;
             const graphics::BlendState* blendState = nullptr;
@@ -75,9 +86,22 @@ namespace ouzel
 
             std::vector<std::uint16_t> indices;
             std::vector<graphics::Vertex> vertices;
+            std::size_t indexCount = 0;
+
+            // cached layout for fonts that support glyph layout
+            const gui::Font* layoutFont = nullptr;
+            float layoutFontSize = 0.0F;
+            Vector2F layoutTextAnchor;
+            std::u32string characters;
+            std::vector<GlyphLayout> glyphLayouts;
+            std::vector<graphics::Vertex> layoutVertices;
+            std::vector<float> lineWidths;
+            std::vector<std::size_t> lineStarts;
 
             Color color = Color::white();
 
+            std::size_t uploadedIndexCount = 0;
+            std::size_t dirtyVertexBegin = 0;
             bool needsMeshUpdate = false;
         };
     } // namespace scene
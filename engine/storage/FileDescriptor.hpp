@@ -0,0 +1,33 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_FILEDESCRIPTOR_HPP
+#define OUZEL_STORAGE_FILEDESCRIPTOR_HPP
+
+#include <unistd.h>
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // closes the descriptor when it goes out of scope, also when a constructor of the owner throws
+        class FileDescriptor final
+        {
+        public:
+            FileDescriptor() noexcept = default;
+            ~FileDescriptor() { if (fd != -1) close(fd); }
+            FileDescriptor(const FileDescriptor&) = delete;
+            FileDescriptor& operator=(const FileDescriptor&) = delete;
+            FileDescriptor& operator=(int f) noexcept
+            {
+                if (fd != -1) close(fd);
+                fd = f;
+                return *this;
+            }
+            operator int() const noexcept { return fd; }
+        private:
+            int fd = -1;
+        };
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_FILEDESCRIPTOR_HPP
@@ -3,7 +3,6 @@
 #include "core/Setup.h"
 
 #include <algorithm>
-#include <fstream>
 #if defined(_WIN32)
 #  pragma push_macro("WIN32_LEAN_AND_MEAN")
 #  pragma push_macro("NOMINMAX")
@@ -293,23 +292,27 @@ namespace ouzel
                 if (!asset)
                     throw std::runtime_error("Failed to open file " + filename);
 
-                std::vector<std::uint8_t> data;
-                std::uint8_t buffer[1024];
+                std::vector<std::uint8_t> data(static_cast<std::size_t>(AAsset_getLength(asset)));
+                std::size_t offset = 0;
 
-                for (;;)
+                while (offset < data.size())
                 {
-                    const int bytesRead = AAsset_read(asset, buffer, sizeof(buffer));
+                    const int bytesRead = AAsset_read(asset, data.data() + offset, data.size() - offset);
 
                     if (bytesRead < 0)
+                    {
+                        AAsset_close(asset);
                         throw std::runtime_error("Failed to read from file");
+                    }
                     else if (bytesRead == 0)
                         break;
 
-                    data.insert(data.end(), buffer, buffer + bytesRead);
+                    offset += static_cast<std::size_t>(bytesRead);
                 }
 
                 AAsset_close(asset);
 
+                data.resize(offset);
                 return data;
             }
 #endif
@@ -320,34 +323,167 @@ namespace ouzel
             if (path.empty())
                 throw std::runtime_error("Failed to find file " + filename);
 
-            std::ifstream f(path, std::ios::binary);
-            return {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+#if defined(_WIN32)
+            const int bufferSize = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+            if (bufferSize == 0)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+            std::vector<WCHAR> buffer(bufferSize);
+            if (MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, buffer.data(), bufferSize) == 0)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+            // relative paths longer than MAX_PATH are not supported
+            if (buffer.size() > MAX_PATH)
+                buffer.insert(buffer.begin(), {L'\\', L'\\', L'?', L'\\'});
+
+            const HANDLE file = CreateFileW(buffer.data(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to open file " + filename);
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size))
+            {
+                const DWORD error = GetLastError();
+                CloseHandle(file);
+                throw std::system_error(error, std::system_category(), "Failed to get file size");
+            }
+
+            std::vector<std::uint8_t> data(static_cast<std::size_t>(size.QuadPart));
+            std::size_t offset = 0;
+
+            while (offset < data.size())
+            {
+                const auto count = static_cast<DWORD>(std::min<std::size_t>(data.size() - offset, 0x40000000U));
+                DWORD bytesRead;
+                if (!ReadFile(file, data.data() + offset, count, &bytesRead, nullptr))
+                {
+                    const DWORD error = GetLastError();
+                    CloseHandle(file);
+                    throw std::system_error(error, std::system_category(), "Failed to read from file");
+                }
+
+                if (bytesRead == 0) break;
+
+                offset += bytesRead;
+            }
+
+            CloseHandle(file);
+
+            data.resize(offset);
+            return data;
+#elif defined(__unix__) || defined(__APPLE__)
+            FileDescriptor file;
+            if ((file = open(path.c_str(), O_RDONLY | O_CLOEXEC)) == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to open file " + filename);
+
+            struct stat s;
+            if (fstat(file, &s) == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to get file stats");
+
+            // read the whole file at once into a buffer of the file's size, some special files report zero size
+            std::vector<std::uint8_t> data(s.st_size > 0 ? static_cast<std::size_t>(s.st_size) : 4096);
+            std::size_t offset = 0;
+
+            for (;;)
+            {
+                if (offset == data.size())
+                {
+                    if (s.st_size > 0) break;
+                    data.resize(data.size() * 2);
+                }
+
+                const ssize_t bytesRead = read(file, data.data() + offset, data.size() - offset);
+                if (bytesRead == -1)
+                {
+                    if (errno == EINTR) continue;
+                    throw std::system_error(errno, std::system_category(), "Failed to read from file");
+                }
+
+                if (bytesRead == 0) break;
+
+                offset += static_cast<std::size_t>(bytesRead);
+            }
+
+            data.resize(offset);
+            return data;
+#endif
+        }
+
+        MappedFile FileSystem::mapFile(const std::string& filename, const bool searchResources)
+        {
+            if (searchResources)
+                for (auto& archive : archives)
+                    if (archive.second.fileExists(filename))
+                        return MappedFile();
+
+#if defined(__ANDROID__)
+            if (!Path(filename).isAbsolute())
+                return MappedFile();
+#endif
+
+            return MappedFile(getPath(filename, searchResources));
         }
 
         bool FileSystem::resourceFileExists(const std::string& filename) const
+        {
+            return !findPath(filename, true).empty();
+        }
+
+        std::string FileSystem::findPath(const std::string& filename, const bool searchResources) const
         {
             if (Path(filename).isAbsolute())
-                return fileExists(filename);
-            else
+                return fileExists(filename) ? filename : std::string();
+
+            if (!searchResources)
             {
                 std::string str = appPath + Path::directorySeparator + filename;
+                return fileExists(str) ? str : std::string();
+            }
 
-                if (fileExists(str))
-                    return true;
-                else
-                    for (const std::string& path : resourcePaths)
-                    {
-                        if (Path(path).isAbsolute()) // if resource path is absolute
-                            str = path + Path::directorySeparator + filename;
-                        else
-                            str = appPath + Path::directorySeparator + path + Path::directorySeparator + filename;
+            // resolving a resource file probes every resource directory, so cache the result
+            // the cache assumes that the resource directories don't change while the engine runs, a cached path
+            // is returned even if a copy of the file is later added to a location with a higher priority, so
+            // clearPathCache must be called after adding files to the resource directories
+            {
+                std::unique_lock<std::mutex> lock(pathCacheMutex);
+                const auto i = pathCache.find(filename);
+                if (i != pathCache.end())
+                {
+                    if (fileExists(i->second))
+                        return i->second;
+
+                    pathCache.erase(i);
+                }
+            }
+
+            std::string str = appPath + Path::directorySeparator + filename;
 
-                        if (fileExists(str))
-                            return true;
+            if (!fileExists(str))
+            {
+                str.clear();
+
+                for (const std::string& path : resourcePaths)
+                {
+                    std::string resourcePath;
+                    if (Path(path).isAbsolute()) // if resource path is absolute
+                        resourcePath = path + Path::directorySeparator + filename;
+                    else
+                        resourcePath = appPath + Path::directorySeparator + path + Path::directorySeparator + filename;
+
+                    if (fileExists(resourcePath))
+                    {
+                        str = std::move(resourcePath);
+                        break;
                     }
+                }
 
-                return false;
+                if (str.empty()) return str;
             }
+
+            std::unique_lock<std::mutex> lock(pathCacheMutex);
+            pathCache[filename] = str;
+            return str;
         }
 
         bool FileSystem::directoryExists(const std::string& dirname) const
@@ -3,10 +3,14 @@
 #ifndef OUZEL_STORAGE_FILESYSTEM_HPP
 #define OUZEL_STORAGE_FILESYSTEM_HPP
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <system_error>
+#include <unordered_map>
 #include <vector>
 #if defined(_WIN32)
 #  pragma push_macro("WIN32_LEAN_AND_MEAN")
@@ -27,8 +31,17 @@
 #  include <sys/fcntl.h>
 #  include <sys/stat.h>
 #  include <unistd.h>
+#  if defined(__APPLE__)
+#    include <copyfile.h>
+#  elif defined(__linux__)
+#    include <sys/sendfile.h>
+#  endif
 #endif
 #include "storage/Archive.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#  include "storage/FileDescriptor.hpp"
+#endif
+#include "storage/MappedFile.hpp"
 #include "storage/Path.hpp"
 
 namespace ouzel
@@ -70,37 +83,18 @@ namespace ouzel
             }
 
             std::vector<std::uint8_t> readFile(const std::string& filename, const bool searchResources = true);
+            // returns an empty mapping for files that are not stored on disk (e.g. in archives)
+            MappedFile mapFile(const std::string& filename, const bool searchResources = true);
 
             bool resourceFileExists(const std::string& filename) const;
 
             std::string getPath(const std::string& filename, const bool searchResources = true) const
             {
-                if (Path(filename).isAbsolute())
-                {
-                    if (fileExists(filename))
-                        return filename;
-                }
-                else
-                {
-                    std::string str = appPath + Path::directorySeparator + filename;
-
-                    if (fileExists(str))
-                        return str;
-
-                    if (searchResources)
-                        for (const std::string& path : resourcePaths)
-                        {
-                            if (Path(path).isAbsolute()) // if resource path is absolute
-                                str = path + Path::directorySeparator + filename;
-                            else
-                                str = appPath + Path::directorySeparator + path + Path::directorySeparator + filename;
-
-                            if (fileExists(str))
-                                return str;
-                        }
-                }
+                std::string path = findPath(filename, searchResources);
+                if (path.empty())
+                    throw std::runtime_error("Could not get path for " + filename);
 
-                throw std::runtime_error("Could not get path for " + filename);
+                return path;
             }
 
             void addResourcePath(const std::string& path)
@@ -108,7 +102,10 @@ namespace ouzel
                 const auto i = std::find(resourcePaths.begin(), resourcePaths.end(), path);
 
                 if (i == resourcePaths.end())
+                {
                     resourcePaths.push_back(path);
+                    clearPathCache();
+                }
             }
 
             void removeResourcePath(const std::string& path)
@@ -116,7 +113,17 @@ namespace ouzel
                 const auto i = std::find(resourcePaths.begin(), resourcePaths.end(), path);
 
                 if (i != resourcePaths.end())
+                {
                     resourcePaths.erase(i);
+                    clearPathCache();
+                }
+            }
+
+            // forgets the resolved resource paths, must be called if files are added to the resource directories
+            void clearPathCache()
+            {
+                std::unique_lock<std::mutex> lock(pathCacheMutex);
+                pathCache.clear();
             }
 
             void addArchive(const std::string& name, Archive&& archive)
@@ -183,24 +190,6 @@ namespace ouzel
                 if (!CopyFileW(from.getNative().c_str(), to.getNative().c_str(), !overwrite))
                     throw std::system_error(GetLastError(), std::system_category(), "Failed to copy file");
 #elif defined(__unix__) || defined(__APPLE__)
-                class FileDescriptor final
-                {
-                public:
-                    FileDescriptor() noexcept = default;
-                    ~FileDescriptor() { if (fd != -1) close(fd); }
-                    FileDescriptor(const FileDescriptor&) = delete;
-                    FileDescriptor& operator=(const FileDescriptor&) = delete;
-                    FileDescriptor& operator=(int f) noexcept
-                    {
-                        if (fd != -1) close(fd);
-                        fd = f;
-                        return *this;
-                    }
-                    operator int() const noexcept { return fd; }
-                private:
-                    int fd = -1;
-                };
-
                 FileDescriptor in;
                 if ((in = open(from.getNative().c_str(), O_RDONLY)) == -1)
                     throw std::system_error(errno, std::system_category(), "Failed to open file");
@@ -215,6 +204,16 @@ namespace ouzel
                 if ((out = open(to.getNative().c_str(), mode, s.st_mode)) == -1)
                     throw std::system_error(errno, std::system_category(), "Failed to open file");
 
+#  if defined(__APPLE__)
+                if (fcopyfile(in, out, nullptr, COPYFILE_DATA) == -1)
+                    throw std::system_error(errno, std::system_category(), "Failed to copy file");
+#  else
+#    if defined(__linux__)
+                // let the kernel copy the data (or share the blocks on filesystems that support it),
+                // special files that report zero size are copied with reads and writes
+                if (s.st_size > 0 && copyInKernel(in, out, s.st_size)) return;
+#    endif
+
                 std::vector<char> buffer(16384);
                 for (;;)
                 {
@@ -235,6 +234,7 @@ namespace ouzel
                         offset += bytesWritten;
                     } while (bytesRead);
                 }
+#  endif
 #endif
             }
 
@@ -271,10 +271,59 @@ namespace ouzel
             }
 
         private:
+#if defined(__linux__)
+            // returns false if the kernel can't copy between these files and nothing was copied
+            static bool copyInKernel(int in, int out, off_t size)
+            {
+#  if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+                bool useCopyFileRange = true;
+#  endif
+                off_t offset = 0;
+
+                while (offset < size)
+                {
+                    const auto count = static_cast<std::size_t>(size - offset);
+                    ssize_t result = -1;
+
+#  if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+                    if (useCopyFileRange)
+                    {
+                        result = copy_file_range(in, nullptr, out, nullptr, count, 0);
+
+                        // not supported by the kernel or between these filesystems
+                        if (result == -1 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+                            useCopyFileRange = false;
+                    }
+
+                    if (!useCopyFileRange)
+#  endif
+                        result = sendfile(out, in, nullptr, count);
+
+                    if (result == -1)
+                    {
+                        if (errno == EINTR) continue;
+                        if (offset == 0 && (errno == ENOSYS || errno == EINVAL)) return false;
+                        throw std::system_error(errno, std::system_category(), "Failed to copy file");
+                    }
+
+                    if (result == 0) break; // the file was truncated while copying
+
+                    offset += result;
+                }
+
+                return true;
+            }
+#endif
+
+            std::string findPath(const std::string& filename, const bool searchResources) const;
+
             Engine& engine;
             std::string appPath;
             std::vector<std::string> resourcePaths;
             std::vector<std::pair<std::string, Archive>> archives;
+
+            mutable std::mutex pathCacheMutex;
+            mutable std::unordered_map<std::string, std::string> pathCache; // resolved paths of the resource files, valid only while the resource directories are unchanged
         };
     } // namespace storage
 } // namespace ouzel
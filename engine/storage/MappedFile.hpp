@@ -0,0 +1,174 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_MAPPEDFILE_HPP
+#define OUZEL_STORAGE_MAPPEDFILE_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+#if defined(_WIN32)
+#  pragma push_macro("WIN32_LEAN_AND_MEAN")
+#  pragma push_macro("NOMINMAX")
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <Windows.h>
+#  pragma pop_macro("WIN32_LEAN_AND_MEAN")
+#  pragma pop_macro("NOMINMAX")
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <sys/fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // Read-only view of a whole file mapped into memory, the pages are loaded on first access
+        class MappedFile final
+        {
+        public:
+            MappedFile() noexcept = default;
+
+            explicit MappedFile(const std::string& path)
+            {
+#if defined(_WIN32)
+                const int bufferSize = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+                if (bufferSize == 0)
+                    throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+                std::vector<WCHAR> buffer(bufferSize);
+                if (MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, buffer.data(), bufferSize) == 0)
+                    throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+                // relative paths longer than MAX_PATH are not supported
+                if (buffer.size() > MAX_PATH)
+                    buffer.insert(buffer.begin(), {L'\\', L'\\', L'?', L'\\'});
+
+                const HANDLE file = CreateFileW(buffer.data(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (file == INVALID_HANDLE_VALUE)
+                    throw std::system_error(GetLastError(), std::system_category(), "Failed to open file " + path);
+
+                LARGE_INTEGER fileSize;
+                if (!GetFileSizeEx(file, &fileSize))
+                {
+                    const DWORD error = GetLastError();
+                    CloseHandle(file);
+                    throw std::system_error(error, std::system_category(), "Failed to get file size");
+                }
+
+                // empty files can't be mapped
+                if (fileSize.QuadPart == 0)
+                {
+                    CloseHandle(file);
+                    return;
+                }
+
+                const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                const DWORD mappingError = GetLastError();
+                CloseHandle(file); // the mapping keeps the file open
+
+                if (!mapping)
+                    throw std::system_error(mappingError, std::system_category(), "Failed to create file mapping");
+
+                data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                const DWORD viewError = GetLastError();
+                CloseHandle(mapping); // the view keeps the mapping alive
+
+                if (!data)
+                    throw std::system_error(viewError, std::system_category(), "Failed to map file");
+
+                size = static_cast<std::size_t>(fileSize.QuadPart);
+#elif defined(__unix__) || defined(__APPLE__)
+                const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (file == -1)
+                    throw std::system_error(errno, std::system_category(), "Failed to open file " + path);
+
+                struct stat s;
+                if (fstat(file, &s) == -1)
+                {
+                    const int error = errno;
+                    close(file);
+                    throw std::system_error(error, std::system_category(), "Failed to get file stats");
+                }
+
+                // empty files can't be mapped
+                if (s.st_size == 0)
+                {
+                    close(file);
+                    return;
+                }
+
+                void* address = mmap(nullptr, static_cast<std::size_t>(s.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+                const int error = errno;
+                close(file); // the mapping keeps the file open
+
+                if (address == MAP_FAILED)
+                    throw std::system_error(error, std::system_category(), "Failed to map file");
+
+                data = static_cast<const std::uint8_t*>(address);
+                size = static_cast<std::size_t>(s.st_size);
+#endif
+            }
+
+            ~MappedFile()
+            {
+                unmap();
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            MappedFile(MappedFile&& other) noexcept:
+                data(other.data),
+                size(other.size)
+            {
+                other.data = nullptr;
+                other.size = 0;
+            }
+
+            MappedFile& operator=(MappedFile&& other) noexcept
+            {
+                if (&other == this) return *this;
+
+                unmap();
+                data = other.data;
+                size = other.size;
+                other.data = nullptr;
+                other.size = 0;
+
+                return *this;
+            }
+
+            // returns nullptr if nothing is mapped
+            inline auto getData() const noexcept { return data; }
+            inline auto getSize() const noexcept { return size; }
+
+        private:
+            void unmap() noexcept
+            {
+                if (data)
+                {
+#if defined(_WIN32)
+                    UnmapViewOfFile(data);
+#elif defined(__unix__) || defined(__APPLE__)
+                    munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+                }
+            }
+
+            const std::uint8_t* data = nullptr;
+            std::size_t size = 0;
+        };
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_MAPPEDFILE_HPP
@@ -27,16 +27,443 @@
 #  include <emscripten.h>
 #endif
 
+#include <chrono>
 #include "Log.hpp"
 
 namespace ouzel
 {
+    namespace
+    {
+        std::atomic<std::uint64_t> lastLoggerId{0};
+
+        template <typename T>
+        bool decode(const std::uint8_t* data, std::size_t size, std::size_t& offset, T& value) noexcept
+        {
+            if (size - offset < sizeof(value)) return false;
+            std::memcpy(&value, data + offset, sizeof(value));
+            offset += sizeof(value);
+            return true;
+        }
+
+        void appendHex(std::string& str, std::uint64_t value, std::size_t digitCount)
+        {
+            constexpr char digits[] = "0123456789abcdef";
+
+            for (std::size_t i = 0; i < digitCount; ++i)
+                str.push_back(digits[(value >> ((digitCount - i - 1) * 4)) & 0x0F]);
+        }
+    }
+
+    // Single producer (the logging thread), single consumer (the logger thread) ring buffer of log records
+    class Logger::Buffer final
+    {
+    public:
+        static constexpr std::size_t CAPACITY = 65536; // must be a power of two
+        static constexpr std::size_t HEADER_SIZE = sizeof(std::uint32_t) + 2; // payload size, level and flags
+
+        static constexpr std::uint8_t TRUNCATED = 0x01;
+        static constexpr std::uint8_t HEAP = 0x02; // the payload is a pointer to a heap allocated record
+
+        Buffer(): data(CAPACITY) {}
+
+        ~Buffer()
+        {
+            // free the heap records that were not read
+            Log::Level level;
+            std::vector<std::uint8_t> payload;
+            bool truncated;
+            while (read(level, payload, truncated));
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        bool write(Log::Level level, const std::uint8_t* payload, std::size_t payloadSize, bool truncated)
+        {
+            return writeRecord(level, payload, payloadSize, static_cast<std::uint8_t>(truncated ? TRUNCATED : 0));
+        }
+
+        bool write(Log::Level level, std::unique_ptr<std::vector<std::uint8_t>>& heapData, bool truncated)
+        {
+            std::vector<std::uint8_t>* pointer = heapData.get();
+            std::uint8_t payload[sizeof(pointer)];
+            std::memcpy(payload, &pointer, sizeof(pointer));
+
+            if (!writeRecord(level, payload, sizeof(payload), static_cast<std::uint8_t>(HEAP | (truncated ? TRUNCATED : 0))))
+                return false;
+
+            heapData.release(); // owned by the record until it is read
+            return true;
+        }
+
+        bool read(Log::Level& level, std::vector<std::uint8_t>& payload, bool& truncated)
+        {
+            const std::uint64_t position = readPosition.load(std::memory_order_relaxed);
+            if (position == writePosition.load(std::memory_order_acquire)) return false;
+
+            std::uint8_t header[HEADER_SIZE];
+            copyOut(position, header, HEADER_SIZE);
+
+            std::uint32_t size;
+            std::memcpy(&size, header, sizeof(size));
+            level = static_cast<Log::Level>(header[sizeof(size)]);
+            const std::uint8_t flags = header[sizeof(size) + 1];
+            truncated = (flags & TRUNCATED) != 0;
+
+            if (flags & HEAP)
+            {
+                std::vector<std::uint8_t>* pointer;
+                std::uint8_t pointerData[sizeof(pointer)];
+                copyOut(position + HEADER_SIZE, pointerData, sizeof(pointerData));
+                std::memcpy(&pointer, pointerData, sizeof(pointer));
+
+                std::unique_ptr<std::vector<std::uint8_t>> heapData(pointer);
+                payload.swap(*heapData);
+            }
+            else
+            {
+                payload.resize(size);
+                copyOut(position + HEADER_SIZE, payload.data(), size);
+            }
+
+            readPosition.store(position + HEADER_SIZE + size, std::memory_order_release);
+            return true;
+        }
+
+        // rate limiting state, used only by the producer
+        float tokens = 0.0F;
+        std::uint32_t tokenLimit = 0; // the rate limit the bucket was filled for
+        std::chrono::steady_clock::time_point lastRefillTime = std::chrono::steady_clock::now();
+
+    private:
+        bool writeRecord(Log::Level level, const std::uint8_t* payload, std::size_t payloadSize, std::uint8_t flags)
+        {
+            const std::uint64_t position = writePosition.load(std::memory_order_relaxed);
+            const std::uint64_t available = CAPACITY - (position - readPosition.load(std::memory_order_acquire));
+
+            if (HEADER_SIZE + payloadSize > available) return false;
+
+            std::uint8_t header[HEADER_SIZE];
+            const auto size = static_cast<std::uint32_t>(payloadSize);
+            std::memcpy(header, &size, sizeof(size));
+            header[sizeof(size)] = static_cast<std::uint8_t>(level);
+            header[sizeof(size) + 1] = flags;
+
+            copyIn(position, header, HEADER_SIZE);
+            copyIn(position + HEADER_SIZE, payload, payloadSize);
+
+            writePosition.store(position + HEADER_SIZE + payloadSize, std::memory_order_release);
+            return true;
+        }
+
+        void copyIn(std::uint64_t position, const std::uint8_t* source, std::size_t size)
+        {
+            const std::size_t offset = static_cast<std::size_t>(position & (CAPACITY - 1));
+            const std::size_t first = std::min(size, CAPACITY - offset);
+            std::memcpy(data.data() + offset, source, first);
+            std::memcpy(data.data(), source + first, size - first);
+        }
+
+        void copyOut(std::uint64_t position, std::uint8_t* destination, std::size_t size) const
+        {
+            const std::size_t offset = static_cast<std::size_t>(position & (CAPACITY - 1));
+            const std::size_t first = std::min(size, CAPACITY - offset);
+            std::memcpy(destination, data.data() + offset, first);
+            std::memcpy(destination + first, data.data(), size - first);
+        }
+
+        std::vector<std::uint8_t> data;
+        std::atomic<std::uint64_t> writePosition{0};
+        std::atomic<std::uint64_t> readPosition{0};
+    };
+
     Log::~Log()
     {
-        if (!s.empty())
-            logger.log(s, level);
+        if (!enabled) return;
+
+        if (heapData)
+            logger.push(level, std::move(heapData), truncated);
+        else if (size > 0)
+            logger.push(level, data.data(), size, truncated);
+    }
+
+    Logger::Logger(Log::Level initThreshold):
+        threshold(initThreshold),
+        id(++lastLoggerId)
+    {
+#if !defined(__EMSCRIPTEN__)
+        logThread = Thread(&Logger::logLoop, this);
+#endif
+    }
+
+    Logger::~Logger()
+    {
+#if !defined(__EMSCRIPTEN__)
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            quit = true;
+        }
+        wakeCondition.notify_all();
+
+        if (logThread.isJoinable()) logThread.join();
+#endif
+    }
+
+    Logger::Buffer& Logger::getBuffer() const
+    {
+        thread_local std::vector<std::pair<std::uint64_t, std::shared_ptr<Buffer>>> threadBuffers;
+
+        for (const auto& threadBuffer : threadBuffers)
+            if (threadBuffer.first == id)
+                return *threadBuffer.second;
+
+        auto buffer = std::make_shared<Buffer>();
+
+        std::unique_lock<std::mutex> lock(buffersMutex);
+        buffers.push_back(buffer);
+        lock.unlock();
+
+        threadBuffers.emplace_back(id, buffer);
+        return *buffer;
     }
 
+    void Logger::push(Log::Level level, const std::uint8_t* data, std::size_t size, bool truncated) const
+    {
+#if defined(__EMSCRIPTEN__)
+        std::string str = format(data, size);
+        if (truncated) str += "...";
+        logString(str, level);
+#else
+        Buffer& buffer = getBuffer();
+
+        if (!takeToken(buffer))
+        {
+            ++rateLimitedCount;
+            return;
+        }
+
+        if (!buffer.write(level, data, size, truncated))
+        {
+            ++droppedCount;
+            return;
+        }
+
+        wakeLogThread();
+#endif
+    }
+
+    void Logger::push(Log::Level level, std::unique_ptr<std::vector<std::uint8_t>> heapData, bool truncated) const
+    {
+#if defined(__EMSCRIPTEN__)
+        std::string str = format(heapData->data(), heapData->size());
+        if (truncated) str += "...";
+        logString(str, level);
+#else
+        Buffer& buffer = getBuffer();
+
+        if (!takeToken(buffer))
+        {
+            ++rateLimitedCount;
+            return;
+        }
+
+        // the record holds only the pointer, so the message is not limited by the capacity of the buffer
+        if (!buffer.write(level, heapData, truncated))
+        {
+            ++droppedCount;
+            return;
+        }
+
+        wakeLogThread();
+#endif
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    bool Logger::takeToken(Buffer& buffer) const
+    {
+        const std::uint32_t limit = rateLimit;
+        if (!limit) return true;
+
+        // token bucket with the capacity of one second of messages
+        const auto now = std::chrono::steady_clock::now();
+
+        // the bucket starts full for a new thread or after the limit changed
+        if (buffer.tokenLimit != limit)
+        {
+            buffer.tokenLimit = limit;
+            buffer.tokens = static_cast<float>(limit);
+        }
+        else
+        {
+            const std::chrono::duration<float> elapsed = now - buffer.lastRefillTime;
+            buffer.tokens = std::min(buffer.tokens + elapsed.count() * static_cast<float>(limit), static_cast<float>(limit));
+        }
+
+        buffer.lastRefillTime = now;
+
+        if (buffer.tokens < 1.0F) return false;
+
+        buffer.tokens -= 1.0F;
+        return true;
+    }
+
+    void Logger::wakeLogThread() const
+    {
+        // notify only if the logger thread is not already woken up
+        if (!wakeUp.exchange(true))
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.notify_one();
+        }
+    }
+#endif
+
+    std::string Logger::format(const std::uint8_t* data, std::size_t size)
+    {
+        std::string result;
+        std::size_t offset = 0;
+
+        while (offset < size)
+        {
+            const auto argument = static_cast<Log::Argument>(data[offset++]);
+
+            switch (argument)
+            {
+                case Log::Argument::Boolean:
+                {
+                    std::uint8_t value;
+                    if (!decode(data, size, offset, value)) return result;
+                    result += value ? "true" : "false";
+                    break;
+                }
+                case Log::Argument::Byte:
+                {
+                    std::uint8_t value;
+                    if (!decode(data, size, offset, value)) return result;
+                    appendHex(result, value, 2);
+                    break;
+                }
+                case Log::Argument::SignedInteger:
+                {
+                    std::int64_t value;
+                    if (!decode(data, size, offset, value)) return result;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Log::Argument::UnsignedInteger:
+                {
+                    std::uint64_t value;
+                    if (!decode(data, size, offset, value)) return result;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Log::Argument::Float:
+                {
+                    float value;
+                    if (!decode(data, size, offset, value)) return result;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Log::Argument::Double:
+                {
+                    double value;
+                    if (!decode(data, size, offset, value)) return result;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Log::Argument::String:
+                {
+                    std::uint32_t length;
+                    if (!decode(data, size, offset, length)) return result;
+                    if (length > size - offset) return result;
+                    result.append(reinterpret_cast<const char*>(data + offset), length);
+                    offset += length;
+                    break;
+                }
+                case Log::Argument::Pointer:
+                {
+                    std::uint64_t value;
+                    if (!decode(data, size, offset, value)) return result;
+                    appendHex(result, value, sizeof(std::uintptr_t) * 2);
+                    break;
+                }
+                default:
+                    return result;
+            }
+        }
+
+        return result;
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    void Logger::logLoop()
+    {
+        Thread::setCurrentThreadName("Log");
+
+        std::uint64_t reportedDropCount = 0;
+
+        for (;;)
+        {
+            bool quitting;
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.wait(lock, [this]() { return wakeUp || quit; });
+                wakeUp = false;
+                quitting = quit;
+            }
+
+            while (processBuffers());
+
+            const std::uint64_t dropCount = droppedCount + rateLimitedCount;
+            if (dropCount != reportedDropCount)
+            {
+                logString(std::to_string(dropCount - reportedDropCount) + " log messages dropped", Log::Level::Warning);
+                reportedDropCount = dropCount;
+            }
+
+            if (quitting) break;
+        }
+    }
+
+    bool Logger::processBuffers()
+    {
+        std::vector<std::shared_ptr<Buffer>> currentBuffers;
+        {
+            std::unique_lock<std::mutex> lock(buffersMutex);
+            currentBuffers = buffers;
+        }
+
+        bool processed = false;
+        Log::Level level;
+        std::vector<std::uint8_t> payload;
+        bool truncated;
+
+        for (const auto& buffer : currentBuffers)
+        {
+            while (buffer->read(level, payload, truncated))
+            {
+                std::string str = format(payload.data(), payload.size());
+                if (truncated) str += "...";
+                logString(str, level);
+                processed = true;
+            }
+        }
+
+        // release the buffers of the threads that have exited
+        std::unique_lock<std::mutex> lock(buffersMutex);
+        for (auto i = buffers.begin(); i != buffers.end();)
+        {
+            // one reference is held by currentBuffers
+            if (i->use_count() == 2 && !processed)
+                i = buffers.erase(i);
+            else
+                ++i;
+        }
+
+        return processed;
+    }
+#endif
+
     void Logger::logString(const std::string& str, Log::Level level)
     {
 #if defined(__ANDROID__)
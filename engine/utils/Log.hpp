@@ -3,13 +3,17 @@
 #ifndef OUZEL_UTILS_LOG_HPP
 #define OUZEL_UTILS_LOG_HPP
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstring>
 #include <initializer_list>
+#include <limits>
 #include <list>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <set>
 #include <string>
 #include <thread>
@@ -37,24 +41,45 @@ namespace ouzel
             All
         };
 
-        explicit Log(const Logger& initLogger, Level initLevel = Level::Info):
-            logger(initLogger), level(initLevel)
+        // the arguments are stored in binary form and formatted on the logger thread
+        enum class Argument: std::uint8_t
         {
-        }
+            Boolean,
+            Byte,
+            SignedInteger,
+            UnsignedInteger,
+            Float,
+            Double,
+            String,
+            Pointer
+        };
+
+        static constexpr std::size_t MAX_SIZE = 512; // size of the inline buffer, longer messages move to the heap
+
+        explicit Log(const Logger& initLogger, Level initLevel = Level::Info);
 
         Log(const Log& other):
             logger(other.logger),
             level(other.level),
-            s(other.s)
+            enabled(other.enabled),
+            truncated(other.truncated),
+            size(other.size),
+            heapData(other.heapData ? std::make_unique<std::vector<std::uint8_t>>(*other.heapData) : nullptr)
         {
+            std::copy(other.data.begin(), other.data.begin() + static_cast<std::ptrdiff_t>(size), data.begin());
         }
 
         Log(Log&& other) noexcept:
             logger(other.logger),
             level(other.level),
-            s(std::move(other.s))
+            enabled(other.enabled),
+            truncated(other.truncated),
+            size(other.size),
+            heapData(std::move(other.heapData))
         {
+            std::copy(other.data.begin(), other.data.begin() + static_cast<std::ptrdiff_t>(size), data.begin());
             other.level = Level::Info;
+            other.size = 0;
         }
 
         Log& operator=(const Log& other)
@@ -62,7 +87,11 @@ namespace ouzel
             if (&other == this) return *this;
 
             level = other.level;
-            s = other.s;
+            enabled = other.enabled;
+            truncated = other.truncated;
+            size = other.size;
+            std::copy(other.data.begin(), other.data.begin() + static_cast<std::ptrdiff_t>(size), data.begin());
+            heapData = other.heapData ? std::make_unique<std::vector<std::uint8_t>>(*other.heapData) : nullptr;
 
             return *this;
         }
@@ -72,8 +101,13 @@ namespace ouzel
             if (&other == this) return *this;
 
             level = other.level;
+            enabled = other.enabled;
+            truncated = other.truncated;
+            size = other.size;
+            std::copy(other.data.begin(), other.data.begin() + static_cast<std::ptrdiff_t>(size), data.begin());
+            heapData = std::move(other.heapData);
             other.level = Level::Info;
-            s = std::move(other.s);
+            other.size = 0;
 
             return *this;
         }
@@ -83,18 +117,14 @@ namespace ouzel
         template <typename T, typename std::enable_if<std::is_same<T, bool>::value>::type* = nullptr>
         Log& operator<<(const T val)
         {
-            s += val ? "true" : "false";
+            encodeArgument(Argument::Boolean, static_cast<std::uint8_t>(val ? 1 : 0));
             return *this;
         }
 
         template <typename T, typename std::enable_if<std::is_same<T, std::uint8_t>::value>::type* = nullptr>
         Log& operator<<(const T val)
         {
-            constexpr char digits[] = "0123456789abcdef";
-
-            for (std::uint32_t p = 0; p < 2; ++p)
-                s.push_back(digits[(val >> (4 - p * 4)) & 0x0F]);
-
+            encodeArgument(Argument::Byte, val);
             return *this;
         }
 
@@ -103,35 +133,31 @@ namespace ouzel
             !std::is_same<T, std::uint8_t>::value>::type* = nullptr>
         Log& operator<<(const T val)
         {
-            s += std::to_string(val);
+            encodeNumber(val);
             return *this;
         }
 
         template <typename T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
         Log& operator<<(const T& val)
         {
-            s += val;
+            encodeString(val.data(), val.size());
             return *this;
         }
 
         template <typename T, typename std::enable_if<std::is_same<T, char>::value>::type* = nullptr>
         Log& operator<<(const T* val)
         {
-            s += val;
+            encodeString(val, std::strlen(val));
             return *this;
         }
 
         template <typename T, typename std::enable_if<!std::is_same<T, char>::value>::type* = nullptr>
         Log& operator<<(const T* val)
         {
-            constexpr char digits[] = "0123456789abcdef";
-
             std::uintptr_t ptrValue;
             memcpy(&ptrValue, &val, sizeof(ptrValue));
 
-            for (std::size_t i = 0; i < sizeof(val) * 2; ++i)
-                s.push_back(digits[(ptrValue >> (sizeof(ptrValue) * 2 - i - 1) * 4) & 0x0F]);
-
+            encodeArgument(Argument::Pointer, static_cast<std::uint64_t>(ptrValue));
             return *this;
         }
 
@@ -149,7 +175,7 @@ namespace ouzel
 
             for (const auto& i : val)
             {
-                if (!first) s += ", ";
+                if (!first) encodeString(", ", 2);
                 first = false;
 
                 operator<<(i);
@@ -165,9 +191,9 @@ namespace ouzel
 
             for (const T c : val.m)
             {
-                if (!first) s += ",";
+                if (!first) encodeString(",", 1);
                 first = false;
-                s += std::to_string(c);
+                encodeNumber(c);
             }
 
             return *this;
@@ -176,8 +202,11 @@ namespace ouzel
         template <typename T>
         Log& operator<<(const Quaternion<T>& val)
         {
-            s += std::to_string(val.v[0]) + "," + std::to_string(val.v[1]) + "," +
-                std::to_string(val.v[2]) + "," + std::to_string(val.v[3]);
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                if (i != 0) encodeString(",", 1);
+                encodeNumber(val.v[i]);
+            }
             return *this;
         }
 
@@ -188,9 +217,9 @@ namespace ouzel
 
             for (const T c : val.v)
             {
-                if (!first) s += ",";
+                if (!first) encodeString(",", 1);
                 first = false;
-                s += std::to_string(c);
+                encodeNumber(c);
             }
             return *this;
         }
@@ -202,44 +231,111 @@ namespace ouzel
 
             for (const T c : val.v)
             {
-                if (!first) s += ",";
+                if (!first) encodeString(",", 1);
                 first = false;
-                s += std::to_string(c);
+                encodeNumber(c);
             }
             return *this;
         }
 
     private:
+        void encode(const void* value, std::size_t valueSize) noexcept
+        {
+            const auto bytes = static_cast<const std::uint8_t*>(value);
+
+            try
+            {
+                if (heapData)
+                    heapData->insert(heapData->end(), bytes, bytes + valueSize);
+                else if (valueSize > MAX_SIZE - size)
+                {
+                    // the slow path for the messages that don't fit in the inline buffer
+                    heapData = std::make_unique<std::vector<std::uint8_t>>();
+                    heapData->reserve((size + valueSize) * 2);
+                    heapData->insert(heapData->end(), data.begin(), data.begin() + static_cast<std::ptrdiff_t>(size));
+                    heapData->insert(heapData->end(), bytes, bytes + valueSize);
+                }
+                else
+                {
+                    std::memcpy(data.data() + size, value, valueSize);
+                    size += valueSize;
+                }
+            }
+            catch (const std::bad_alloc&)
+            {
+                truncated = true;
+            }
+        }
+
+        template <typename T>
+        void encodeArgument(Argument argument, const T value) noexcept
+        {
+            if (!enabled || truncated) return;
+
+            std::uint8_t buffer[sizeof(argument) + sizeof(value)];
+            std::memcpy(buffer, &argument, sizeof(argument));
+            std::memcpy(buffer + sizeof(argument), &value, sizeof(value));
+            encode(buffer, sizeof(buffer));
+        }
+
+        void encodeString(const char* str, std::size_t length) noexcept
+        {
+            if (!enabled || truncated) return;
+
+            const Argument argument = Argument::String;
+            const auto encodedLength = static_cast<std::uint32_t>(std::min<std::size_t>(length, std::numeric_limits<std::uint32_t>::max()));
+
+            std::uint8_t header[sizeof(argument) + sizeof(encodedLength)];
+            std::memcpy(header, &argument, sizeof(argument));
+            std::memcpy(header + sizeof(argument), &encodedLength, sizeof(encodedLength));
+            encode(header, sizeof(header));
+            if (!truncated) encode(str, encodedLength);
+        }
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type* = nullptr>
+        void encodeNumber(const T val) noexcept
+        {
+            encodeArgument(Argument::SignedInteger, static_cast<std::int64_t>(val));
+        }
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type* = nullptr>
+        void encodeNumber(const T val) noexcept
+        {
+            encodeArgument(Argument::UnsignedInteger, static_cast<std::uint64_t>(val));
+        }
+
+        template <typename T, typename std::enable_if<std::is_same<T, float>::value>::type* = nullptr>
+        void encodeNumber(const T val) noexcept
+        {
+            encodeArgument(Argument::Float, val);
+        }
+
+        template <typename T, typename std::enable_if<std::is_floating_point<T>::value && !std::is_same<T, float>::value>::type* = nullptr>
+        void encodeNumber(const T val) noexcept
+        {
+            encodeArgument(Argument::Double, static_cast<double>(val));
+        }
+
         const Logger& logger;
         Level level = Level::Info;
-        std::string s;
+        bool enabled = true;
+        bool truncated = false; // set only if the heap allocation failed
+        std::size_t size = 0;
+        std::array<std::uint8_t, MAX_SIZE> data;
+        std::unique_ptr<std::vector<std::uint8_t>> heapData; // all the arguments once they outgrew the inline buffer
     };
 
     class Logger final
     {
     public:
-        explicit Logger(Log::Level initThreshold = Log::Level::All):
-            threshold(initThreshold)
-        {
-#if !defined(__EMSCRIPTEN__)
-            logThread = Thread(&Logger::logLoop, this);
-#endif
-        }
+        explicit Logger(Log::Level initThreshold = Log::Level::All);
 
         Logger(const Logger&) = delete;
         Logger& operator=(const Logger&) = delete;
         Logger(Logger&&) = delete;
         Logger& operator=(Logger&&) = delete;
 
-        ~Logger()
-        {
-#if !defined(__EMSCRIPTEN__)
-            std::unique_lock<std::mutex> lock(queueMutex);
-            commandQueue.push(Command(Command::Type::Quit));
-            lock.unlock();
-            queueCondition.notify_all();
-#endif
-        }
+        ~Logger();
 
         Log log(const Log::Level level = Log::Level::Info) const
         {
@@ -248,20 +344,31 @@ namespace ouzel
 
         void log(const std::string& str, const Log::Level level = Log::Level::Info) const
         {
-            if (level <= threshold)
-            {
-#if defined(__EMSCRIPTEN__)
-                logString(str, level);
-#else
-                std::unique_lock<std::mutex> lock(queueMutex);
-                commandQueue.push(Command(Command::Type::LogString, level, str));
-                lock.unlock();
-                queueCondition.notify_all();
-#endif
-            }
+            Log(*this, level) << str;
         }
 
+        inline auto getThreshold() const noexcept { return threshold.load(); }
+        inline void setThreshold(Log::Level newThreshold) noexcept { threshold = newThreshold; }
+
+        // maximum number of messages per second from a single thread, zero for no limit
+        inline auto getRateLimit() const noexcept { return rateLimit.load(); }
+        inline void setRateLimit(std::uint32_t newRateLimit) noexcept { rateLimit = newRateLimit; }
+
+        // number of messages dropped because the thread's buffer was full
+        inline std::uint64_t getDroppedCount() const noexcept { return droppedCount; }
+        // number of messages dropped because of the rate limit
+        inline std::uint64_t getRateLimitedCount() const noexcept { return rateLimitedCount; }
+
     private:
+        friend Log;
+
+        class Buffer;
+
+        void push(Log::Level level, const std::uint8_t* data, std::size_t size, bool truncated) const;
+        void push(Log::Level level, std::unique_ptr<std::vector<std::uint8_t>> heapData, bool truncated) const;
+        Buffer& getBuffer() const;
+
+        static std::string format(const std::uint8_t* data, std::size_t size);
         static void logString(const std::string& str, const Log::Level level = Log::Level::Info);
 
 #ifdef DEBUG
@@ -269,58 +376,33 @@ namespace ouzel
 #else
         std::atomic<Log::Level> threshold{Log::Level::Info};
 #endif
+        std::atomic<std::uint32_t> rateLimit{0};
+        mutable std::atomic<std::uint64_t> droppedCount{0};
+        mutable std::atomic<std::uint64_t> rateLimitedCount{0};
+        const std::uint64_t id; // identifies the logger in thread local storage
 
-#if !defined(__EMSCRIPTEN__)
-        class Command
-        {
-        public:
-            enum class Type
-            {
-                LogString,
-                Quit
-            };
-
-            explicit Command(const Type initType):
-                type(initType)
-            {
-            }
+        mutable std::mutex buffersMutex;
+        mutable std::vector<std::shared_ptr<Buffer>> buffers;
 
-            Command(const Type initType, const Log::Level initLevel,
-                    const std::string& initString):
-                type(initType),
-                level(initLevel),
-                str(initString)
-            {
-            }
-
-            Type type;
-            Log::Level level;
-            std::string str;
-        };
-
-        void logLoop()
-        {
-            for (;;)
-            {
-                std::unique_lock<std::mutex> lock(queueMutex);
-                while (commandQueue.empty()) queueCondition.wait(lock);
-                auto command = std::move(commandQueue.front());
-                commandQueue.pop();
-                lock.unlock();
-
-                if (command.type == Command::Type::LogString)
-                    logString(command.str, command.level);
-                else if (command.type == Command::Type::Quit)
-                    break;
-            }
-        }
-
-        mutable std::condition_variable queueCondition;
-        mutable std::mutex queueMutex;
-        mutable std::queue<Command> commandQueue;
+#if !defined(__EMSCRIPTEN__)
+        bool takeToken(Buffer& buffer) const;
+        void wakeLogThread() const;
+        void logLoop();
+        bool processBuffers();
+
+        mutable std::condition_variable wakeCondition;
+        mutable std::mutex wakeMutex;
+        mutable std::atomic_bool wakeUp{false};
+        bool quit = false;
         Thread logThread;
 #endif
     };
+
+    inline Log::Log(const Logger& initLogger, Level initLevel):
+        logger(initLogger), level(initLevel),
+        enabled(initLevel != Level::Off && initLevel <= initLogger.getThreshold())
+    {
+    }
 }
 
 #endif // OUZEL_UTILS_LOG_HPP
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "Utils.hpp"
@@ -1069,6 +1070,648 @@ namespace ouzel
             Array arrayValue;
             Dictionary dictionaryValue;
         };
+
+        // Read-only view of an encoded value that points into the source buffer
+        // The whole structure is validated once on construction, after that all
+        // accessors read the data in place without copying
+        class View final
+        {
+        public:
+            using Type = Value::Type;
+            using Marker = Value::Marker;
+
+            class Iterator final
+            {
+            public:
+                Iterator(const std::uint8_t* initPosition, Marker initContainer) noexcept:
+                    position(initPosition), container(initContainer)
+                {
+                }
+
+                inline View operator*() const noexcept
+                {
+                    return View(position + getKeySize(), nullptr);
+                }
+
+                inline Iterator& operator++() noexcept
+                {
+                    const std::uint32_t keySize = getKeySize();
+                    position += keySize + skip(position + keySize);
+                    return *this;
+                }
+
+                inline bool operator==(const Iterator& other) const noexcept
+                {
+                    return position == other.position;
+                }
+
+                inline bool operator!=(const Iterator& other) const noexcept
+                {
+                    return position != other.position;
+                }
+
+                // key of the current element of an object
+                inline std::uint32_t getKey() const noexcept
+                {
+                    assert(container == Marker::Object);
+                    return decodeBigEndian<std::uint32_t>(position);
+                }
+
+                // key of the current element of a dictionary
+                inline std::string getName() const
+                {
+                    assert(container == Marker::Dictionary);
+                    const std::uint16_t length = decodeBigEndian<std::uint16_t>(position);
+                    return std::string(reinterpret_cast<const char*>(position + sizeof(length)), length);
+                }
+
+            private:
+                inline std::uint32_t getKeySize() const noexcept
+                {
+                    switch (container)
+                    {
+                        case Marker::Object:
+                            return sizeof(std::uint32_t);
+                        case Marker::Dictionary:
+                            return sizeof(std::uint16_t) + decodeBigEndian<std::uint16_t>(position);
+                        default:
+                            return 0;
+                    }
+                }
+
+                const std::uint8_t* position;
+                Marker container;
+            };
+
+            View() noexcept = default;
+
+            View(const std::uint8_t* buffer, std::size_t size):
+                data(buffer)
+            {
+                validate(buffer, size, 0);
+            }
+
+            explicit View(const std::vector<std::uint8_t>& buffer, std::size_t offset = 0)
+            {
+                if (offset > buffer.size())
+                    throw std::runtime_error("Not enough data");
+
+                data = buffer.data() + offset;
+                validate(data, buffer.size() - offset, 0);
+            }
+
+            inline auto isValid() const noexcept { return data != nullptr; }
+
+            inline Type getType() const noexcept
+            {
+                assert(data);
+
+                switch (getMarker())
+                {
+                    case Marker::Int8:
+                    case Marker::Int16:
+                    case Marker::Int32:
+                    case Marker::Int64:
+                        return Type::Int;
+                    case Marker::Float:
+                        return Type::Float;
+                    case Marker::Double:
+                        return Type::Double;
+                    case Marker::String:
+                    case Marker::LongString:
+                        return Type::String;
+                    case Marker::ByteArray:
+                        return Type::ByteArray;
+                    case Marker::Array:
+                        return Type::Array;
+                    case Marker::Dictionary:
+                        return Type::Dictionary;
+                    case Marker::Object:
+                    default:
+                        return Type::Object;
+                }
+            }
+
+            inline auto isIntType() const noexcept { return getType() == Type::Int; }
+            inline auto isFloatType() const noexcept { return getType() == Type::Float || getType() == Type::Double; }
+            inline auto isStringType() const noexcept { return getType() == Type::String; }
+
+            // number of bytes the value occupies in the buffer
+            inline std::uint32_t getEncodedSize() const noexcept
+            {
+                assert(data);
+                return skip(data);
+            }
+
+            template <typename T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+            T as() const noexcept
+            {
+                assert(getType() == Type::Int);
+
+                switch (getMarker())
+                {
+                    case Marker::Int8: return static_cast<T>(data[1]);
+                    case Marker::Int16: return static_cast<T>(decodeBigEndian<std::uint16_t>(data + 1));
+                    case Marker::Int32: return static_cast<T>(decodeBigEndian<std::uint32_t>(data + 1));
+                    case Marker::Int64: return static_cast<T>(decodeBigEndian<std::uint64_t>(data + 1));
+                    default: return T(0);
+                }
+            }
+
+            template <typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+            T as() const noexcept
+            {
+                assert(getType() == Type::Float || getType() == Type::Double);
+
+                if (getMarker() == Marker::Float)
+                {
+                    float result;
+                    memcpy(&result, data + 1, sizeof(result));
+                    return static_cast<T>(result);
+                }
+                else
+                {
+                    double result;
+                    memcpy(&result, data + 1, sizeof(result));
+                    return static_cast<T>(result);
+                }
+            }
+
+            template <typename T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
+            std::string as() const
+            {
+                assert(getType() == Type::String);
+                return std::string(reinterpret_cast<const char*>(getData()), getLength());
+            }
+
+            template <typename T, typename std::enable_if<std::is_same<T, Value::ByteArray>::value>::type* = nullptr>
+            Value::ByteArray as() const
+            {
+                assert(getType() == Type::ByteArray);
+                return Value::ByteArray(getData(), getData() + getLength());
+            }
+
+            // pointer to the contents of a string or a byte array in the source buffer
+            inline const std::uint8_t* getData() const noexcept
+            {
+                return data + 1 + (getMarker() == Marker::String ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+            }
+
+            // length of a string or a byte array
+            inline std::uint32_t getLength() const noexcept
+            {
+                assert(getType() == Type::String || getType() == Type::ByteArray);
+
+                return (getMarker() == Marker::String) ?
+                    decodeBigEndian<std::uint16_t>(data + 1) :
+                    decodeBigEndian<std::uint32_t>(data + 1);
+            }
+
+            // number of elements in an object, array or dictionary
+            inline std::uint32_t getSize() const noexcept
+            {
+                assert(getType() == Type::Object || getType() == Type::Array || getType() == Type::Dictionary);
+                return decodeBigEndian<std::uint32_t>(data + 1);
+            }
+
+            inline Iterator begin() const noexcept
+            {
+                assert(getType() == Type::Object || getType() == Type::Array || getType() == Type::Dictionary);
+                return Iterator(data + 1 + sizeof(std::uint32_t), getMarker());
+            }
+
+            inline Iterator end() const noexcept
+            {
+                assert(getType() == Type::Object || getType() == Type::Array || getType() == Type::Dictionary);
+                return Iterator(data + skip(data), getMarker());
+            }
+
+            View operator[](std::uint32_t key) const noexcept
+            {
+                assert(getType() == Type::Object || getType() == Type::Array);
+
+                if (getMarker() == Marker::Object)
+                {
+                    // count the elements instead of comparing against end(), which has to skip the whole container
+                    auto i = begin();
+                    for (std::uint32_t n = getSize(); n > 0; --n, ++i)
+                        if (i.getKey() == key)
+                            return *i;
+                }
+                else if (getMarker() == Marker::Array && key < getSize())
+                {
+                    auto i = begin();
+                    for (std::uint32_t n = 0; n < key; ++n) ++i;
+                    return *i;
+                }
+
+                return View();
+            }
+
+            View operator[](const std::string& key) const noexcept
+            {
+                assert(getType() == Type::Dictionary);
+
+                const std::uint8_t* position = data + 1 + sizeof(std::uint32_t);
+                const std::uint32_t count = getSize();
+
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    const std::uint16_t length = decodeBigEndian<std::uint16_t>(position);
+                    position += sizeof(length);
+
+                    const bool match = length == key.length() &&
+                        std::memcmp(position, key.data(), length) == 0;
+                    position += length;
+
+                    if (match) return View(position, nullptr);
+
+                    position += skip(position);
+                }
+
+                return View();
+            }
+
+            inline bool hasElement(std::uint32_t key) const noexcept
+            {
+                return (*this)[key].isValid();
+            }
+
+            inline bool hasElement(const std::string& key) const noexcept
+            {
+                return (*this)[key].isValid();
+            }
+
+            // creates a fully decoded copy of the value
+            Value decode() const
+            {
+                switch (getType())
+                {
+                    case Type::Int: return Value(as<std::uint64_t>());
+                    case Type::Float: return Value(as<float>());
+                    case Type::Double: return Value(as<double>());
+                    case Type::String: return Value(as<std::string>());
+                    case Type::ByteArray: return Value(as<Value::ByteArray>());
+                    case Type::Object:
+                    {
+                        Value result(Type::Object);
+                        auto i = begin();
+                        for (std::uint32_t n = getSize(); n > 0; --n, ++i)
+                            result[i.getKey()] = (*i).decode();
+                        return result;
+                    }
+                    case Type::Array:
+                    {
+                        Value result(Type::Array);
+                        auto i = begin();
+                        for (std::uint32_t n = getSize(); n > 0; --n, ++i)
+                            result.append((*i).decode());
+                        return result;
+                    }
+                    case Type::Dictionary:
+                    {
+                        Value result(Type::Dictionary);
+                        auto i = begin();
+                        for (std::uint32_t n = getSize(); n > 0; --n, ++i)
+                            result[i.getName()] = (*i).decode();
+                        return result;
+                    }
+                    default:
+                        throw std::runtime_error("Unsupported type");
+                }
+            }
+
+        private:
+            static constexpr std::uint32_t MAX_DEPTH = 256;
+
+            // constructs a view of already validated data
+            View(const std::uint8_t* validatedData, std::nullptr_t) noexcept:
+                data(validatedData)
+            {
+            }
+
+            inline Marker getMarker() const noexcept
+            {
+                return static_cast<Marker>(data[0]);
+            }
+
+            static std::uint32_t readLength(const std::uint8_t* buffer, std::size_t size,
+                                            std::size_t lengthSize)
+            {
+                if (size < lengthSize)
+                    throw std::runtime_error("Not enough data");
+
+                return (lengthSize == sizeof(std::uint16_t)) ?
+                    decodeBigEndian<std::uint16_t>(buffer) :
+                    decodeBigEndian<std::uint32_t>(buffer);
+            }
+
+            // checks the structure of the value and returns its encoded size
+            static std::size_t validate(const std::uint8_t* buffer, std::size_t size, std::uint32_t depth)
+            {
+                if (depth > MAX_DEPTH)
+                    throw std::runtime_error("Maximum nesting depth exceeded");
+
+                if (size < 1)
+                    throw std::runtime_error("Not enough data");
+
+                std::size_t offset = 1;
+
+                auto requireData = [size, &offset](std::size_t length) {
+                    if (size - offset < length)
+                        throw std::runtime_error("Not enough data");
+                    offset += length;
+                };
+
+                switch (static_cast<Marker>(buffer[0]))
+                {
+                    case Marker::Int8: requireData(sizeof(std::uint8_t)); break;
+                    case Marker::Int16: requireData(sizeof(std::uint16_t)); break;
+                    case Marker::Int32: requireData(sizeof(std::uint32_t)); break;
+                    case Marker::Int64: requireData(sizeof(std::uint64_t)); break;
+                    case Marker::Float: requireData(sizeof(float)); break;
+                    case Marker::Double: requireData(sizeof(double)); break;
+                    case Marker::String:
+                    {
+                        const std::uint32_t length = readLength(buffer + offset, size - offset, sizeof(std::uint16_t));
+                        offset += sizeof(std::uint16_t);
+                        requireData(length);
+                        break;
+                    }
+                    case Marker::LongString:
+                    case Marker::ByteArray:
+                    {
+                        const std::uint32_t length = readLength(buffer + offset, size - offset, sizeof(std::uint32_t));
+                        offset += sizeof(std::uint32_t);
+                        requireData(length);
+                        break;
+                    }
+                    case Marker::Object:
+                    case Marker::Array:
+                    case Marker::Dictionary:
+                    {
+                        const auto marker = static_cast<Marker>(buffer[0]);
+                        const std::uint32_t count = readLength(buffer + offset, size - offset, sizeof(std::uint32_t));
+                        offset += sizeof(std::uint32_t);
+
+                        for (std::uint32_t i = 0; i < count; ++i)
+                        {
+                            if (marker == Marker::Object)
+                                requireData(sizeof(std::uint32_t));
+                            else if (marker == Marker::Dictionary)
+                            {
+                                const std::uint32_t length = readLength(buffer + offset, size - offset, sizeof(std::uint16_t));
+                                offset += sizeof(std::uint16_t);
+                                requireData(length);
+                            }
+
+                            offset += validate(buffer + offset, size - offset, depth + 1);
+                        }
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("Unsupported marker");
+                }
+
+                if (offset > std::numeric_limits<std::uint32_t>::max())
+                    throw std::runtime_error("Value too large");
+
+                return offset;
+            }
+
+            // returns the encoded size of a validated value
+            static std::uint32_t skip(const std::uint8_t* buffer) noexcept
+            {
+                switch (static_cast<Marker>(buffer[0]))
+                {
+                    case Marker::Int8: return 1 + sizeof(std::uint8_t);
+                    case Marker::Int16: return 1 + sizeof(std::uint16_t);
+                    case Marker::Int32: return 1 + sizeof(std::uint32_t);
+                    case Marker::Int64: return 1 + sizeof(std::uint64_t);
+                    case Marker::Float: return 1 + sizeof(float);
+                    case Marker::Double: return 1 + sizeof(double);
+                    case Marker::String:
+                        return 1 + sizeof(std::uint16_t) + decodeBigEndian<std::uint16_t>(buffer + 1);
+                    case Marker::LongString:
+                    case Marker::ByteArray:
+                        return 1 + sizeof(std::uint32_t) + decodeBigEndian<std::uint32_t>(buffer + 1);
+                    case Marker::Object:
+                    case Marker::Array:
+                    case Marker::Dictionary:
+                    {
+                        const auto marker = static_cast<Marker>(buffer[0]);
+                        const std::uint32_t count = decodeBigEndian<std::uint32_t>(buffer + 1);
+                        std::uint32_t offset = 1 + sizeof(std::uint32_t);
+
+                        for (std::uint32_t i = 0; i < count; ++i)
+                        {
+                            if (marker == Marker::Object)
+                                offset += sizeof(std::uint32_t);
+                            else if (marker == Marker::Dictionary)
+                                offset += sizeof(std::uint16_t) + decodeBigEndian<std::uint16_t>(buffer + offset);
+
+                            offset += skip(buffer + offset);
+                        }
+
+                        return offset;
+                    }
+                    default:
+                        return 0;
+                }
+            }
+
+            const std::uint8_t* data = nullptr;
+        };
+
+        // Writes values directly into a caller provided buffer without building a tree of Values
+        // Element counts of objects, arrays and dictionaries are patched in when they are ended
+        class Encoder final
+        {
+        public:
+            using Marker = Value::Marker;
+
+            explicit Encoder(std::vector<std::uint8_t>& initBuffer):
+                buffer(initBuffer)
+            {
+            }
+
+            void writeInt(std::uint64_t value)
+            {
+                addElement();
+
+                std::uint8_t data[1 + sizeof(std::uint64_t)];
+
+                if (value > std::numeric_limits<std::uint32_t>::max())
+                {
+                    data[0] = static_cast<std::uint8_t>(Marker::Int64);
+                    encodeBigEndian<std::uint64_t>(data + 1, value);
+                    append(data, 1 + sizeof(std::uint64_t));
+                }
+                else if (value > std::numeric_limits<std::uint16_t>::max())
+                {
+                    data[0] = static_cast<std::uint8_t>(Marker::Int32);
+                    encodeBigEndian<std::uint32_t>(data + 1, static_cast<std::uint32_t>(value));
+                    append(data, 1 + sizeof(std::uint32_t));
+                }
+                else if (value > std::numeric_limits<std::uint8_t>::max())
+                {
+                    data[0] = static_cast<std::uint8_t>(Marker::Int16);
+                    encodeBigEndian<std::uint16_t>(data + 1, static_cast<std::uint16_t>(value));
+                    append(data, 1 + sizeof(std::uint16_t));
+                }
+                else
+                {
+                    data[0] = static_cast<std::uint8_t>(Marker::Int8);
+                    data[1] = static_cast<std::uint8_t>(value);
+                    append(data, 1 + sizeof(std::uint8_t));
+                }
+            }
+
+            void writeFloat(float value)
+            {
+                addElement();
+
+                std::uint8_t data[1 + sizeof(value)];
+                data[0] = static_cast<std::uint8_t>(Marker::Float);
+                memcpy(data + 1, &value, sizeof(value));
+                append(data, sizeof(data));
+            }
+
+            void writeDouble(double value)
+            {
+                addElement();
+
+                std::uint8_t data[1 + sizeof(value)];
+                data[0] = static_cast<std::uint8_t>(Marker::Double);
+                memcpy(data + 1, &value, sizeof(value));
+                append(data, sizeof(data));
+            }
+
+            void writeString(const char* value, std::size_t length)
+            {
+                if (length > std::numeric_limits<std::uint32_t>::max())
+                    throw std::runtime_error("String too long");
+
+                addElement();
+
+                if (length > std::numeric_limits<std::uint16_t>::max())
+                {
+                    std::uint8_t header[1 + sizeof(std::uint32_t)];
+                    header[0] = static_cast<std::uint8_t>(Marker::LongString);
+                    encodeBigEndian<std::uint32_t>(header + 1, static_cast<std::uint32_t>(length));
+                    append(header, sizeof(header));
+                }
+                else
+                {
+                    std::uint8_t header[1 + sizeof(std::uint16_t)];
+                    header[0] = static_cast<std::uint8_t>(Marker::String);
+                    encodeBigEndian<std::uint16_t>(header + 1, static_cast<std::uint16_t>(length));
+                    append(header, sizeof(header));
+                }
+
+                append(value, length);
+            }
+
+            inline void writeString(const std::string& value)
+            {
+                writeString(value.data(), value.length());
+            }
+
+            void writeByteArray(const void* value, std::size_t size)
+            {
+                if (size > std::numeric_limits<std::uint32_t>::max())
+                    throw std::runtime_error("Byte array too long");
+
+                addElement();
+
+                std::uint8_t header[1 + sizeof(std::uint32_t)];
+                header[0] = static_cast<std::uint8_t>(Marker::ByteArray);
+                encodeBigEndian<std::uint32_t>(header + 1, static_cast<std::uint32_t>(size));
+                append(header, sizeof(header));
+                append(value, size);
+            }
+
+            // writes the key of the next element of an object
+            void writeKey(std::uint32_t key)
+            {
+                if (containers.empty() || containers.back().marker != Marker::Object)
+                    throw std::runtime_error("Key written outside of an object");
+
+                std::uint8_t data[sizeof(key)];
+                encodeBigEndian<std::uint32_t>(data, key);
+                append(data, sizeof(data));
+            }
+
+            // writes the key of the next element of a dictionary
+            void writeKey(const std::string& key)
+            {
+                if (containers.empty() || containers.back().marker != Marker::Dictionary)
+                    throw std::runtime_error("Key written outside of a dictionary");
+
+                if (key.length() > std::numeric_limits<std::uint16_t>::max())
+                    throw std::runtime_error("Key too long");
+
+                std::uint8_t data[sizeof(std::uint16_t)];
+                encodeBigEndian<std::uint16_t>(data, static_cast<std::uint16_t>(key.length()));
+                append(data, sizeof(data));
+                append(key.data(), key.length());
+            }
+
+            inline void beginObject() { begin(Marker::Object); }
+            inline void endObject() { end(Marker::Object); }
+            inline void beginArray() { begin(Marker::Array); }
+            inline void endArray() { end(Marker::Array); }
+            inline void beginDictionary() { begin(Marker::Dictionary); }
+            inline void endDictionary() { end(Marker::Dictionary); }
+
+            inline void write(const Value& value)
+            {
+                addElement();
+                value.encode(buffer);
+            }
+
+        private:
+            struct Container final
+            {
+                Marker marker;
+                std::size_t countOffset;
+                std::uint32_t count;
+            };
+
+            inline void append(const void* data, std::size_t size)
+            {
+                const std::size_t offset = buffer.size();
+                buffer.resize(offset + size);
+                if (size) memcpy(buffer.data() + offset, data, size);
+            }
+
+            inline void addElement() noexcept
+            {
+                if (!containers.empty()) ++containers.back().count;
+            }
+
+            void begin(Marker marker)
+            {
+                addElement();
+
+                std::uint8_t header[1 + sizeof(std::uint32_t)] = {static_cast<std::uint8_t>(marker)};
+                append(header, sizeof(header));
+                containers.push_back(Container{marker, buffer.size() - sizeof(std::uint32_t), 0});
+            }
+
+            void end(Marker marker)
+            {
+                if (containers.empty() || containers.back().marker != marker)
+                    throw std::runtime_error("Mismatched container end");
+
+                encodeBigEndian<std::uint32_t>(buffer.data() + containers.back().countOffset,
+                                               containers.back().count);
+                containers.pop_back();
+            }
+
+            std::vector<std::uint8_t>& buffer;
+            std::vector<Container> containers;
+        };
     } // namespace obf
 } // namespace ouzel
 
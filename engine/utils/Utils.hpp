@@ -25,7 +25,7 @@ namespace ouzel
         T result = 0;
 
         for (std::uintptr_t i = 0; i < sizeof(T); ++i)
-            result |= static_cast<T>(buffer[sizeof(buffer) - i - 1] << (i * 8));
+            result |= static_cast<T>(static_cast<T>(buffer[sizeof(T) - i - 1]) << (i * 8));
 
         return result;
     }
@@ -36,7 +36,7 @@ namespace ouzel
         T result = 0;
 
         for (std::uintptr_t i = 0; i < sizeof(T); ++i)
-            result |= static_cast<T>(buffer[i] << (i * 8));
+            result |= static_cast<T>(static_cast<T>(buffer[i]) << (i * 8));
 
         return result;
     }
@@ -3,6 +3,9 @@
 #ifndef OUZEL_UTILS_XML_HPP
 #define OUZEL_UTILS_XML_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -20,6 +23,59 @@ namespace ouzel
             explicit ParseError(const char* str): std::logic_error(str) {}
         };
 
+        // Non-owning reference to a range of characters in the source data
+        class StringView final
+        {
+        public:
+            StringView() noexcept = default;
+            StringView(const char* initBegin, const char* initEnd) noexcept:
+                first(initBegin), last(initEnd)
+            {
+            }
+
+            inline auto begin() const noexcept { return first; }
+            inline auto end() const noexcept { return last; }
+            inline auto data() const noexcept { return first; }
+            inline auto size() const noexcept { return static_cast<std::size_t>(last - first); }
+            inline auto empty() const noexcept { return first == last; }
+
+            inline std::string str() const { return std::string(first, last); }
+
+            inline bool operator==(const StringView& other) const noexcept
+            {
+                return size() == other.size() && std::equal(first, last, other.first);
+            }
+
+            inline bool operator!=(const StringView& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            inline bool operator==(const std::string& other) const noexcept
+            {
+                return size() == other.size() && std::equal(first, last, other.begin());
+            }
+
+            inline bool operator!=(const std::string& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+            inline bool operator==(const char* other) const noexcept
+            {
+                return size() == std::strlen(other) && std::equal(first, last, other);
+            }
+
+            inline bool operator!=(const char* other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+        private:
+            const char* first = nullptr;
+            const char* last = nullptr;
+        };
+
         inline namespace detail
         {
             constexpr std::uint8_t UTF8_BOM[] = {0xEF, 0xBB, 0xBF};
@@ -53,106 +109,124 @@ namespace ouzel
                     (c >= 0x203F && c <= 0x2040);
             }
 
-            inline void skipWhitespaces(std::u32string::const_iterator& iterator,
-                                        std::u32string::const_iterator end)
+            // decodes one UTF-8 encoded code point and advances the iterator past it
+            inline char32_t decodeChar(const char*& iterator, const char* end)
             {
-                while (iterator != end)
-                    if (isWhitespace(*iterator))
-                        ++iterator;
-                    else
-                        break;
+                char32_t cp = static_cast<std::uint8_t>(*iterator++);
+
+                std::size_t length = 0;
+                if (cp <= 0x7F) return cp;
+                else if ((cp >> 5) == 0x6) { cp &= 0x1F; length = 1; }
+                else if ((cp >> 4) == 0xE) { cp &= 0x0F; length = 2; }
+                else if ((cp >> 3) == 0x1E) { cp &= 0x07; length = 3; }
+                else throw utf8::ParseError("Invalid UTF-8 string");
+
+                for (std::size_t i = 0; i < length; ++i)
+                {
+                    if (iterator == end)
+                        throw utf8::ParseError("Invalid UTF-8 string");
+                    cp = (cp << 6) | (static_cast<std::uint8_t>(*iterator++) & 0x3F);
+                }
+
+                return cp;
             }
 
-            inline std::string parseName(std::u32string::const_iterator& iterator,
-                                         std::u32string::const_iterator end)
+            inline void skipWhitespaces(const char*& iterator, const char* end) noexcept
             {
-                std::string result;
+                while (iterator != end && isWhitespace(static_cast<char32_t>(*iterator)))
+                    ++iterator;
+            }
 
+            inline StringView parseName(const char*& iterator, const char* end)
+            {
                 if (iterator == end)
                     throw ParseError("Unexpected end of data");
 
-                if (!isNameStartChar(*iterator))
+                const char* begin = iterator;
+
+                const char* next = iterator;
+                if (!isNameStartChar(decodeChar(next, end)))
                     throw ParseError("Invalid name start");
+                iterator = next;
 
                 for (;;)
                 {
                     if (iterator == end)
                         throw ParseError("Unexpected end of data");
 
-                    if (!isNameChar(*iterator))
-                        break;
-                    else
+                    if (static_cast<std::uint8_t>(*iterator) <= 0x7F)
                     {
-                        result += utf8::fromUtf32(*iterator);
+                        // fast path for ASCII characters
+                        if (!isNameChar(static_cast<char32_t>(*iterator))) break;
                         ++iterator;
                     }
+                    else
+                    {
+                        next = iterator;
+                        if (!isNameChar(decodeChar(next, end))) break;
+                        iterator = next;
+                    }
                 }
 
-                return result;
+                return StringView(begin, iterator);
             }
 
-            inline std::string parseEntity(std::u32string::const_iterator& iterator,
-                                           std::u32string::const_iterator end)
+            inline std::string parseEntity(const char*& iterator, const char* end)
             {
-                std::string result;
-
                 if (iterator == end)
                     throw ParseError("Unexpected end of data");
 
                 if (*iterator != '&')
                     throw ParseError("Expected an ampersand");
 
-                std::string value;
+                const char* begin = ++iterator;
 
                 for (;;)
                 {
-                    if (++iterator == end)
+                    if (iterator == end)
                         throw ParseError("Unexpected end of data");
 
-                    if (*iterator == ';')
-                    {
-                        ++iterator;
-                        break;
-                    }
-                    else
-                        value.push_back(static_cast<char>(*iterator));
+                    if (*iterator == ';') break;
+                    ++iterator;
                 }
 
+                const StringView value(begin, iterator++);
+
                 if (value.empty())
                     throw ParseError("Invalid entity");
 
                 if (value == "quot")
-                    result = "\"";
+                    return "\"";
                 else if (value == "amp")
-                    result = "&";
+                    return "&";
                 else if (value == "apos")
-                    result = "'";
+                    return "'";
                 else if (value == "lt")
-                    result = "<";
+                    return "<";
                 else if (value == "gt")
-                    result = ">";
-                else if (value[0] == '#')
+                    return ">";
+                else if (value.data()[0] == '#')
                 {
-                    if (value.length() < 2)
+                    if (value.size() < 2)
                         throw ParseError("Invalid entity");
 
                     char32_t c = 0;
 
-                    if (value[1] == 'x') // hex value
+                    if (value.data()[1] == 'x') // hex value
                     {
-                        if (value.length() != 2 + 4)
+                        if (value.size() < 3 || value.size() > 2 + 6)
                             throw ParseError("Invalid entity");
 
-                        for (std::size_t i = 0; i < 4; ++i)
+                        for (auto i = value.begin() + 2; i != value.end(); ++i)
                         {
                             std::uint8_t code = 0;
 
-                            if (value[i + 2] >= '0' && value[i + 2] <= '9')
-                                code = static_cast<std::uint8_t>(value[i + 2]) - '0';
-                            else if (value[i + 2] >= 'a' && value[i + 2] <='f')
-                                code = static_cast<std::uint8_t>(value[i + 2]) - 'a' + 10;
-                            else if (value[i + 2] >= 'A' && value[i + 2] <='F')
-                                code = static_cast<std::uint8_t>(value[i + 2]) - 'A' + 10;
+                            if (*i >= '0' && *i <= '9')
+                                code = static_cast<std::uint8_t>(*i) - '0';
+                            else if (*i >= 'a' && *i <='f')
+                                code = static_cast<std::uint8_t>(*i) - 'a' + 10;
+                            else if (*i >= 'A' && *i <='F')
+                                code = static_cast<std::uint8_t>(*i) - 'A' + 10;
                             else
                                 throw ParseError("Invalid character code");
 
@@ -161,74 +235,50 @@ namespace ouzel
                     }
                     else
                     {
-                        if (value.length() != 1 + 4)
+                        if (value.size() > 1 + 7)
                             throw ParseError("Invalid entity");
 
-                        for (std::size_t i = 0; i < 4; ++i)
+                        for (auto i = value.begin() + 1; i != value.end(); ++i)
                         {
-                            std::uint8_t code = 0;
-
-                            if (value[i + 1] >= '0' && value[i + 1] <= '9')
-                                code = static_cast<std::uint8_t>(value[i + 1]) - '0';
-                            else
+                            if (*i < '0' || *i > '9')
                                 throw ParseError("Invalid character code");
 
-                            c = c * 10 + code;
+                            c = c * 10 + static_cast<std::uint8_t>(*i - '0');
                         }
                     }
 
-                    result = utf8::fromUtf32(c);
+                    return utf8::fromUtf32(c);
                 }
                 else
                     throw ParseError("Invalid entity");
-
-                return result;
             }
 
-            inline std::string parseString(std::u32string::const_iterator& iterator,
-                                           std::u32string::const_iterator end)
+            // replaces entities in the raw text with the characters they represent
+            inline std::string decodeText(const StringView& text)
             {
                 std::string result;
+                result.reserve(text.size());
 
-                if (iterator == end)
-                    throw ParseError("Unexpected end of data");
+                const char* iterator = text.begin();
 
-                if (*iterator != '"' && *iterator != '\'')
-                    throw ParseError("Expected quotes");
-
-                auto quotes = *iterator;
-
-                ++iterator;
-
-                for (;;)
+                while (iterator != text.end())
                 {
-                    if (iterator == end)
-                        throw ParseError("Unexpected end of data");
+                    const auto entity = static_cast<const char*>(std::memchr(iterator, '&', static_cast<std::size_t>(text.end() - iterator)));
+                    const char* runEnd = entity ? entity : text.end();
 
-                    if (*iterator == quotes)
-                    {
-                        ++iterator;
-                        break;
-                    }
-                    else if (*iterator == '&')
-                    {
-                        std::string entity = parseEntity(iterator, end);
-                        result += entity;
-                    }
-                    else
-                    {
-                        result += utf8::fromUtf32(*iterator);
-                        ++iterator;
-                    }
+                    result.append(iterator, runEnd);
+                    iterator = runEnd;
+
+                    if (entity) result += parseEntity(iterator, text.end());
                 }
 
                 return result;
             }
 
             inline void encodeString(std::vector<std::uint8_t>& data,
-                                     const std::u32string& str)
+                                     const std::string& str)
             {
-                for (const char32_t c : str)
+                for (const char c : str)
                 {
                     switch (c)
                     {
@@ -248,310 +298,387 @@ namespace ouzel
                             data.insert(data.end(), {'&', 'g', 't', ';'});
                             break;
                         default:
-                            const std::string encoded = utf8::fromUtf32(c);
-                            data.insert(data.end(), encoded.begin(), encoded.end());
+                            // bytes of multi-byte UTF-8 sequences never match the escaped characters
+                            data.push_back(static_cast<std::uint8_t>(c));
                             break;
                     }
                 }
             }
         }
 
-        class Data;
-
-        class Node final
+        // Pull parser that reads UTF-8 data in place and reports one event at a time
+        // Names and values are views into the source data, which must outlive the reader
+        class Reader final
         {
-            friend Data;
         public:
-            enum class Type
+            enum class Event
             {
-                Comment,
+                End,
+                StartTag,
+                EndTag,
+                Text,
                 CData,
-                TypeDeclaration,
-                ProcessingInstruction,
-                Tag,
-                Text
+                Comment,
+                ProcessingInstruction
             };
 
-            Node() = default;
-            Node(Type initType): type(initType) {}
-            Node(const std::string& val): type(Type::Text), value(val) {}
+            class Attribute final
+            {
+            public:
+                Attribute(const StringView& initName, const StringView& initValue) noexcept:
+                    name(initName), rawValue(initValue)
+                {
+                }
 
-            inline Node& operator=(Type newType) noexcept
+                inline auto& getName() const noexcept { return name; }
+                inline auto& getRawValue() const noexcept { return rawValue; }
+                inline std::string getValue() const { return decodeText(rawValue); }
+
+            private:
+                StringView name;
+                StringView rawValue;
+            };
+
+            Reader(const std::uint8_t* dataBegin, const std::uint8_t* dataEnd,
+                   bool initPreserveWhitespaces = false):
+                iterator(reinterpret_cast<const char*>(dataBegin)),
+                end(reinterpret_cast<const char*>(dataEnd)),
+                preserveWhitespaces(initPreserveWhitespaces)
             {
-                type = newType;
-                return *this;
+                if (dataEnd - dataBegin >= 3 &&
+                    std::equal(dataBegin, dataBegin + 3, std::begin(UTF8_BOM)))
+                {
+                    bom = true;
+                    iterator += 3;
+                }
             }
 
-            inline Node& operator=(const std::string& val)
+            explicit Reader(const std::vector<std::uint8_t>& data,
+                            bool initPreserveWhitespaces = false):
+                Reader(data.data(), data.data() + data.size(), initPreserveWhitespaces)
             {
-                type = Type::Text;
-                value = val;
-                return *this;
             }
 
-            inline auto getType() const noexcept { return type; }
+            Event next()
+            {
+                attributes.clear();
+                value = StringView();
 
-            inline auto& getValue() const noexcept { return value; }
-            inline void setValue(const std::string& newValue) { value = newValue; }
+                if (selfClosing)
+                {
+                    selfClosing = false;
+                    name = tags.back();
+                    tags.pop_back();
+                    return event = Event::EndTag;
+                }
 
-            inline auto& getChildren() const noexcept { return children; }
+                if (!preserveWhitespaces) skipWhitespaces(iterator, end);
 
-            std::vector<Node>::iterator begin() { return children.begin(); }
-            std::vector<Node>::iterator end() { return children.end(); }
+                if (iterator == end)
+                {
+                    if (!tags.empty())
+                        throw ParseError("Unexpected end of data");
 
-            std::vector<Node>::const_iterator begin() const { return children.begin(); }
-            std::vector<Node>::const_iterator end() const { return children.end(); }
+                    name = StringView();
+                    return event = Event::End;
+                }
 
-        protected:
-            void parse(std::u32string::const_iterator& iterator,
-                       std::u32string::const_iterator end,
-                       bool preserveWhitespaces = false,
-                       bool preserveComments = false,
-                       bool preserveProcessingInstructions = false)
-            {
-                if (iterator == end)
+                if (*iterator != '<')
+                {
+                    const char* begin = iterator;
+                    const auto tag = static_cast<const char*>(std::memchr(iterator, '<', static_cast<std::size_t>(end - iterator)));
+                    iterator = tag ? tag : end;
+
+                    name = StringView();
+                    value = StringView(begin, iterator);
+                    return event = Event::Text;
+                }
+
+                if (++iterator == end)
                     throw ParseError("Unexpected end of data");
 
-                if (*iterator == '<')
+                if (*iterator == '!') // <!
                 {
                     if (++iterator == end)
                         throw ParseError("Unexpected end of data");
 
-                    if (*iterator == '!') // <!
+                    if (*iterator == '-') // <!-
                     {
-                        if (++iterator == end)
-                            throw ParseError("Unexpected end of data");
+                        if (++iterator == end || *iterator != '-') // <!--
+                            throw ParseError("Expected a comment");
+
+                        const char* begin = ++iterator;
 
-                        if (*iterator == '-') // <!-
+                        for (;;)
                         {
-                            if (++iterator == end)
+                            if (end - iterator < 3)
                                 throw ParseError("Unexpected end of data");
 
-                            if (*iterator != '-') // <!--
-                                throw ParseError("Expected a comment");
-
-                            for (;;)
+                            if (*iterator == '-' && *(iterator + 1) == '-') // --
                             {
-                                if (std::distance(++iterator, end) < 3)
-                                    throw ParseError("Unexpected end of data");
-
-                                if (*iterator == '-')
-                                {
-                                    if (*(iterator + 1) == '-') // --
-                                    {
-                                        iterator += 2;
-
-                                        if (*iterator == '>') // -->
-                                        {
-                                            ++iterator;
-                                            break;
-                                        }
-                                        else
-                                            throw ParseError("Unexpected double-hyphen inside comment");
-                                    }
-                                }
-
-                                value += utf8::fromUtf32(*iterator);
+                                if (*(iterator + 2) != '>') // -->
+                                    throw ParseError("Unexpected double-hyphen inside comment");
+
+                                value = StringView(begin, iterator);
+                                iterator += 3;
+                                break;
                             }
 
-                            type = Type::Comment;
-                        }
-                        else if (*iterator == '[') // <![
-                        {
                             ++iterator;
-                            std::string name;
-                            name = parseName(iterator, end);
+                        }
 
-                            if (name != "CDATA")
-                                throw ParseError("Expected CDATA");
+                        name = StringView();
+                        return event = Event::Comment;
+                    }
+                    else if (*iterator == '[') // <![
+                    {
+                        ++iterator;
 
-                            if (iterator == end)
-                                throw ParseError("Unexpected end of data");
+                        if (parseName(iterator, end) != "CDATA")
+                            throw ParseError("Expected CDATA");
 
-                            if (*iterator != '[')
-                                throw ParseError("Expected a left bracket");
+                        if (*iterator != '[')
+                            throw ParseError("Expected a left bracket");
 
-                            for (;;)
+                        const char* begin = ++iterator;
+
+                        for (;;)
+                        {
+                            if (end - iterator < 3)
+                                throw ParseError("Unexpected end of data");
+
+                            if (*iterator == ']' &&
+                                *(iterator + 1) == ']' &&
+                                *(iterator + 2) == '>')
                             {
-                                if (std::distance(++iterator, end) < 3)
-                                    throw ParseError("Unexpected end of data");
-
-                                if (*iterator == ']' &&
-                                    *(iterator + 1) == ']' &&
-                                    *(iterator + 2) == '>')
-                                {
-                                    iterator += 3;
-                                    break;
-                                }
-
-                                value += utf8::fromUtf32(*iterator);
+                                value = StringView(begin, iterator);
+                                iterator += 3;
+                                break;
                             }
 
-                            type = Type::CData;
+                            ++iterator;
                         }
-                        else
-                            throw ParseError("Type declarations are not supported");
+
+                        name = StringView();
+                        return event = Event::CData;
                     }
-                    else if (*iterator == '?') // <?
+                    else
+                        throw ParseError("Type declarations are not supported");
+                }
+                else if (*iterator == '?') // <?
+                {
+                    ++iterator;
+                    name = parseName(iterator, end);
+
+                    for (;;)
                     {
-                        ++iterator;
-                        value = parseName(iterator, end);
+                        skipWhitespaces(iterator, end);
 
-                        for (;;)
-                        {
-                            skipWhitespaces(iterator, end);
+                        if (iterator == end)
+                            throw ParseError("Unexpected end of data");
 
-                            if (iterator == end)
+                        if (*iterator == '?')
+                        {
+                            if (++iterator == end)
                                 throw ParseError("Unexpected end of data");
 
-                            if (*iterator == '?')
-                            {
-                                if (++iterator == end)
-                                    throw ParseError("Unexpected end of data");
+                            if (*iterator != '>') // ?>
+                                throw ParseError("Expected a right angle bracket");
+
+                            ++iterator;
+                            break;
+                        }
 
-                                if (*iterator != '>') // ?>
-                                    throw ParseError("Expected a right angle bracket");
+                        parseAttribute();
+                    }
 
-                                ++iterator;
-                                break;
-                            }
+                    return event = Event::ProcessingInstruction;
+                }
+                else if (*iterator == '/') // </
+                {
+                    ++iterator;
+                    name = parseName(iterator, end);
 
-                            std::string attribute = parseName(iterator, end);
+                    if (tags.empty() || tags.back() != name)
+                        throw ParseError("Tag not closed properly");
 
-                            skipWhitespaces(iterator, end);
+                    skipWhitespaces(iterator, end);
 
-                            if (iterator == end)
-                                throw ParseError("Unexpected end of data");
+                    if (iterator == end)
+                        throw ParseError("Unexpected end of data");
 
-                            if (*iterator != '=')
-                                throw ParseError("Expected an equal sign");
+                    if (*iterator != '>')
+                        throw ParseError("Expected a right angle bracket");
 
+                    ++iterator;
+                    tags.pop_back();
+
+                    return event = Event::EndTag;
+                }
+                else // <
+                {
+                    name = parseName(iterator, end);
+
+                    for (;;)
+                    {
+                        skipWhitespaces(iterator, end);
+
+                        if (iterator == end)
+                            throw ParseError("Unexpected end of data");
+
+                        if (*iterator == '>')
+                        {
                             ++iterator;
+                            break;
+                        }
+                        else if (*iterator == '/')
+                        {
+                            if (++iterator == end)
+                                throw ParseError("Unexpected end of data");
+
+                            if (*iterator != '>') // />
+                                throw ParseError("Expected a right angle bracket");
 
-                            skipWhitespaces(iterator, end);
-                            attributes[attribute] = parseString(iterator, end);
+                            selfClosing = true;
+                            ++iterator;
+                            break;
                         }
 
-                        type = Type::ProcessingInstruction;
+                        parseAttribute();
                     }
-                    else // <
-                    {
-                        value = parseName(iterator, end);
 
-                        bool tagClosed = false;
+                    tags.push_back(name);
 
-                        for (;;)
-                        {
-                            skipWhitespaces(iterator, end);
+                    return event = Event::StartTag;
+                }
+            }
 
-                            if (iterator == end)
-                                throw ParseError("Unexpected end of data");
+            inline auto getEvent() const noexcept { return event; }
 
-                            if (*iterator == '>')
-                            {
-                                ++iterator;
-                                break;
-                            }
-                            else if (*iterator == '/')
-                            {
-                                if (++iterator == end)
-                                    throw ParseError("Unexpected end of data");
+            // name of the tag or the processing instruction
+            inline auto& getName() const noexcept { return name; }
 
-                                if (*iterator != '>') // />
-                                    throw ParseError("Expected a right angle bracket");
+            // raw contents of the text, the CDATA section or the comment
+            inline auto& getValue() const noexcept { return value; }
 
-                                tagClosed = true;
-                                ++iterator;
-                                break;
-                            }
+            // contents of the text with entities replaced
+            inline std::string getText() const { return decodeText(value); }
 
-                            std::string attribute;
-                            attribute = parseName(iterator, end);
+            inline auto& getAttributes() const noexcept { return attributes; }
 
-                            skipWhitespaces(iterator, end);
+            const Attribute* findAttribute(const char* attributeName) const noexcept
+            {
+                for (const auto& attribute : attributes)
+                    if (attribute.getName() == attributeName)
+                        return &attribute;
 
-                            if (iterator == end)
-                                throw ParseError("Unexpected end of data");
+                return nullptr;
+            }
 
-                            if (*iterator != '=')
-                                throw ParseError("Expected an equal sign");
+            // number of currently open tags
+            inline auto getDepth() const noexcept { return tags.size(); }
 
-                            ++iterator;
+            inline auto hasBom() const noexcept { return bom; }
 
-                            skipWhitespaces(iterator, end);
+        private:
+            void parseAttribute()
+            {
+                const StringView attributeName = parseName(iterator, end);
 
-                            attributes[attribute] = parseString(iterator, end);
-                        }
+                skipWhitespaces(iterator, end);
 
-                        if (!tagClosed)
-                        {
-                            for (;;)
-                            {
-                                if (!preserveWhitespaces) skipWhitespaces(iterator, end);
+                if (iterator == end)
+                    throw ParseError("Unexpected end of data");
 
-                                if (iterator == end)
-                                    throw ParseError("Unexpected end of data");
+                if (*iterator != '=')
+                    throw ParseError("Expected an equal sign");
 
-                                if (*iterator == '<' &&
-                                    iterator + 1 != end &&
-                                    *(iterator + 1) == '/')
-                                {
-                                    ++iterator; // skip the left angle bracket
-                                    ++iterator; // skip the slash
+                ++iterator;
 
-                                    std::string tag = parseName(iterator, end);
+                skipWhitespaces(iterator, end);
 
-                                    if (tag != value)
-                                        throw ParseError("Tag not closed properly");
+                if (iterator == end)
+                    throw ParseError("Unexpected end of data");
 
-                                    if (iterator == end)
-                                        throw ParseError("Unexpected end of data");
+                if (*iterator != '"' && *iterator != '\'')
+                    throw ParseError("Expected quotes");
 
-                                    if (*iterator != '>')
-                                        throw ParseError("Expected a right angle bracket");
+                const char quotes = *iterator++;
+                const auto closingQuotes = static_cast<const char*>(std::memchr(iterator, quotes, static_cast<std::size_t>(end - iterator)));
 
-                                    ++iterator;
+                if (!closingQuotes)
+                    throw ParseError("Unexpected end of data");
 
-                                    break;
-                                }
-                                else
-                                {
-                                    Node node;
-                                    node.parse(iterator, end, preserveWhitespaces, preserveComments, preserveProcessingInstructions);
-
-                                    if ((preserveComments || node.getType() != Type::Comment) &&
-                                        (preserveProcessingInstructions || node.getType() != Type::ProcessingInstruction))
-                                        children.push_back(node);
-                                }
-                            }
-                        }
+                attributes.emplace_back(attributeName, StringView(iterator, closingQuotes));
+                iterator = closingQuotes + 1;
+            }
 
-                        type = Type::Tag;
-                    }
-                }
-                else
-                {
-                    for (;;)
-                    {
-                        if (iterator == end || // end of a file
-                            *iterator == '<') // start of a tag
-                            break;
-                        else if (*iterator == '&')
-                        {
-                            std::string entity = parseEntity(iterator, end);
-                            value += entity;
-                        }
-                        else
-                        {
-                            value += utf8::fromUtf32(*iterator);
-                            ++iterator;
-                        }
-                    }
+            const char* iterator;
+            const char* end;
+            bool preserveWhitespaces = false;
+            bool bom = false;
+            bool selfClosing = false;
 
-                    type = Type::Text;
-                }
+            Event event = Event::End;
+            StringView name;
+            StringView value;
+            std::vector<Attribute> attributes;
+            std::vector<StringView> tags;
+        };
+
+        class Data;
+
+        class Node final
+        {
+            friend Data;
+        public:
+            enum class Type
+            {
+                Comment,
+                CData,
+                TypeDeclaration,
+                ProcessingInstruction,
+                Tag,
+                Text
+            };
+
+            Node() = default;
+            Node(Type initType): type(initType) {}
+            Node(const std::string& val): type(Type::Text), value(val) {}
+
+            inline Node& operator=(Type newType) noexcept
+            {
+                type = newType;
+                return *this;
             }
 
+            inline Node& operator=(const std::string& val)
+            {
+                type = Type::Text;
+                value = val;
+                return *this;
+            }
+
+            inline auto getType() const noexcept { return type; }
+
+            inline auto& getValue() const noexcept { return value; }
+            inline void setValue(const std::string& newValue) { value = newValue; }
+
+            inline auto& getAttributes() const noexcept { return attributes; }
+            inline void setAttribute(const std::string& name, const std::string& attributeValue)
+            {
+                attributes[name] = attributeValue;
+            }
+
+            inline auto& getChildren() const noexcept { return children; }
+
+            std::vector<Node>::iterator begin() { return children.begin(); }
+            std::vector<Node>::iterator end() { return children.end(); }
+
+            std::vector<Node>::const_iterator begin() const { return children.begin(); }
+            std::vector<Node>::const_iterator end() const { return children.end(); }
+
+        protected:
             void encode(std::vector<std::uint8_t>& data) const
             {
                 switch (type)
@@ -571,38 +698,13 @@ namespace ouzel
                     case Node::Type::ProcessingInstruction:
                         data.insert(data.end(), {'<', '?'});
                         data.insert(data.end(), value.begin(), value.end());
-
-                        if (attributes.empty())
-                            data.insert(data.end(), ' ');
-                        else
-                        {
-                            for (const auto& attribute : attributes)
-                            {
-                                data.insert(data.end(), attribute.first.begin(), attribute.first.end());
-                                data.insert(data.end(), {'=', '"'});
-                                encodeString(data, utf8::toUtf32(attribute.second));
-                                data.insert(data.end(), '"');
-                            }
-                        }
-
+                        encodeAttributes(data);
                         data.insert(data.end(), {'?', '>'});
                         break;
                     case Node::Type::Tag:
                         data.insert(data.end(), '<');
                         data.insert(data.end(), value.begin(), value.end());
-
-                        if (attributes.empty())
-                            data.insert(data.end(), ' ');
-                        else
-                        {
-                            for (const auto& attribute : attributes)
-                            {
-                                data.insert(data.end(), attribute.first.begin(), attribute.first.end());
-                                data.insert(data.end(), {'=', '"'});
-                                data.insert(data.end(), attribute.second.begin(), attribute.second.end());
-                                data.insert(data.end(), '"');
-                            }
-                        }
+                        encodeAttributes(data);
 
                         if (children.empty())
                             data.insert(data.end(), {'/', '>'});
@@ -619,17 +721,26 @@ namespace ouzel
                         }
                         break;
                     case Node::Type::Text:
-                        encodeString(data, utf8::toUtf32(value));
+                        encodeString(data, value);
                         break;
                     default:
                         throw ParseError("Unknown node type");
                 }
-
-                for (const Node& node : children)
-                    node.encode(data);
             }
 
         private:
+            void encodeAttributes(std::vector<std::uint8_t>& data) const
+            {
+                for (const auto& attribute : attributes)
+                {
+                    data.insert(data.end(), ' ');
+                    data.insert(data.end(), attribute.first.begin(), attribute.first.end());
+                    data.insert(data.end(), {'=', '"'});
+                    encodeString(data, attribute.second);
+                    data.insert(data.end(), '"');
+                }
+            }
+
             Type type;
 
             std::string value;
@@ -647,50 +758,73 @@ namespace ouzel
                  bool preserveComments = false,
                  bool preserveProcessingInstructions = false)
             {
-                std::u32string str;
-
-                // BOM
-                if (data.size() >= 3 &&
-                    std::equal(data.begin(), data.begin() + 3,
-                               std::begin(UTF8_BOM), std::end(UTF8_BOM)))
-                {
-                    bom = true;
-                    str = utf8::toUtf32(data.begin() + 3, data.end());
-                }
-                else
-                {
-                    bom = false;
-                    str = utf8::toUtf32(data);
-                }
+                Reader reader(data, preserveWhitespaces);
+                bom = reader.hasBom();
 
                 bool rootTagFound = false;
 
-                auto iterator = str.cbegin();
+                // open tags, parents never get new children while a child is open,
+                // so the pointers stay valid
+                std::vector<Node*> tags;
 
                 for (;;)
                 {
-                    if (!preserveWhitespaces) skipWhitespaces(iterator, str.end());
+                    const auto event = reader.next();
 
-                    if (iterator == str.end()) break;
+                    if (event == Reader::Event::End) break;
 
-                    Node node;
-                    node.parse(iterator, str.end(),
-                               preserveWhitespaces,
-                               preserveComments,
-                               preserveProcessingInstructions);
+                    if (event == Reader::Event::EndTag)
+                    {
+                        tags.pop_back();
+                        continue;
+                    }
 
-                    if ((preserveComments || node.getType() != Node::Type::Comment) &&
-                        (preserveProcessingInstructions || node.getType() != Node::Type::ProcessingInstruction))
+                    if ((!preserveComments && event == Reader::Event::Comment) ||
+                        (!preserveProcessingInstructions && event == Reader::Event::ProcessingInstruction))
+                        continue;
+
+                    auto& siblings = tags.empty() ? children : tags.back()->children;
+                    siblings.emplace_back();
+                    Node& node = siblings.back();
+
+                    switch (event)
                     {
-                        children.push_back(node);
+                        case Reader::Event::StartTag:
+                            if (tags.empty())
+                            {
+                                if (rootTagFound)
+                                    throw ParseError("Multiple root tags found");
+                                else
+                                    rootTagFound = true;
+                            }
 
-                        if (node.getType() == Node::Type::Tag)
-                        {
-                            if (rootTagFound)
-                                throw ParseError("Multiple root tags found");
-                            else
-                                rootTagFound = true;
-                        }
+                            node.type = Node::Type::Tag;
+                            node.value = reader.getName().str();
+                            for (const auto& attribute : reader.getAttributes())
+                                node.attributes[attribute.getName().str()] = attribute.getValue();
+
+                            tags.push_back(&node);
+                            break;
+                        case Reader::Event::Text:
+                            node.type = Node::Type::Text;
+                            node.value = reader.getText();
+                            break;
+                        case Reader::Event::CData:
+                            node.type = Node::Type::CData;
+                            node.value = reader.getValue().str();
+                            break;
+                        case Reader::Event::Comment:
+                            node.type = Node::Type::Comment;
+                            node.value = reader.getValue().str();
+                            break;
+                        case Reader::Event::ProcessingInstruction:
+                            node.type = Node::Type::ProcessingInstruction;
+                            node.value = reader.getName().str();
+                            for (const auto& attribute : reader.getAttributes())
+                                node.attributes[attribute.getName().str()] = attribute.getValue();
+                            break;
+                        default:
+                            throw ParseError("Unexpected event");
                     }
                 }
 
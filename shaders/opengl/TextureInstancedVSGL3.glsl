@@ -0,0 +1,15 @@
+#version 330
+in vec3 position0;
+in vec4 color0;
+in vec2 texCoord0;
+in mat4 instanceTransform;
+in float instanceOpacity;
+uniform mat4 viewProj;
+out vec4 exColor;
+out vec2 exTexCoord;
+void main()
+{
+    gl_Position = viewProj * instanceTransform * vec4(position0, 1.0);
+    exColor = vec4(color0.rgb, color0.a * instanceOpacity);
+    exTexCoord = texCoord0;
+}
@@ -0,0 +1,591 @@
+// Copyright 2015-2020 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETCOOKER_HPP
+#define OUZEL_ASSETCOOKER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "assets/AtlasPacker.hpp"
+#include "assets/TextureLoader.hpp"
+#include "graphics/PixelFormat.hpp"
+#include "storage/FileSystem.hpp"
+#include "storage/Path.hpp"
+#include "utils/Json.hpp"
+#include "stb_image.h"
+#include "stb_image_resize.h"
+#include "stb_image_write.h"
+
+namespace ouzel
+{
+    // Converts the project's textures and atlases to their runtime formats and copies the other assets as they are,
+    // an asset is cooked again only if the hash of its contents, its options or its dependencies differs from
+    // the one in the manifest or if any of the files it produced is missing
+    class AssetCooker final
+    {
+    public:
+        static constexpr std::uint32_t VERSION = 1; // change to cook all the assets again
+
+        enum class Type
+        {
+            Copy, // copied unchanged, e.g. sounds, fonts and meshes, which the engine loads from their source formats
+            Texture, // images are converted to .otexture
+            Atlas // images are packed into atlas pages, every page is written as a .png and a sprite .json
+        };
+
+        struct Asset final
+        {
+            storage::Path path; // relative to the assets path
+            Type type = Type::Copy;
+            graphics::PixelFormat pixelFormat = graphics::PixelFormat::RGBA8UNorm;
+            bool mipmaps = true;
+            bool premultipliedAlpha = false;
+            std::vector<storage::Path> dependencies; // other files (relative to the assets path) the result depends on
+            std::vector<storage::Path> images; // images of an atlas (relative to the assets path)
+            std::uint32_t pageSize = 2048;
+            std::uint32_t padding = 2;
+            bool allowRotation = true;
+        };
+
+        AssetCooker(const storage::Path& initAssetsPath,
+                    const storage::Path& initOutputPath):
+            assetsPath(initAssetsPath),
+            outputPath(initOutputPath),
+            manifestPath(initOutputPath / storage::Path("assets.manifest"))
+        {
+        }
+
+        static Type getType(const storage::Path& path)
+        {
+            std::string extension = path.getExtension();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                           [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+            if (extension == "png" || extension == "jpg" || extension == "jpeg" ||
+                extension == "tga" || extension == "bmp")
+                return Type::Texture;
+
+            return Type::Copy;
+        }
+
+        static storage::Path getOutputPath(const Asset& asset)
+        {
+            switch (asset.type)
+            {
+                case Type::Copy:
+                    return asset.path;
+                case Type::Texture:
+                    return asset.path.getDirectory() / (asset.path.getStem() + std::string(".otexture"));
+                case Type::Atlas:
+                    return getAtlasPagePath(asset, 0, "json");
+            }
+
+            throw std::runtime_error("Invalid asset type");
+        }
+
+        // returns the number of assets that were cooked, the rest were up to date
+        std::size_t cook(const std::vector<Asset>& assets,
+                         std::size_t threadCount = std::thread::hardware_concurrency())
+        {
+            json::Data manifestData;
+            if (manifestPath.isRegular())
+                manifestData = json::Data(readFile(manifestPath));
+            const json::Value& manifest = manifestData;
+
+            struct Result final
+            {
+                std::string hash;
+                std::vector<storage::Path> outputs; // every file written for the asset
+                bool cooked = false;
+                std::string error;
+            };
+
+            std::vector<Result> results(assets.size());
+            std::atomic<std::size_t> nextAsset{0};
+            std::mutex outputMutex;
+
+            const auto cookAssets = [&]() {
+                for (std::size_t i = nextAsset++; i < assets.size(); i = nextAsset++)
+                {
+                    const Asset& asset = assets[i];
+                    Result& result = results[i];
+
+                    try
+                    {
+                        const std::string name = asset.path;
+                        const storage::Path assetOutputPath = outputPath / getOutputPath(asset);
+
+                        result.hash = getHash(asset);
+
+                        if (manifest.getType() == json::Value::Type::Object &&
+                            manifest.hasMember(name) &&
+                            manifest[name]["hash"].as<std::string>() == result.hash &&
+                            getManifestOutputs(manifest[name], result.outputs))
+                            continue;
+
+                        {
+                            std::unique_lock<std::mutex> lock(outputMutex);
+                            std::cout << "Cooking " << name << '\n';
+                            createDirectories(assetOutputPath.getDirectory());
+                        }
+
+                        result.outputs.clear();
+
+                        switch (asset.type)
+                        {
+                            case Type::Copy:
+                                storage::FileSystem::copyFile(assetsPath / asset.path, assetOutputPath, true);
+                                result.outputs.push_back(getOutputPath(asset));
+                                break;
+                            case Type::Texture:
+                                cookTexture(asset, assetOutputPath);
+                                result.outputs.push_back(getOutputPath(asset));
+                                break;
+                            case Type::Atlas:
+                            {
+                                const std::vector<assets::AtlasPacker::PageStatistics> statistics = cookAtlas(asset);
+
+                                for (std::uint32_t page = 0; page < statistics.size(); ++page)
+                                {
+                                    result.outputs.push_back(getAtlasPagePath(asset, page, "png"));
+                                    result.outputs.push_back(getAtlasPagePath(asset, page, "json"));
+                                }
+
+                                std::unique_lock<std::mutex> lock(outputMutex);
+                                for (std::size_t page = 0; page < statistics.size(); ++page)
+                                    std::cout << name << " page " << page << ": " << statistics[page].regionCount << " images, "
+                                        << static_cast<int>(statistics[page].getOccupancy(Size2U(asset.pageSize, asset.pageSize)) * 100.0F)
+                                        << "% occupied\n";
+                                break;
+                            }
+                        }
+
+                        result.cooked = true;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        result.error = e.what();
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (std::size_t i = 1; i < threadCount && i < assets.size(); ++i)
+                threads.emplace_back(cookAssets);
+
+            cookAssets();
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            json::Data newManifest;
+            static_cast<json::Value&>(newManifest) = json::Value::Object();
+
+            std::size_t cookedCount = 0;
+            std::string errors;
+
+            for (std::size_t i = 0; i < assets.size(); ++i)
+            {
+                const std::string name = assets[i].path;
+
+                if (!results[i].error.empty())
+                {
+                    errors += "Failed to cook " + name + ": " + results[i].error + '\n';
+                    continue;
+                }
+
+                if (results[i].cooked) ++cookedCount;
+
+                json::Value::Array outputs;
+                for (const storage::Path& output : results[i].outputs)
+                    outputs.push_back(std::string(output));
+
+                json::Value entry;
+                entry["hash"] = results[i].hash;
+                entry["output"] = std::string(getOutputPath(assets[i]));
+                entry["outputs"] = outputs;
+                newManifest[name] = entry;
+            }
+
+            // the failed assets are left out of the manifest, so that they are cooked again next time
+            const std::vector<std::uint8_t> newManifestData = newManifest.encode();
+
+            createDirectories(outputPath);
+            std::ofstream manifestFile(manifestPath, std::ios::binary | std::ios::trunc);
+            manifestFile.write(reinterpret_cast<const char*>(newManifestData.data()),
+                               static_cast<std::streamsize>(newManifestData.size()));
+
+            if (!errors.empty())
+                throw std::runtime_error(errors);
+
+            return cookedCount;
+        }
+
+    private:
+        static std::vector<std::uint8_t> readFile(const storage::Path& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("Failed to open file " + std::string(path));
+
+            return std::vector<std::uint8_t>{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        }
+
+        // returns false if the entry doesn't list its outputs or any of them is missing, e.g. a page of an atlas
+        bool getManifestOutputs(const json::Value& entry, std::vector<storage::Path>& outputs) const
+        {
+            if (!entry.hasMember("outputs")) return false;
+
+            const json::Value& outputsValue = entry["outputs"];
+            if (outputsValue.getType() != json::Value::Type::Array) return false;
+
+            outputs.clear();
+            for (const json::Value& output : outputsValue.as<json::Value::Array>())
+            {
+                const storage::Path outputFile = output.as<std::string>();
+                if (!(outputPath / outputFile).isRegular()) return false;
+                outputs.push_back(outputFile);
+            }
+
+            return !outputs.empty();
+        }
+
+        static void createDirectories(const storage::Path& path)
+        {
+            if (std::string(path).empty() || path.isDirectory()) return;
+
+            createDirectories(path.getDirectory());
+            storage::FileSystem::createDirectory(path);
+        }
+
+        // 64-bit FNV-1a
+        static void hash(std::uint64_t& result, const void* data, std::size_t size) noexcept
+        {
+            const auto bytes = static_cast<const std::uint8_t*>(data);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                result ^= bytes[i];
+                result *= 1099511628211ULL;
+            }
+        }
+
+        std::string getHash(const Asset& asset) const
+        {
+            std::uint64_t result = 14695981039346656037ULL;
+
+            const std::uint32_t options[] = {
+                VERSION,
+                static_cast<std::uint32_t>(asset.type),
+                static_cast<std::uint32_t>(asset.pixelFormat),
+                asset.mipmaps ? 1U : 0U,
+                asset.premultipliedAlpha ? 1U : 0U,
+                asset.pageSize,
+                asset.padding,
+                asset.allowRotation ? 1U : 0U
+            };
+            hash(result, options, sizeof(options));
+
+            // an atlas has no source file of its own, it is built from its images
+            if (asset.type != Type::Atlas)
+            {
+                const std::vector<std::uint8_t> data = readFile(assetsPath / asset.path);
+                hash(result, data.data(), data.size());
+            }
+
+            for (const storage::Path& image : asset.images)
+            {
+                const std::string name = image;
+                hash(result, name.data(), name.size());
+
+                const std::vector<std::uint8_t> imageData = readFile(assetsPath / image);
+                hash(result, imageData.data(), imageData.size());
+            }
+
+            for (const storage::Path& dependency : asset.dependencies)
+            {
+                const std::string name = dependency;
+                hash(result, name.data(), name.size());
+
+                const std::vector<std::uint8_t> dependencyData = readFile(assetsPath / dependency);
+                hash(result, dependencyData.data(), dependencyData.size());
+            }
+
+            constexpr char digits[] = "0123456789abcdef";
+            std::string str;
+            for (std::size_t i = 0; i < 16; ++i)
+                str.push_back(digits[(result >> ((15 - i) * 4)) & 0x0F]);
+
+            return str;
+        }
+
+        void cookTexture(const Asset& asset, const storage::Path& assetOutputPath) const
+        {
+            const std::vector<std::uint8_t> data = readFile(assetsPath / asset.path);
+
+            int width;
+            int height;
+            int comp;
+
+            std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels(stbi_load_from_memory(data.data(),
+                                                                                              static_cast<int>(data.size()),
+                                                                                              &width, &height, &comp,
+                                                                                              STBI_rgb_alpha),
+                                                                        &stbi_image_free);
+
+            if (!pixels)
+                throw std::runtime_error("Failed to load image, reason: " + std::string(stbi_failure_reason()));
+
+            std::size_t channels;
+            std::size_t firstChannel = 0;
+            int alphaChannel = STBIR_ALPHA_CHANNEL_NONE;
+            stbir_colorspace colorspace = STBIR_COLORSPACE_SRGB;
+
+            switch (asset.pixelFormat)
+            {
+                case graphics::PixelFormat::RGBA8UNorm:
+                case graphics::PixelFormat::RGBA8UNormSRGB:
+                    channels = 4;
+                    alphaChannel = 3;
+                    break;
+                case graphics::PixelFormat::RG8UNorm:
+                    channels = 2;
+                    break;
+                case graphics::PixelFormat::R8UNorm:
+                    channels = 1;
+                    break;
+                case graphics::PixelFormat::A8UNorm:
+                    channels = 1;
+                    firstChannel = 3;
+                    colorspace = STBIR_COLORSPACE_LINEAR;
+                    break;
+                default:
+                    throw std::runtime_error("Unsupported pixel format");
+            }
+
+            const auto pixelCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+            if (asset.premultipliedAlpha)
+                for (std::size_t i = 0; i < pixelCount; ++i)
+                {
+                    stbi_uc* pixel = pixels.get() + i * 4;
+                    for (std::size_t c = 0; c < 3; ++c)
+                        pixel[c] = static_cast<stbi_uc>((pixel[c] * pixel[3] + 127) / 255);
+                }
+
+            struct Level final
+            {
+                std::uint32_t width;
+                std::uint32_t height;
+                std::vector<std::uint8_t> data;
+            };
+
+            std::vector<Level> levels(1);
+            levels[0].width = static_cast<std::uint32_t>(width);
+            levels[0].height = static_cast<std::uint32_t>(height);
+            levels[0].data.resize(pixelCount * channels);
+
+            for (std::size_t i = 0; i < pixelCount; ++i)
+                for (std::size_t c = 0; c < channels; ++c)
+                    levels[0].data[i * channels + c] = pixels.get()[i * 4 + firstChannel + c];
+
+            // every level is downsampled from the previous one with a box filter, like graphics::Texture does
+            while (asset.mipmaps && (levels.back().width > 1 || levels.back().height > 1))
+            {
+                const Level& previous = levels.back();
+
+                Level level;
+                level.width = std::max(previous.width >> 1, 1U);
+                level.height = std::max(previous.height >> 1, 1U);
+                level.data.resize(static_cast<std::size_t>(level.width) * level.height * channels);
+
+                if (!stbir_resize_uint8_generic(previous.data.data(),
+                                                static_cast<int>(previous.width), static_cast<int>(previous.height), 0,
+                                                level.data.data(),
+                                                static_cast<int>(level.width), static_cast<int>(level.height), 0,
+                                                static_cast<int>(channels), alphaChannel,
+                                                asset.premultipliedAlpha ? STBIR_FLAG_ALPHA_PREMULTIPLIED : 0,
+                                                STBIR_EDGE_CLAMP, STBIR_FILTER_BOX, colorspace, nullptr))
+                    throw std::runtime_error("Failed to generate mip level");
+
+                levels.push_back(std::move(level));
+            }
+
+            // the layout is described in assets/TextureLoader.hpp
+            constexpr std::size_t HEADER_SIZE = assets::TextureLoader::HEADER_SIZE;
+            constexpr std::size_t LEVEL_HEADER_SIZE = assets::TextureLoader::LEVEL_HEADER_SIZE;
+            constexpr std::size_t ALIGNMENT = assets::TextureLoader::ALIGNMENT;
+
+            std::vector<std::uint8_t> result;
+            const auto write = [&result](std::uint64_t value, std::size_t size) {
+                for (std::size_t i = 0; i < size; ++i)
+                    result.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+            };
+
+            result.insert(result.end(), {'O', 'T', 'E', 'X'});
+            write(assets::TextureLoader::VERSION, 4);
+            write(static_cast<std::uint32_t>(asset.pixelFormat), 4);
+            write(levels[0].width, 4);
+            write(levels[0].height, 4);
+            write(levels.size(), 4);
+            write(asset.premultipliedAlpha ? assets::TextureLoader::PremultipliedAlpha : 0, 4); // flags
+            write(0, 4); // reserved
+
+            std::size_t offset = HEADER_SIZE + LEVEL_HEADER_SIZE * levels.size();
+            for (const Level& level : levels)
+            {
+                offset = (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+                write(level.width, 4);
+                write(level.height, 4);
+                write(offset, 8);
+                write(level.data.size(), 8);
+                offset += level.data.size();
+            }
+
+            for (const Level& level : levels)
+            {
+                result.resize((result.size() + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+                result.insert(result.end(), level.data.begin(), level.data.end());
+            }
+
+            std::ofstream file(assetOutputPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                throw std::runtime_error("Failed to open file " + std::string(assetOutputPath));
+
+            file.write(reinterpret_cast<const char*>(result.data()), static_cast<std::streamsize>(result.size()));
+        }
+
+        // the pages of an atlas "sprites" are written as sprites_0.png, sprites_0.json, sprites_1.png and so on
+        static storage::Path getAtlasPagePath(const Asset& asset, std::uint32_t page, const std::string& extension)
+        {
+            return asset.path.getDirectory() / (std::string(asset.path.getStem()) + '_' + std::to_string(page) + '.' + extension);
+        }
+
+        std::vector<assets::AtlasPacker::PageStatistics> cookAtlas(const Asset& asset) const
+        {
+            struct Image final
+            {
+                std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels{nullptr, &stbi_image_free};
+                Size2U size;
+            };
+
+            std::vector<Image> images(asset.images.size());
+            std::vector<Size2U> sizes;
+
+            for (std::size_t i = 0; i < asset.images.size(); ++i)
+            {
+                const std::vector<std::uint8_t> data = readFile(assetsPath / asset.images[i]);
+
+                int width;
+                int height;
+                int comp;
+                images[i].pixels.reset(stbi_load_from_memory(data.data(), static_cast<int>(data.size()),
+                                                             &width, &height, &comp, STBI_rgb_alpha));
+
+                if (!images[i].pixels)
+                    throw std::runtime_error("Failed to load image " + std::string(asset.images[i]) +
+                                             ", reason: " + std::string(stbi_failure_reason()));
+
+                images[i].size = Size2U(static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height));
+                sizes.push_back(images[i].size);
+            }
+
+            const Size2U pageSize(asset.pageSize, asset.pageSize);
+            assets::AtlasPacker packer(pageSize, asset.padding, asset.allowRotation);
+            const std::vector<assets::AtlasPacker::Region> regions = packer.insert(sizes);
+
+            constexpr std::size_t pixelSize = 4;
+            std::vector<std::vector<std::uint8_t>> pages(packer.getPageCount(),
+                                                         std::vector<std::uint8_t>(static_cast<std::size_t>(asset.pageSize) * asset.pageSize * pixelSize));
+            std::vector<json::Value::Array> frames(packer.getPageCount());
+
+            for (std::size_t i = 0; i < images.size(); ++i)
+            {
+                const assets::AtlasPacker::Region& region = regions[i];
+                const Size2U& size = images[i].size;
+                const stbi_uc* source = images[i].pixels.get();
+                std::uint8_t* page = pages[region.page].data();
+
+                for (std::uint32_t y = 0; y < size.v[1]; ++y)
+                    if (!region.rotated)
+                        std::copy(source + y * size.v[0] * pixelSize,
+                                  source + (y + 1) * size.v[0] * pixelSize,
+                                  page + ((region.y + y) * asset.pageSize + region.x) * pixelSize);
+                    else // rotated by 90 degrees clockwise, like Bundle::preloadSpriteAtlas does
+                        for (std::uint32_t x = 0; x < size.v[0]; ++x)
+                            std::copy(source + (y * size.v[0] + x) * pixelSize,
+                                      source + (y * size.v[0] + x + 1) * pixelSize,
+                                      page + ((region.y + x) * asset.pageSize + region.x + size.v[1] - 1 - y) * pixelSize);
+
+                // TexturePacker's JSON array format, the frame has the size of the image before the rotation
+                json::Value frame = json::Value::Object();
+                frame["filename"] = std::string(asset.images[i]);
+                frame["frame"]["x"] = region.x;
+                frame["frame"]["y"] = region.y;
+                frame["frame"]["w"] = size.v[0];
+                frame["frame"]["h"] = size.v[1];
+                frame["rotated"] = region.rotated;
+                frame["trimmed"] = false;
+                frame["spriteSourceSize"]["x"] = 0;
+                frame["spriteSourceSize"]["y"] = 0;
+                frame["spriteSourceSize"]["w"] = size.v[0];
+                frame["spriteSourceSize"]["h"] = size.v[1];
+                frame["sourceSize"]["w"] = size.v[0];
+                frame["sourceSize"]["h"] = size.v[1];
+                frame["pivot"]["x"] = 0.5F;
+                frame["pivot"]["y"] = 0.5F;
+                frames[region.page].push_back(frame);
+            }
+
+            std::vector<assets::AtlasPacker::PageStatistics> statistics;
+
+            for (std::uint32_t page = 0; page < packer.getPageCount(); ++page)
+            {
+                const storage::Path imagePath = getAtlasPagePath(asset, page, "png");
+
+                if (!stbi_write_png(std::string(outputPath / imagePath).c_str(),
+                                    static_cast<int>(asset.pageSize), static_cast<int>(asset.pageSize),
+                                    static_cast<int>(pixelSize), pages[page].data(),
+                                    static_cast<int>(asset.pageSize * pixelSize)))
+                    throw std::runtime_error("Failed to write atlas page " + std::string(imagePath));
+
+                json::Data data;
+                static_cast<json::Value&>(data) = json::Value::Object();
+                data["frames"] = frames[page];
+                data["meta"]["image"] = imagePath.getFilename();
+                data["meta"]["size"]["w"] = asset.pageSize;
+                data["meta"]["size"]["h"] = asset.pageSize;
+                data["meta"]["atlas"] = true;
+
+                const std::vector<std::uint8_t> result = data.encode();
+
+                const storage::Path jsonPath = outputPath / getAtlasPagePath(asset, page, "json");
+                std::ofstream file(jsonPath, std::ios::binary | std::ios::trunc);
+                if (!file)
+                    throw std::runtime_error("Failed to open file " + std::string(jsonPath));
+
+                file.write(reinterpret_cast<const char*>(result.data()), static_cast<std::streamsize>(result.size()));
+
+                statistics.push_back(packer.getPageStatistics(page));
+            }
+
+            return statistics;
+        }
+
+        storage::Path assetsPath;
+        storage::Path outputPath;
+        storage::Path manifestPath;
+    };
+}
+
+#endif // OUZEL_ASSETCOOKER_HPP
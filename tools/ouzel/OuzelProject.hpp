@@ -4,8 +4,10 @@
 #define OUZEL_OUZELPROJECT_HPP
 
 #include <fstream>
+#include <iostream>
 #include "storage/FileSystem.hpp"
 #include "utils/Json.hpp"
+#include "AssetCooker.hpp"
 #include "Platform.hpp"
 
 namespace ouzel
@@ -52,6 +54,75 @@ namespace ouzel
                 sourceFiles.push_back(sourceFile.as<std::string>());
 
             assetsPath = j["assetsPath"].as<std::string>();
+
+            if (j.hasMember("assets"))
+                for (const auto& assetValue : j["assets"])
+                {
+                    AssetCooker::Asset asset;
+
+                    if (assetValue.getType() == json::Value::Type::String)
+                    {
+                        asset.path = assetValue.as<std::string>();
+                        asset.type = AssetCooker::getType(asset.path);
+                    }
+                    else
+                    {
+                        asset.path = assetValue["path"].as<std::string>();
+
+                        if (!assetValue.hasMember("type"))
+                            asset.type = AssetCooker::getType(asset.path);
+                        else if (assetValue["type"].as<std::string>() == "texture")
+                            asset.type = AssetCooker::Type::Texture;
+                        else if (assetValue["type"].as<std::string>() == "copy")
+                            asset.type = AssetCooker::Type::Copy;
+                        else if (assetValue["type"].as<std::string>() == "atlas")
+                            asset.type = AssetCooker::Type::Atlas;
+                        else
+                            throw std::runtime_error("Invalid asset type");
+
+                        if (assetValue.hasMember("pixelFormat"))
+                        {
+                            const auto& pixelFormat = assetValue["pixelFormat"].as<std::string>();
+                            if (pixelFormat == "RGBA8UNorm")
+                                asset.pixelFormat = graphics::PixelFormat::RGBA8UNorm;
+                            else if (pixelFormat == "RGBA8UNormSRGB")
+                                asset.pixelFormat = graphics::PixelFormat::RGBA8UNormSRGB;
+                            else if (pixelFormat == "RG8UNorm")
+                                asset.pixelFormat = graphics::PixelFormat::RG8UNorm;
+                            else if (pixelFormat == "R8UNorm")
+                                asset.pixelFormat = graphics::PixelFormat::R8UNorm;
+                            else if (pixelFormat == "A8UNorm")
+                                asset.pixelFormat = graphics::PixelFormat::A8UNorm;
+                            else
+                                throw std::runtime_error("Invalid pixel format");
+                        }
+
+                        if (assetValue.hasMember("mipmaps"))
+                            asset.mipmaps = assetValue["mipmaps"].as<bool>();
+
+                        if (assetValue.hasMember("premultipliedAlpha"))
+                            asset.premultipliedAlpha = assetValue["premultipliedAlpha"].as<bool>();
+
+                        if (assetValue.hasMember("dependencies"))
+                            for (const auto& dependency : assetValue["dependencies"])
+                                asset.dependencies.push_back(dependency.as<std::string>());
+
+                        if (assetValue.hasMember("images"))
+                            for (const auto& image : assetValue["images"])
+                                asset.images.push_back(image.as<std::string>());
+
+                        if (assetValue.hasMember("pageSize"))
+                            asset.pageSize = assetValue["pageSize"].as<std::uint32_t>();
+
+                        if (assetValue.hasMember("padding"))
+                            asset.padding = assetValue["padding"].as<std::uint32_t>();
+
+                        if (assetValue.hasMember("allowRotation"))
+                            asset.allowRotation = assetValue["allowRotation"].as<bool>();
+                    }
+
+                    assets.push_back(asset);
+                }
         }
 
         const storage::Path& getPath() const noexcept { return path; }
@@ -64,21 +135,19 @@ namespace ouzel
         const std::vector<storage::Path>& getSourceFiles() const noexcept { return sourceFiles; }
         const storage::Path& getAssetsPath() const noexcept { return assetsPath; }
 
+        const std::vector<AssetCooker::Asset>& getAssets() const noexcept { return assets; }
+
         void exportAssets()
         {
-            /*storage::Path resourcesPath = directoryPath / storage::Path("Resources");
-
-            for (const auto& asset : j["assets"])
-            {
-                storage::Path assetPath(assetsPath / asset["path"].as<std::string>());
+            const storage::Path directoryPath = path.getDirectory();
+            const storage::Path resourcesPath = directoryPath / storage::Path("Resources");
 
-                storage::Path resourceName = asset["path"].as<std::string>();
-                storage::Path resourcePath = resourcesPath / resourceName.getStem() + std::string(".otexture");
+            AssetCooker cooker(assetsPath.isAbsolute() ? assetsPath : directoryPath / assetsPath,
+                               resourcesPath);
+            const std::size_t cookedCount = cooker.cook(assets);
 
-                // TODO: check if input file exists
-                // TODO: check if output file exists and is older than the input file
-                // TODO: export input file to output file
-            }*/
+            std::cout << cookedCount << " of " << assets.size() << " assets cooked, "
+                << assets.size() - cookedCount << " up to date\n";
         }
 
     private:
@@ -91,6 +160,7 @@ namespace ouzel
         storage::Path sourcePath;
         std::vector<storage::Path> sourceFiles;
         storage::Path assetsPath;
+        std::vector<AssetCooker::Asset> assets;
     };
 }
 